@@ -20,6 +20,9 @@
 
 #include "imagereference.h"
 
+#include <QBuffer>
+#include <QImageReader>
+
 namespace Tiled {
 
 bool ImageReference::hasImage() const
@@ -37,4 +40,23 @@ QImage Tiled::ImageReference::create() const
     return QImage();
 }
 
+/**
+ * Returns the size of the referenced image, read from its header without
+ * decoding the image. Returns an invalid size when it can't be determined.
+ */
+QSize Tiled::ImageReference::readSize() const
+{
+    if (!source.isEmpty())
+        return QImageReader(source).size();
+
+    if (!data.isEmpty()) {
+        QBuffer buffer;
+        buffer.setData(data);
+        buffer.open(QIODevice::ReadOnly);
+        return QImageReader(&buffer, format).size();
+    }
+
+    return QSize();
+}
+
 } // namespace Tiled
@@ -41,6 +41,7 @@ public:
 
     bool hasImage() const;
     QImage create() const;
+    QSize readSize() const;
 };
 
 } // namespace Tiled
@@ -34,6 +34,8 @@
 #include "tilelayer.h"
 #include "tileset.h"
 
+#include <QPainterPath>
+
 #include <cmath>
 
 using namespace Tiled;
@@ -116,7 +118,8 @@ QPainterPath IsometricRenderer::shape(const MapObject *object) const
         case MapObject::Polygon:
         case MapObject::Polyline: {
             const QPointF &pos = object->position();
-            const QPolygonF polygon = object->polygon().translated(pos);
+            // Hit-testing at map resolution is accurate enough
+            const QPolygonF polygon = object->simplifiedPolygon(1).translated(pos);
             const QPolygonF screenPolygon = pixelToScreenCoords(polygon);
             if (object->shape() == MapObject::Polygon) {
                 path.addPolygon(screenPolygon);
@@ -286,26 +289,18 @@ void IsometricRenderer::drawMapObject(QPainter *painter,
     const Cell &cell = object->cell();
 
     if (!cell.isEmpty()) {
-        const Tile *tile = cell.tile;
-        const QSize imgSize = tile->size();
         const QPointF pos = pixelToScreenCoords(object->position());
-        const QPointF tileOffset = tile->offset();
 
         CellRenderer(painter).render(cell, pos, object->size(),
                                      CellRenderer::BottomCenter);
 
         if (testFlag(ShowTileObjectOutlines)) {
-            QRectF rect(QPointF(pos.x() - imgSize.width() / 2 + tileOffset.x(),
-                                pos.y() - imgSize.height() + tileOffset.y()),
-                        imgSize);
-
-            pen.setStyle(Qt::SolidLine);
-            painter->setPen(pen);
-            painter->drawRect(rect);
-            pen.setStyle(Qt::DotLine);
-            pen.setColor(color);
-            painter->setPen(pen);
-            painter->drawRect(rect);
+            const QRectF outline = tileObjectOutline(object);
+            if (!outline.isNull()) {
+                QPainterPath path;
+                path.addRect(outline);
+                drawTileObjectOutlines(painter, path, color);
+            }
         }
     } else {
         const qreal lineWidth = objectLineWidth();
@@ -391,7 +386,7 @@ void IsometricRenderer::drawMapObject(QPainter *painter,
         }
         case MapObject::Polygon: {
             const QPointF &pos = object->position();
-            const QPolygonF polygon = object->polygon().translated(pos);
+            const QPolygonF polygon = object->simplifiedPolygon(painterScale()).translated(pos);
             QPolygonF screenPolygon = pixelToScreenCoords(polygon);
 
             QPen thickPen(pen);
@@ -415,7 +410,7 @@ void IsometricRenderer::drawMapObject(QPainter *painter,
         }
         case MapObject::Polyline: {
             const QPointF &pos = object->position();
-            const QPolygonF polygon = object->polygon().translated(pos);
+            const QPolygonF polygon = object->simplifiedPolygon(painterScale()).translated(pos);
             QPolygonF screenPolygon = pixelToScreenCoords(polygon);
 
             QPen thickPen(pen);
@@ -442,6 +437,21 @@ void IsometricRenderer::drawMapObject(QPainter *painter,
     painter->restore();
 }
 
+QRectF IsometricRenderer::tileObjectOutline(const MapObject *object) const
+{
+    const Tile *tile = object->cell().tile;
+    if (!tile || !isOutlineVisible(object->size()))
+        return QRectF();
+
+    const QSize imgSize = tile->size();
+    const QPointF pos = pixelToScreenCoords(object->position());
+    const QPointF tileOffset = tile->offset();
+
+    return QRectF(QPointF(pos.x() - imgSize.width() / 2 + tileOffset.x(),
+                          pos.y() - imgSize.height() + tileOffset.y()),
+                  imgSize);
+}
+
 QPointF IsometricRenderer::pixelToTileCoords(qreal x, qreal y) const
 {
     const int tileHeight = map()->tileHeight();
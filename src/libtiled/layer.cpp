@@ -67,7 +67,7 @@ Layer *Layer::initializeClone(Layer *clone) const
     clone->mOffset = mOffset;
     clone->mOpacity = mOpacity;
     clone->mVisible = mVisible;
-    clone->setProperties(properties());
+    clone->setProperties(*this);
     return clone;
 }
 
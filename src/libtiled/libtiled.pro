@@ -32,20 +32,25 @@ SOURCES += compression.cpp \
     isometricrenderer.cpp \
     layer.cpp \
     map.cpp \
+    mapformat.cpp \
     mapobject.cpp \
     mapreader.cpp \
     maprenderer.cpp \
     maptovariantconverter.cpp \
     mapwriter.cpp \
+    numberformat.cpp \
     objectgroup.cpp \
     orthogonalrenderer.cpp \
     plugin.cpp \
     pluginmanager.cpp \
     properties.cpp \
+    regionbuilder.cpp \
+    spatialindex.cpp \
     staggeredrenderer.cpp \
     tile.cpp \
     tilelayer.cpp \
     tileset.cpp \
+    tilesetcache.cpp \
     tilesetformat.cpp \
     varianttomapconverter.cpp
 HEADERS += compression.h \
@@ -63,12 +68,15 @@ HEADERS += compression.h \
     maprenderer.h \
     maptovariantconverter.h \
     mapwriter.h \
+    numberformat.h \
     object.h \
     objectgroup.h \
     orthogonalrenderer.h \
     plugin.h \
     pluginmanager.h \
     properties.h \
+    regionbuilder.h \
+    spatialindex.h \
     staggeredrenderer.h \
     terrain.h \
     tile.h \
@@ -76,6 +84,7 @@ HEADERS += compression.h \
     tiled_global.h \
     tilelayer.h \
     tileset.h \
+    tilesetcache.h \
     tilesetformat.h \
     varianttomapconverter.h
 
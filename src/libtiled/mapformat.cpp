@@ -0,0 +1,118 @@
+/*
+ * mapformat.cpp
+ * Copyright 2026, agent <agent@local>
+ *
+ * This file is part of libtiled.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE CONTRIBUTORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mapformat.h"
+
+#include <climits>
+
+namespace Tiled {
+
+MappedFile::MappedFile(const QString &fileName)
+    : mFile(fileName)
+    , mData(nullptr)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    // The buffer refers to the mapped memory, so close it first
+    mBuffer.close();
+    mBuffer.setData(QByteArray());
+
+    if (mData)
+        mFile.unmap(mData);
+}
+
+bool MappedFile::open()
+{
+    if (!mFile.open(QIODevice::ReadOnly))
+        return false;
+
+    const qint64 size = mFile.size();
+    if (size > 0 && size <= INT_MAX)
+        mData = mFile.map(0, size);
+
+    if (mData) {
+        mBuffer.setData(QByteArray::fromRawData(reinterpret_cast<const char*>(mData),
+                                                static_cast<int>(size)));
+        mBuffer.open(QIODevice::ReadOnly);
+    }
+
+    return true;
+}
+
+QIODevice *MappedFile::device()
+{
+    if (mData)
+        return &mBuffer;
+    return &mFile;
+}
+
+
+bool fileHasContents(const QString &fileName, const QByteArray &contents)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+    return file.readAll() == contents;
+}
+
+
+/**
+ * Reads a map from \a data, which is not copied. Only supported by formats
+ * with the ReadFromDevice capability.
+ *
+ * @see readFromDevice
+ */
+Map *MapFormat::fromByteArray(const QByteArray &data, const QString &fileName)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+
+    return readFromDevice(&buffer, fileName);
+}
+
+/**
+ * Writes \a map to a byte array. Returns an empty byte array when writing
+ * failed. Only supported by formats with the WriteToDevice capability.
+ *
+ * @see writeToDevice
+ */
+QByteArray MapFormat::toByteArray(const Map *map, const QString &fileName)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    if (!writeToDevice(map, &buffer, fileName))
+        return QByteArray();
+
+    return buffer.data();
+}
+
+} // namespace Tiled
@@ -31,6 +31,8 @@
 
 #include "pluginmanager.h"
 
+#include <QBuffer>
+#include <QFile>
 #include <QObject>
 #include <QStringList>
 #include <QMap>
@@ -39,6 +41,42 @@ namespace Tiled {
 
 class Map;
 
+/**
+ * Opens a file for reading and maps it into memory when possible, so that it
+ * can be parsed without first being copied into a read buffer. When mapping
+ * is not possible, the file is read from directly.
+ */
+class TILEDSHARED_EXPORT MappedFile
+{
+public:
+    explicit MappedFile(const QString &fileName);
+    ~MappedFile();
+
+    bool open();
+
+    /**
+     * Returns the device to read from. Only valid after a successful open().
+     */
+    QIODevice *device();
+
+    QString errorString() const { return mFile.errorString(); }
+
+private:
+    Q_DISABLE_COPY(MappedFile)
+
+    QFile mFile;
+    QBuffer mBuffer;
+    uchar *mData;
+};
+
+/**
+ * Returns whether the file at \a fileName exists and already contains
+ * exactly \a contents. Used to avoid rewriting files that would not change.
+ */
+TILEDSHARED_EXPORT bool fileHasContents(const QString &fileName,
+                                        const QByteArray &contents);
+
+
 class TILEDSHARED_EXPORT FileFormat : public QObject
 {
     Q_OBJECT
@@ -48,7 +86,10 @@ public:
         NoCapability    = 0x0,
         Read            = 0x1,
         Write           = 0x2,
-        ReadWrite       = Read | Write
+        ReadWrite       = Read | Write,
+        ReadFromDevice  = 0x4,
+        WriteToDevice   = 0x8,
+        Threaded        = 0x10
     };
     Q_DECLARE_FLAGS(Capabilities, Capability)
 
@@ -91,6 +132,30 @@ public:
      * trying to read a map.
      */
     virtual QString errorString() const = 0;
+
+    /**
+     * Requests a running read or write to be aborted as soon as possible.
+     *
+     * Only called from another thread on formats with the Threaded
+     * capability, which may then be used from a worker thread.
+     */
+    virtual void cancel() {}
+
+    /**
+     * Called on formats with the Threaded capability, from the thread that
+     * is about to run a read or write in a worker thread, right before it
+     * does so. A cancel() that follows applies to that read or write, even
+     * when it did not start yet.
+     */
+    virtual void aboutToRunInThread() {}
+
+signals:
+    /**
+     * May be emitted by formats with the Threaded capability to report the
+     * progress of a running read or write. A \a maximum of 0 means the
+     * amount of work is unknown.
+     */
+    void progressChanged(int value, int maximum);
 };
 
 
@@ -122,6 +187,42 @@ public:
      *         occurred. The error can be retrieved by errorString().
      */
     virtual bool write(const Map *map, const QString &fileName) = 0;
+
+    /**
+     * Reads a map from the given \a device and returns a new Map instance, or
+     * 0 if reading failed. The \a fileName is used to resolve references to
+     * other files. When it is empty, references are expected to be absolute.
+     *
+     * Only supported by formats with the ReadFromDevice capability.
+     */
+    virtual Map *readFromDevice(QIODevice *device, const QString &fileName)
+    {
+        Q_UNUSED(device)
+        Q_UNUSED(fileName)
+        return nullptr;
+    }
+
+    /**
+     * Writes the given \a map to \a device. References to other files are
+     * written relative to the given \a fileName, or as absolute paths when
+     * it is empty.
+     *
+     * Only supported by formats with the WriteToDevice capability.
+     */
+    virtual bool writeToDevice(const Map *map, QIODevice *device,
+                               const QString &fileName)
+    {
+        Q_UNUSED(map)
+        Q_UNUSED(device)
+        Q_UNUSED(fileName)
+        return false;
+    }
+
+    Map *fromByteArray(const QByteArray &data,
+                       const QString &fileName = QString());
+
+    QByteArray toByteArray(const Map *map,
+                           const QString &fileName = QString());
 };
 
 } // namespace Tiled
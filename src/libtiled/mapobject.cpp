@@ -33,14 +33,84 @@
 #include "objectgroup.h"
 #include "tile.h"
 
+#include <QReadWriteLock>
+#include <QtMath>
+
+#include <cmath>
+
 using namespace Tiled;
 
+/**
+ * Polygons with fewer points than this are never simplified.
+ */
+static const int minimumSimplifiedPointCount = 128;
+
+/**
+ * Simplifies the given \a polygon using the Douglas-Peucker algorithm,
+ * dropping points that are closer than \a tolerance to the simplified line.
+ */
+static QPolygonF simplifyPolygon(const QPolygonF &polygon, qreal tolerance)
+{
+    const int count = polygon.size();
+    const qreal toleranceSquared = tolerance * tolerance;
+
+    QVector<bool> keep(count, false);
+    keep[0] = true;
+    keep[count - 1] = true;
+
+    QVector<QPair<int, int> > ranges;
+    ranges.append(qMakePair(0, count - 1));
+
+    while (!ranges.isEmpty()) {
+        const QPair<int, int> range = ranges.takeLast();
+        const QPointF &start = polygon.at(range.first);
+        const QPointF segment = polygon.at(range.second) - start;
+        const qreal lengthSquared = QPointF::dotProduct(segment, segment);
+
+        qreal maxDistanceSquared = 0;
+        int maxIndex = -1;
+
+        for (int i = range.first + 1; i < range.second; ++i) {
+            const QPointF offset = polygon.at(i) - start;
+
+            // Distance to the closest point on the segment, since points
+            // beyond its ends (like spikes doubling back) are not on it
+            QPointF closest;
+            if (lengthSquared > 0) {
+                const qreal t = QPointF::dotProduct(offset, segment) / lengthSquared;
+                closest = segment * qBound(qreal(0), t, qreal(1));
+            }
+
+            const QPointF delta = offset - closest;
+            const qreal distanceSquared = QPointF::dotProduct(delta, delta);
+
+            if (distanceSquared > maxDistanceSquared) {
+                maxDistanceSquared = distanceSquared;
+                maxIndex = i;
+            }
+        }
+
+        if (maxIndex != -1 && maxDistanceSquared > toleranceSquared) {
+            keep[maxIndex] = true;
+            ranges.append(qMakePair(range.first, maxIndex));
+            ranges.append(qMakePair(maxIndex, range.second));
+        }
+    }
+
+    QPolygonF simplified;
+    for (int i = 0; i < count; ++i)
+        if (keep.at(i))
+            simplified.append(polygon.at(i));
+    return simplified;
+}
+
 MapObject::MapObject():
     Object(MapObjectType),
     mId(0),
     mSize(0, 0),
     mShape(Rectangle),
     mObjectGroup(nullptr),
+    mIndex(-1),
     mRotation(0.0f),
     mVisible(true)
 {
@@ -57,6 +127,7 @@ MapObject::MapObject(const QString &name, const QString &type,
     mSize(size),
     mShape(Rectangle),
     mObjectGroup(nullptr),
+    mIndex(-1),
     mRotation(0.0f),
     mVisible(true)
 {
@@ -111,6 +182,7 @@ void MapObject::flip(FlipDirection direction)
 
     if (!mPolygon.isEmpty()) {
         const QPointF center2 = mPolygon.boundingRect().center() * 2;
+        mSimplifiedPolygons.clear();
 
         if (direction == FlipHorizontally) {
             for (int i = 0; i < mPolygon.size(); ++i)
@@ -120,13 +192,106 @@ void MapObject::flip(FlipDirection direction)
                 mPolygon[i].setY(center2.y() - mPolygon[i].y());
         }
     }
+
+    geometryChanged();
+}
+
+QPolygonF MapObject::simplifiedPolygon(qreal scale) const
+{
+    if (mPolygon.size() < minimumSimplifiedPointCount || scale <= 0)
+        return mPolygon;
+
+    const int level = qCeil(std::log2(scale));
+
+    auto it = mSimplifiedPolygons.find(level);
+    if (it == mSimplifiedPolygons.end()) {
+        const QPolygonF simplified = simplifyPolygon(mPolygon, std::ldexp(0.5, -level));
+        it = mSimplifiedPolygons.insert(level, simplified);
+    }
+
+    return it.value();
+}
+
+int MapObject::index() const
+{
+    return mObjectGroup ? mObjectGroup->indexOf(this) : -1;
+}
+
+/**
+ * Lets the object group know that the bounds of this object may have
+ * changed, so that it can update its spatial index.
+ */
+void MapObject::geometryChanged()
+{
+    if (mObjectGroup)
+        mObjectGroup->objectGeometryChanged(this);
+}
+
+namespace {
+
+/*
+ * The default properties of each object type, as set by the application
+ * through MapObject::setTypeDefaultProperties(). Guarded by a lock since
+ * exporters may resolve properties from other threads.
+ */
+struct TypeDefaultProperties
+{
+    QReadWriteLock lock;
+    QHash<QString, PropertyList> properties;
+};
+
+} // anonymous namespace
+
+Q_GLOBAL_STATIC(TypeDefaultProperties, typeDefaults)
+
+QVariant MapObject::resolvedProperty(const QString &name) const
+{
+    if (hasProperty(name))
+        return property(name);
+    if (mType.isEmpty())
+        return QVariant();
+
+    return typeDefaultProperties(mType).value(name);
+}
+
+Properties MapObject::resolvedProperties() const
+{
+    if (mType.isEmpty())
+        return properties();
+
+    Properties resolved = typeDefaultProperties(mType).toProperties();
+    resolved.merge(properties());
+    return resolved;
+}
+
+PropertyList MapObject::typeDefaultProperties(const QString &type)
+{
+    TypeDefaultProperties *storage = typeDefaults();
+    QReadLocker locker(&storage->lock);
+    return storage->properties.value(type);
+}
+
+void MapObject::setTypeDefaultProperties(const QHash<QString, Properties> &defaults)
+{
+    QHash<QString, PropertyList> properties;
+
+    QHashIterator<QString, Properties> it(defaults);
+    while (it.hasNext()) {
+        it.next();
+        if (!it.value().isEmpty())
+            properties.insert(it.key(), PropertyList(it.value()));
+    }
+
+    TypeDefaultProperties *storage = typeDefaults();
+    QWriteLocker locker(&storage->lock);
+    storage->properties.swap(properties);
 }
 
 MapObject *MapObject::clone() const
 {
     MapObject *o = new MapObject(mName, mType, mPos, mSize);
     o->setId(mId);
-    o->setProperties(properties());
+    o->setProperties(*this);
     o->setPolygon(mPolygon);
     o->setShape(mShape);
     o->setCell(mCell);
@@ -35,6 +35,7 @@
 #include "tiled.h"
 #include "tilelayer.h"
 
+#include <QHash>
 #include <QPolygonF>
 #include <QSizeF>
 #include <QString>
@@ -69,6 +70,23 @@ public:
         Ellipse
     };
 
+    /**
+     * Flags for the properties of an object, used to tell which ones have
+     * changed.
+     */
+    enum Property {
+        NameProperty        = 0x01,
+        TypeProperty        = 0x02,
+        PositionProperty    = 0x04,
+        SizeProperty        = 0x08,
+        ShapeProperty       = 0x10,     // the shape and the polygon
+        CellProperty        = 0x20,
+        RotationProperty    = 0x40,
+        VisibleProperty     = 0x80,
+        AllProperties       = 0xFF
+    };
+    Q_DECLARE_FLAGS(ChangedProperties, Property)
+
     MapObject();
 
     MapObject(const QString &name, const QString &type,
@@ -122,7 +140,7 @@ public:
     /**
      * Sets the position of this object.
      */
-    void setPosition(const QPointF &pos) { mPos = pos; }
+    void setPosition(const QPointF &pos) { mPos = pos; geometryChanged(); }
 
     /**
      * Returns the x position of this object.
@@ -132,7 +150,7 @@ public:
     /**
      * Sets the x position of this object.
      */
-    void setX(qreal x) { mPos.setX(x); }
+    void setX(qreal x) { mPos.setX(x); geometryChanged(); }
 
     /**
      * Returns the y position of this object.
@@ -142,7 +160,7 @@ public:
     /**
      * Sets the x position of this object.
      */
-    void setY(qreal y) { mPos.setY(y); }
+    void setY(qreal y) { mPos.setY(y); geometryChanged(); }
 
     /**
      * Returns the size of this object.
@@ -152,7 +170,7 @@ public:
     /**
      * Sets the size of this object.
      */
-    void setSize(const QSizeF &size) { mSize = size; }
+    void setSize(const QSizeF &size) { mSize = size; geometryChanged(); }
 
     void setSize(qreal width, qreal height)
     { setSize(QSizeF(width, height)); }
@@ -165,7 +183,7 @@ public:
     /**
      * Sets the width of this object.
      */
-    void setWidth(qreal width) { mSize.setWidth(width); }
+    void setWidth(qreal width) { mSize.setWidth(width); geometryChanged(); }
 
     /**
      * Returns the height of this object.
@@ -175,7 +193,7 @@ public:
     /**
      * Sets the height of this object.
      */
-    void setHeight(qreal height) { mSize.setHeight(height); }
+    void setHeight(qreal height) { mSize.setHeight(height); geometryChanged(); }
 
     /**
      * Sets the position and size of this object.
@@ -188,7 +206,7 @@ public:
      *
      * \sa setShape()
      */
-    void setPolygon(const QPolygonF &polygon) { mPolygon = polygon; }
+    void setPolygon(const QPolygonF &polygon);
 
     /**
      * Returns the polygon associated with this object. Returns an empty
@@ -196,10 +214,22 @@ public:
      */
     const QPolygonF &polygon() const { return mPolygon; }
 
+    /**
+     * Returns the polygon simplified for display at the given \a scale.
+     * Points that would be less than half a pixel away from the simplified
+     * outline are dropped. The result is cached per power of two, rounding
+     * the scale up, so that zooming doesn't keep simplifying the polygon
+     * again. Small polygons are returned as-is.
+     *
+     * Only meant for drawing and hit-testing. Editing and saving should use
+     * the exact polygon().
+     */
+    QPolygonF simplifiedPolygon(qreal scale) const;
+
     /**
      * Sets the shape of the object.
      */
-    void setShape(Shape shape) { mShape = shape; }
+    void setShape(Shape shape) { mShape = shape; geometryChanged(); }
 
     /**
      * Returns the shape of the object.
@@ -222,7 +252,7 @@ public:
      *
      * \warning The object shape is ignored for tile objects!
      */
-    void setCell(const Cell &cell) { mCell = cell; }
+    void setCell(const Cell &cell) { mCell = cell; geometryChanged(); }
 
     /**
      * Returns the tile associated with this object.
@@ -241,6 +271,14 @@ public:
     void setObjectGroup(ObjectGroup *objectGroup)
     { mObjectGroup = objectGroup; }
 
+    /**
+     * Returns the index of this object in its object group, or -1 when it
+     * isn't part of an object group.
+     *
+     * \sa ObjectGroup::indexOf()
+     */
+    int index() const;
+
     /**
      * Returns the rotation of the object in degrees.
      */
@@ -249,7 +287,7 @@ public:
     /**
      * Sets the rotation of the object in degrees.
      */
-    void setRotation(qreal rotation) { mRotation = rotation; }
+    void setRotation(qreal rotation) { mRotation = rotation; geometryChanged(); }
 
     Alignment alignment() const;
 
@@ -268,26 +306,72 @@ public:
      */
     MapObject *clone() const;
 
+    /**
+     * Returns the value of the \a name property. When this object doesn't
+     * have the property, the default value for its type is returned.
+     */
+    QVariant resolvedProperty(const QString &name) const;
+
+    /**
+     * Returns the properties of this object, layered over the default
+     * properties of its type.
+     */
+    Properties resolvedProperties() const;
+
+    /**
+     * Returns the default properties of the given object \a type.
+     *
+     * These are empty unless setTypeDefaultProperties() was called. Only
+     * Tiled itself does so, based on its object types, so in other users
+     * of this library the properties resolve to those of the object.
+     */
+    static PropertyList typeDefaultProperties(const QString &type);
+
+    /**
+     * Sets the default properties for each object type, by type name. These
+     * are used when resolving properties. Should be called again whenever
+     * the object types change.
+     *
+     * The defaults are shared by the whole process.
+     */
+    static void setTypeDefaultProperties(const QHash<QString, Properties> &defaults);
+
 private:
+    friend class ObjectGroup;
+
+    void geometryChanged();
+
     int mId;
     QString mName;
     QString mType;
     QPointF mPos;
     QSizeF mSize;
     QPolygonF mPolygon;
+    mutable QHash<int, QPolygonF> mSimplifiedPolygons;  // cached by level
     Shape mShape;
     Cell mCell;
     ObjectGroup *mObjectGroup;
+    int mIndex;                 // cached, see ObjectGroup::indexOf()
     qreal mRotation;
     bool mVisible;
 };
 
+inline void MapObject::setPolygon(const QPolygonF &polygon)
+{
+    mPolygon = polygon;
+    mSimplifiedPolygons.clear();
+    geometryChanged();
+}
+
 inline void MapObject::setBounds(const QRectF &bounds)
 {
     mPos = bounds.topLeft();
     mSize = bounds.size();
+    geometryChanged();
 }
 
 } // namespace Tiled
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(Tiled::MapObject::ChangedProperties)
+
 #endif // MAPOBJECT_H
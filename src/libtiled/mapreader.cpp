@@ -38,6 +38,7 @@
 #include "mapobject.h"
 #include "tile.h"
 #include "tilelayer.h"
+#include "tilesetcache.h"
 #include "tilesetformat.h"
 #include "terrain.h"
 
@@ -63,13 +64,14 @@ class MapReaderPrivate
 public:
     MapReaderPrivate(MapReader *mapReader):
         p(mapReader),
+        mTilesetCache(nullptr),
         mReadingExternalTileset(false)
     {}
 
     Map *readMap(QIODevice *device, const QString &path);
     SharedTileset readTileset(QIODevice *device, const QString &path);
 
-    bool openFile(QFile *file);
+    bool openFile(MappedFile *file, const QString &fileName);
 
     QString errorString() const;
 
@@ -86,6 +88,7 @@ private:
 
     TileLayer *readLayer();
     void readLayerData(TileLayer &tileLayer);
+    void decodeXmlLayerData(TileLayer &tileLayer);
     void decodeBinaryLayerData(TileLayer &tileLayer,
                                const QByteArray &data,
                                Map::LayerDataFormat format);
@@ -118,6 +121,7 @@ private:
     QString mPath;
     QScopedPointer<Map> mMap;
     GidMapper mGidMapper;
+    TilesetCache *mTilesetCache;
     bool mReadingExternalTileset;
 
     QXmlStreamReader xml;
@@ -174,13 +178,13 @@ QString MapReaderPrivate::errorString() const
     }
 }
 
-bool MapReaderPrivate::openFile(QFile *file)
+bool MapReaderPrivate::openFile(MappedFile *file, const QString &fileName)
 {
-    if (!file->exists()) {
-        mError = tr("File not found: %1").arg(file->fileName());
+    if (!QFile::exists(fileName)) {
+        mError = tr("File not found: %1").arg(fileName);
         return false;
-    } else if (!file->open(QFile::ReadOnly | QFile::Text)) {
-        mError = tr("Unable to read file: %1").arg(file->fileName());
+    } else if (!file->open()) {
+        mError = tr("Unable to read file: %1").arg(fileName);
         return false;
     }
 
@@ -269,7 +273,7 @@ Map *MapReaderPrivate::readMap()
         auto tilesets = mMap->tilesets();
         for (SharedTileset &tileset : tilesets) {
             if (!tileset->isCollection() && tileset->fileName().isEmpty())
-                tileset->loadImage();
+                tileset->loadImageLazily();
         }
 
         mMap->recomputeDrawMargins();
@@ -597,33 +601,16 @@ void MapReaderPrivate::readLayerData(TileLayer &tileLayer)
 
     mMap->setLayerDataFormat(layerDataFormat);
 
-    int x = 0;
-    int y = 0;
+    if (layerDataFormat == Map::XML) {
+        decodeXmlLayerData(tileLayer);
+        return;
+    }
 
     while (xml.readNext() != QXmlStreamReader::Invalid) {
         if (xml.isEndElement()) {
             break;
         } else if (xml.isStartElement()) {
-            if (xml.name() == QLatin1String("tile")) {
-                if (y >= tileLayer.height()) {
-                    xml.raiseError(tr("Too many <tile> elements"));
-                    continue;
-                }
-
-                const QXmlStreamAttributes atts = xml.attributes();
-                unsigned gid = atts.value(QLatin1String("gid")).toUInt();
-                tileLayer.setCell(x, y, cellForGid(gid));
-
-                x++;
-                if (x >= tileLayer.width()) {
-                    x = 0;
-                    y++;
-                }
-
-                xml.skipCurrentElement();
-            } else {
-                readUnknownElement();
-            }
+            readUnknownElement();
         } else if (xml.isCharacters() && !xml.isWhitespace()) {
             if (encoding == QLatin1String("base64")) {
                 decodeBinaryLayerData(tileLayer,
@@ -636,6 +623,84 @@ void MapReaderPrivate::readLayerData(TileLayer &tileLayer)
     }
 }
 
+/**
+ * Returns the gid attribute among the \a attributes of a <tile> element. The
+ * attributes are scanned directly and plain decimal values are parsed in
+ * place, since this runs for every cell of the layer.
+ */
+static unsigned tileGid(const QXmlStreamAttributes &attributes)
+{
+    const QLatin1String gidName("gid");
+
+    for (const QXmlStreamAttribute &attribute : attributes) {
+        if (attribute.name() != gidName)
+            continue;
+
+        const QStringRef value = attribute.value();
+        const QChar *c = value.unicode();
+        const QChar *end = c + value.size();
+
+        quint64 gid = 0;
+        for (; c != end; ++c) {
+            const ushort digit = c->unicode() - '0';
+            if (digit > 9 || gid > 0xFFFFFFFFu / 10)
+                return value.toUInt();  // leave anything unusual to Qt
+            gid = gid * 10 + digit;
+        }
+
+        return gid <= 0xFFFFFFFFu ? unsigned(gid) : 0;
+    }
+
+    return 0;
+}
+
+/**
+ * Reads the <tile> elements of layer data without encoding. Such layers
+ * consist of one element for every cell, so this loop does as little as
+ * possible per element. Since runs of the same tile are common, the cell
+ * for the previous gid is reused instead of being looked up again.
+ */
+void MapReaderPrivate::decodeXmlLayerData(TileLayer &tileLayer)
+{
+    const int width = tileLayer.width();
+    const int size = width * tileLayer.height();
+    const QLatin1String tileName("tile");
+
+    int index = 0;
+    unsigned lastGid = 0;
+    Cell lastCell;
+
+    while (xml.readNext() != QXmlStreamReader::Invalid) {
+        if (xml.isEndElement())
+            break;
+        if (!xml.isStartElement())
+            continue;
+
+        if (xml.name() != tileName) {
+            readUnknownElement();
+            continue;
+        }
+
+        if (index >= size) {
+            xml.raiseError(tr("Too many <tile> elements"));
+            continue;
+        }
+
+        const unsigned gid = tileGid(xml.attributes());
+        if (gid != lastGid) {
+            lastGid = gid;
+            lastCell = cellForGid(gid);
+        }
+
+        // The layer starts out empty
+        if (!lastCell.isEmpty())
+            tileLayer.setCell(index % width, index / width, lastCell);
+
+        ++index;
+        xml.skipCurrentElement();
+    }
+}
+
 void MapReaderPrivate::decodeBinaryLayerData(TileLayer &tileLayer,
                                              const QByteArray &data,
                                              Map::LayerDataFormat format)
@@ -974,29 +1039,29 @@ Map *MapReader::readMap(QIODevice *device, const QString &path)
 
 Map *MapReader::readMap(const QString &fileName)
 {
-    QFile file(fileName);
-    if (!d->openFile(&file))
+    MappedFile file(fileName);
+    if (!d->openFile(&file, fileName))
         return nullptr;
 
-    return readMap(&file, QFileInfo(fileName).absolutePath());
+    return readMap(file.device(), QFileInfo(fileName).absolutePath());
 }
 
 SharedTileset MapReader::readTileset(QIODevice *device, const QString &path)
 {
     SharedTileset tileset = d->readTileset(device, path);
     if (tileset && !tileset->isCollection())
-        tileset->loadImage();
+        tileset->loadImageLazily();
 
     return tileset;
 }
 
 SharedTileset MapReader::readTileset(const QString &fileName)
 {
-    QFile file(fileName);
-    if (!d->openFile(&file))
+    MappedFile file(fileName);
+    if (!d->openFile(&file, fileName))
         return SharedTileset();
 
-    SharedTileset tileset = readTileset(&file, QFileInfo(fileName).absolutePath());
+    SharedTileset tileset = readTileset(file.device(), QFileInfo(fileName).absolutePath());
     if (tileset)
         tileset->setFileName(fileName);
 
@@ -1016,8 +1081,21 @@ QString MapReader::resolveReference(const QString &reference,
     return reference;
 }
 
+void MapReader::setTilesetCache(TilesetCache *cache)
+{
+    d->mTilesetCache = cache;
+}
+
+TilesetCache *MapReader::tilesetCache() const
+{
+    return d->mTilesetCache;
+}
+
 SharedTileset MapReader::readExternalTileset(const QString &source,
                                              QString *error)
 {
+    if (d->mTilesetCache)
+        return d->mTilesetCache->load(source, error);
+
     return Tiled::readTileset(source, error);
 }
@@ -39,6 +39,7 @@ class QFile;
 namespace Tiled {
 
 class Map;
+class TilesetCache;
 
 namespace Internal {
 class MapReaderPrivate;
@@ -95,6 +96,16 @@ public:
      */
     QString errorString() const;
 
+    /**
+     * Sets a \a cache from which external tilesets are taken, so that
+     * tilesets used by several maps are only loaded once. The cache is not
+     * owned by the reader.
+     *
+     * Only used by the default implementation of readExternalTileset().
+     */
+    void setTilesetCache(TilesetCache *cache);
+    TilesetCache *tilesetCache() const;
+
 protected:
     /**
      * Called for each \a reference to an external file. Should return the path
@@ -106,7 +117,8 @@ protected:
 
     /**
      * Called when an external tileset is encountered while a map is loaded.
-     * The default implementation just calls Tiled::readTileset().
+     * The default implementation calls Tiled::readTileset(), or gets the
+     * tileset from the tileset cache when one was set.
      *
      * If an error occurred, the \a error parameter should be set to the error
      * message.
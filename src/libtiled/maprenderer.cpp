@@ -29,20 +29,108 @@
 #include "maprenderer.h"
 
 #include "imagelayer.h"
+#include "mapobject.h"
+#include "objectgroup.h"
+#include "spatialindex.h"
 #include "tile.h"
 #include "tilelayer.h"
 
 #include <QPaintEngine>
 #include <QPainter>
+#include <QPainterPath>
 #include <QVector2D>
 
+#include <algorithm>
+
 using namespace Tiled;
 
+/**
+ * Returns the transform that rotates the given \a object around its
+ * position, which is given in screen coordinates.
+ */
+static QTransform rotationTransform(const MapObject *object,
+                                    const QPointF &pos)
+{
+    QTransform transform;
+    transform.translate(pos.x(), pos.y());
+    transform.rotate(object->rotation());
+    transform.translate(-pos.x(), -pos.y());
+    return transform;
+}
+
+static QPainterPath rotatedShape(const MapRenderer *renderer,
+                                 const MapObject *object)
+{
+    const QPainterPath path = renderer->shape(object);
+    if (object->rotation() == 0)
+        return path;
+
+    const QPointF pos = renderer->pixelToScreenCoords(object->position());
+    return rotationTransform(object, pos).map(path);
+}
+
 QRectF MapRenderer::boundingRect(const ImageLayer *imageLayer) const
 {
     return QRectF(QPointF(), imageLayer->image().size());
 }
 
+QRectF MapRenderer::rotatedBoundingRect(const MapObject *object) const
+{
+    const QRectF bounds = boundingRect(object);
+    if (object->rotation() == 0)
+        return bounds;
+
+    const QPointF pos = pixelToScreenCoords(object->position());
+    return rotationTransform(object, pos).mapRect(bounds);
+}
+
+QVector<MapObject*> MapRenderer::objectsAt(const ObjectGroup *objectGroup,
+                                           const QPointF &pos) const
+{
+    QVector<MapObject*> objects =
+            objectGroup->objectIndex(this).intersecting(QRectF(pos, QSizeF()));
+
+    auto missed = [&] (const MapObject *object) {
+        return !object->isVisible() || !rotatedShape(this, object).contains(pos);
+    };
+
+    objects.erase(std::remove_if(objects.begin(), objects.end(), missed),
+                  objects.end());
+    return objects;
+}
+
+QVector<MapObject*> MapRenderer::objectsIntersecting(const ObjectGroup *objectGroup,
+                                                     const QRectF &rect) const
+{
+    QPainterPath path;
+    path.addRect(rect);
+    return objectsIntersecting(objectGroup, path);
+}
+
+QVector<MapObject*> MapRenderer::objectsIntersecting(const ObjectGroup *objectGroup,
+                                                     const QPainterPath &path) const
+{
+    QVector<MapObject*> objects =
+            objectGroup->objectIndex(this).intersecting(path.boundingRect());
+
+    auto missed = [&] (const MapObject *object) {
+        return !object->isVisible() || !rotatedShape(this, object).intersects(path);
+    };
+
+    objects.erase(std::remove_if(objects.begin(), objects.end(), missed),
+                  objects.end());
+    return objects;
+}
+
+QVector<MapObject*> MapRenderer::objectsIntersecting(const ObjectGroup *objectGroup,
+                                                     const QPolygonF &polygon) const
+{
+    QPainterPath path;
+    path.addPolygon(polygon);
+    path.closeSubpath();
+    return objectsIntersecting(objectGroup, path);
+}
+
 void MapRenderer::drawImageLayer(QPainter *painter,
                                  const ImageLayer *imageLayer,
                                  const QRectF &exposed)
@@ -60,6 +148,25 @@ void MapRenderer::setFlag(RenderFlag flag, bool enabled)
         mFlags &= ~flag;
 }
 
+void MapRenderer::drawTileObjectOutlines(QPainter *painter,
+                                         const QPainterPath &path,
+                                         const QColor &color)
+{
+    painter->save();
+    painter->setBrush(Qt::NoBrush);
+
+    QPen pen(Qt::SolidLine);
+    pen.setCosmetic(true);
+    painter->setPen(pen);
+    painter->drawPath(path);
+    pen.setStyle(Qt::DotLine);
+    pen.setColor(color);
+    painter->setPen(pen);
+    painter->drawPath(path);
+
+    painter->restore();
+}
+
 /**
  * Converts a line running from \a start to \a end to a polygon which
  * extends 5 pixels from the line in all directions.
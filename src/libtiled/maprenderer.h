@@ -39,6 +39,7 @@ class Cell;
 class Layer;
 class Map;
 class MapObject;
+class ObjectGroup;
 class Tile;
 class TileLayer;
 class ImageLayer;
@@ -91,6 +92,12 @@ public:
      */
     virtual QRectF boundingRect(const MapObject *object) const = 0;
 
+    /**
+     * Returns the bounding rectangle in pixels of the given \a object, taking
+     * into account its rotation.
+     */
+    QRectF rotatedBoundingRect(const MapObject *object) const;
+
     /**
      * Returns the bounding rectangle in pixels of the given \a imageLayer, as
      * it would be drawn by drawImageLayer().
@@ -104,6 +111,34 @@ public:
      */
     virtual QPainterPath shape(const MapObject *object) const = 0;
 
+    /**
+     * Returns the visible objects of \a objectGroup whose shape contains the
+     * given \a pos, in no particular order. Uses the spatial index of the
+     * object group.
+     *
+     * Like all object queries, the position is in pixels, without the offset
+     * of the object group.
+     */
+    QVector<MapObject*> objectsAt(const ObjectGroup *objectGroup,
+                                  const QPointF &pos) const;
+
+    /**
+     * Returns the visible objects of \a objectGroup whose shape intersects
+     * the given \a rect, in no particular order.
+     */
+    QVector<MapObject*> objectsIntersecting(const ObjectGroup *objectGroup,
+                                            const QRectF &rect) const;
+
+    /**
+     * Returns the visible objects of \a objectGroup whose shape intersects
+     * the given \a path, in no particular order.
+     */
+    QVector<MapObject*> objectsIntersecting(const ObjectGroup *objectGroup,
+                                            const QPainterPath &path) const;
+
+    QVector<MapObject*> objectsIntersecting(const ObjectGroup *objectGroup,
+                                            const QPolygonF &polygon) const;
+
     /**
      * Draws the tile grid in the specified \a rect using the given
      * \a painter.
@@ -138,6 +173,24 @@ public:
                                const MapObject *object,
                                const QColor &color) const = 0;
 
+    /**
+     * Returns the rectangle drawn around the tile of the given \a object when
+     * the ShowTileObjectOutlines flag is set, in the coordinates used by
+     * drawMapObject() before the rotation of the object is applied.
+     *
+     * Returns a null rectangle for objects without a tile, and for outlines
+     * that would be too small to be worth drawing.
+     */
+    virtual QRectF tileObjectOutline(const MapObject *object) const = 0;
+
+    /**
+     * Draws the tile object outlines in \a path in the given \a color. The
+     * outlines of several objects can be drawn at once this way.
+     */
+    static void drawTileObjectOutlines(QPainter *painter,
+                                       const QPainterPath &path,
+                                       const QColor &color);
+
     /**
      * Draws the given image \a layer using the given \a painter.
      */
@@ -214,6 +267,16 @@ public:
 
     static QPolygonF lineToPolygon(const QPointF &start, const QPointF &end);
 
+protected:
+    /**
+     * Returns whether the outline of a tile object with bounds of the given
+     * \a size is large enough on screen to be worth drawing, taking into account the
+     * painter scale. Stroking the outlines of tiny tile objects only costs
+     * time when zoomed out far.
+     */
+    bool isOutlineVisible(const QSizeF &size) const
+    { return qMax(size.width(), size.height()) * mPainterScale >= 4; }
+
 private:
     const Map *mMap;
 
@@ -31,6 +31,8 @@
 #include "tileset.h"
 #include "terrain.h"
 
+#include <QVector>
+
 using namespace Tiled;
 
 static QString colorToString(const QColor &color)
@@ -56,7 +58,7 @@ QVariant MapToVariantConverter::toVariant(const Map *map, const QDir &mapDir)
     mapVariant[QLatin1String("tileheight")] = map->tileHeight();
     mapVariant[QLatin1String("nextobjectid")] = map->nextObjectId();
 
-    addProperties(mapVariant, map->properties());
+    addProperties(mapVariant, map->propertyList());
 
     if (map->orientation() == Map::Hexagonal) {
         mapVariant[QLatin1String("hexsidelength")] = map->hexSideLength();
@@ -118,7 +120,7 @@ QVariant MapToVariantConverter::toVariant(const Tileset *tileset,
 
     const QString &fileName = tileset->fileName();
     if (!fileName.isEmpty()) {
-        QString source = mMapDir.relativeFilePath(fileName);
+        QString source = referenceTo(fileName);
         tilesetVariant[QLatin1String("source")] = source;
 
         // Tileset is external, so no need to write any of the stuff below
@@ -133,7 +135,7 @@ QVariant MapToVariantConverter::toVariant(const Tileset *tileset,
     tilesetVariant[QLatin1String("tilecount")] = tileset->tileCount();
     tilesetVariant[QLatin1String("columns")] = tileset->columnCount();
 
-    addProperties(tilesetVariant, tileset->properties());
+    addProperties(tilesetVariant, tileset->propertyList());
 
     const QPoint offset = tileset->tileOffset();
     if (!offset.isNull()) {
@@ -146,7 +148,7 @@ QVariant MapToVariantConverter::toVariant(const Tileset *tileset,
     // Write the image element
     const QString &imageSource = tileset->imageSource();
     if (!imageSource.isEmpty()) {
-        const QString rel = mMapDir.relativeFilePath(tileset->imageSource());
+        const QString rel = referenceTo(tileset->imageSource());
 
         tilesetVariant[QLatin1String("image")] = rel;
 
@@ -164,7 +166,7 @@ QVariant MapToVariantConverter::toVariant(const Tileset *tileset,
     QVariantMap tilePropertyTypesVariant;
     QVariantMap tilesVariant;
     for (const Tile *tile  : tileset->tiles()) {
-        const Properties properties = tile->properties();
+        const PropertyList &properties = tile->propertyList();
         if (!properties.isEmpty()) {
             tilePropertiesVariant[QString::number(tile->id())] = toVariant(properties);
             tilePropertyTypesVariant[QString::number(tile->id())] = propertyTypesToVariant(properties);
@@ -179,7 +181,7 @@ QVariant MapToVariantConverter::toVariant(const Tileset *tileset,
         if (tile->probability() != 1.f)
             tileVariant[QLatin1String("probability")] = tile->probability();
         if (!tile->imageSource().isEmpty()) {
-            const QString rel = mMapDir.relativeFilePath(tile->imageSource());
+            const QString rel = referenceTo(tile->imageSource());
             tileVariant[QLatin1String("image")] = rel;
         }
         if (tile->objectGroup())
@@ -210,11 +212,10 @@ QVariant MapToVariantConverter::toVariant(const Tileset *tileset,
         QVariantList terrainsVariant;
         for (int i = 0; i < tileset->terrainCount(); ++i) {
             Terrain *terrain = tileset->terrain(i);
-            const Properties &properties = terrain->properties();
             QVariantMap terrainVariant;
             terrainVariant[QLatin1String("name")] = terrain->name();
             terrainVariant[QLatin1String("tile")] = terrain->imageTileId();
-            addProperties(terrainVariant, properties);
+            addProperties(terrainVariant, terrain->propertyList());
             terrainsVariant << terrainVariant;
         }
         tilesetVariant[QLatin1String("terrains")] = terrainsVariant;
@@ -223,32 +224,29 @@ QVariant MapToVariantConverter::toVariant(const Tileset *tileset,
     return tilesetVariant;
 }
 
-QVariant MapToVariantConverter::toVariant(const Properties &properties) const
+QVariant MapToVariantConverter::toVariant(const PropertyList &properties) const
 {
     QVariantMap variantMap;
 
-    Properties::const_iterator it = properties.constBegin();
-    Properties::const_iterator it_end = properties.constEnd();
-    for (; it != it_end; ++it) {
-        QVariant value = toExportValue(it.value());
+    for (int i = 0; i < properties.size(); ++i) {
+        const QVariant &propertyValue = properties.valueAt(i);
+        QVariant value = toExportValue(propertyValue);
 
-        if (it.value().userType() == filePathTypeId())
-            value = mMapDir.relativeFilePath(value.toString());
+        if (propertyValue.userType() == filePathTypeId())
+            value = referenceTo(value.toString());
 
-        variantMap[it.key()] = value;
+        variantMap[properties.nameAt(i)] = value;
     }
 
     return variantMap;
 }
 
-QVariant MapToVariantConverter::propertyTypesToVariant(const Properties &properties) const
+QVariant MapToVariantConverter::propertyTypesToVariant(const PropertyList &properties) const
 {
     QVariantMap variantMap;
 
-    Properties::const_iterator it = properties.constBegin();
-    Properties::const_iterator it_end = properties.constEnd();
-    for (; it != it_end; ++it)
-        variantMap[it.key()] = typeToName(it.value().userType());
+    for (int i = 0; i < properties.size(); ++i)
+        variantMap[properties.nameAt(i)] = typeToName(properties.valueAt(i).userType());
 
     return variantMap;
 }
@@ -264,6 +262,17 @@ QVariant MapToVariantConverter::toVariant(const TileLayer *tileLayer,
     switch (format) {
     case Map::XML:
     case Map::CSV: {
+        if (mCompactLayerData) {
+            QVector<unsigned> gids;
+            gids.reserve(tileLayer->width() * tileLayer->height());
+            for (int y = 0; y < tileLayer->height(); ++y)
+                for (int x = 0; x < tileLayer->width(); ++x)
+                    gids.append(mGidMapper.cellToGid(tileLayer->cellAt(x, y)));
+
+            tileLayerVariant[QLatin1String("data")] = QVariant::fromValue(gids);
+            break;
+        }
+
         QVariantList tileVariants;
         for (int y = 0; y < tileLayer->height(); ++y)
             for (int x = 0; x < tileLayer->width(); ++x)
@@ -308,7 +317,7 @@ QVariant MapToVariantConverter::toVariant(const ObjectGroup *objectGroup) const
         const QString &name = object->name();
         const QString &type = object->type();
 
-        addProperties(objectVariant, object->properties());
+        addProperties(objectVariant, object->propertyList());
 
         objectVariant[QLatin1String("id")] = object->id();
         objectVariant[QLatin1String("name")] = name;
@@ -365,7 +374,7 @@ QVariant MapToVariantConverter::toVariant(const ImageLayer *imageLayer) const
 
     addLayerAttributes(imageLayerVariant, imageLayer);
 
-    const QString rel = mMapDir.relativeFilePath(imageLayer->imageSource());
+    const QString rel = referenceTo(imageLayer->imageSource());
     imageLayerVariant[QLatin1String("image")] = rel;
 
     const QColor transColor = imageLayer->transparentColor();
@@ -392,11 +401,11 @@ void MapToVariantConverter::addLayerAttributes(QVariantMap &layerVariant,
         layerVariant[QLatin1String("offsety")] = offset.y();
     }
 
-    addProperties(layerVariant, layer->properties());
+    addProperties(layerVariant, layer->propertyList());
 }
 
 void MapToVariantConverter::addProperties(QVariantMap &variantMap,
-                                          const Properties &properties) const
+                                          const PropertyList &properties) const
 {
     if (properties.isEmpty())
         return;
@@ -404,19 +413,30 @@ void MapToVariantConverter::addProperties(QVariantMap &variantMap,
     QVariantMap propertiesMap;
     QVariantMap propertyTypesMap;
 
-    Properties::const_iterator it = properties.constBegin();
-    Properties::const_iterator it_end = properties.constEnd();
-    for (; it != it_end; ++it) {
-        int type = it.value().userType();
-        QVariant value = toExportValue(it.value());
+    for (int i = 0; i < properties.size(); ++i) {
+        const QString &name = properties.nameAt(i);
+        const QVariant &propertyValue = properties.valueAt(i);
+
+        int type = propertyValue.userType();
+        QVariant value = toExportValue(propertyValue);
 
         if (type == filePathTypeId())
-            value = mMapDir.relativeFilePath(value.toString());
+            value = referenceTo(value.toString());
 
-        propertiesMap[it.key()] = value;
-        propertyTypesMap[it.key()] = typeToName(type);
+        propertiesMap[name] = value;
+        propertyTypesMap[name] = typeToName(type);
     }
 
     variantMap[QLatin1String("properties")] = propertiesMap;
     variantMap[QLatin1String("propertytypes")] = propertyTypesMap;
 }
+
+/**
+ * Returns how the file at \a fileName is referred to from the map directory.
+ */
+QString MapToVariantConverter::referenceTo(const QString &fileName) const
+{
+    if (mUseAbsolutePaths)
+        return fileName;
+    return mMapDir.relativeFilePath(fileName);
+}
@@ -30,13 +30,31 @@
 namespace Tiled {
 
 /**
- * Converts Map instances to QVariant. Meant to be used together with
- * JsonWriter.
+ * Converts Map instances to QVariant. Meant to be used together with the
+ * JsonStreamWriter of the JSON plugin.
  */
 class TILEDSHARED_EXPORT MapToVariantConverter
 {
 public:
-    MapToVariantConverter() {}
+    MapToVariantConverter()
+        : mCompactLayerData(false)
+        , mUseAbsolutePaths(false)
+    {}
+
+    /**
+     * Sets whether CSV layer data is stored as a QVector<unsigned> of global
+     * tile IDs rather than a QVariantList. This avoids a QVariant per tile,
+     * but requires a writer that knows about this type.
+     */
+    void setCompactLayerData(bool compact) { mCompactLayerData = compact; }
+    bool compactLayerData() const { return mCompactLayerData; }
+
+    /**
+     * Sets whether references to external resources are stored as absolute
+     * paths, for when there is no directory to make them relative to.
+     */
+    void setUseAbsolutePaths(bool absolute) { mUseAbsolutePaths = absolute; }
+    bool useAbsolutePaths() const { return mUseAbsolutePaths; }
 
     /**
      * Converts the given \s map to a QVariant. The \a mapDir is used to
@@ -52,8 +70,8 @@ public:
 
 private:
     QVariant toVariant(const Tileset *tileset, int firstGid) const;
-    QVariant toVariant(const Properties &properties) const;
-    QVariant propertyTypesToVariant(const Properties &properties) const;
+    QVariant toVariant(const PropertyList &properties) const;
+    QVariant propertyTypesToVariant(const PropertyList &properties) const;
     QVariant toVariant(const TileLayer *tileLayer,
                        Map::LayerDataFormat format) const;
     QVariant toVariant(const ObjectGroup *objectGroup) const;
@@ -63,10 +81,14 @@ private:
                             const Layer *layer) const;
 
     void addProperties(QVariantMap &variantMap,
-                       const Properties &properties) const;
+                       const PropertyList &properties) const;
+
+    QString referenceTo(const QString &fileName) const;
 
     QDir mMapDir;
     GidMapper mGidMapper;
+    bool mCompactLayerData;
+    bool mUseAbsolutePaths;
 };
 
 } // namespace Tiled
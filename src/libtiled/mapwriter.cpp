@@ -35,6 +35,7 @@
 #include "map.h"
 #include "mapobject.h"
 #include "imagelayer.h"
+#include "numberformat.h"
 #include "objectgroup.h"
 #include "tile.h"
 #include "tilelayer.h"
@@ -67,13 +68,14 @@ class MapWriterPrivate
 public:
     MapWriterPrivate();
 
-    void writeMap(const Map *map, QIODevice *device,
+    bool writeMap(const Map *map, QIODevice *device,
                   const QString &path);
 
-    void writeTileset(const Tileset &tileset, QIODevice *device,
+    bool writeTileset(const Tileset &tileset, QIODevice *device,
                       const QString &path);
 
     bool openFile(QIODevice *file);
+    void setWriteError(QIODevice *device);
 
     QString mError;
     Map::LayerDataFormat mLayerDataFormat;
@@ -89,11 +91,14 @@ private:
     void writeObject(QXmlStreamWriter &w, const MapObject &mapObject);
     void writeImageLayer(QXmlStreamWriter &w, const ImageLayer &imageLayer);
     void writeProperties(QXmlStreamWriter &w,
-                         const Properties &properties);
+                         const PropertyList &properties);
+    void writeNumberAttribute(QXmlStreamWriter &w,
+                              const QString &name, double value);
 
     QDir mMapDir;     // The directory in which the map is being saved
     GidMapper mGidMapper;
     bool mUseAbsolutePaths;
+    QString mBuffer;  // reused for formatting attribute values
 };
 
 } // namespace Internal
@@ -117,6 +122,13 @@ bool MapWriterPrivate::openFile(QIODevice *file)
     return true;
 }
 
+void MapWriterPrivate::setWriteError(QIODevice *device)
+{
+    mError = device->errorString();
+    if (mError.isEmpty())
+        mError = tr("Could not write to the device.");
+}
+
 static QXmlStreamWriter *createWriter(QIODevice *device)
 {
     QXmlStreamWriter *writer = new QXmlStreamWriter(device);
@@ -125,7 +137,7 @@ static QXmlStreamWriter *createWriter(QIODevice *device)
     return writer;
 }
 
-void MapWriterPrivate::writeMap(const Map *map, QIODevice *device,
+bool MapWriterPrivate::writeMap(const Map *map, QIODevice *device,
                                 const QString &path)
 {
     mMapDir = QDir(path);
@@ -143,10 +155,16 @@ void MapWriterPrivate::writeMap(const Map *map, QIODevice *device,
 
     writeMap(*writer, *map);
     writer->writeEndDocument();
+
+    const bool success = !writer->hasError();
     delete writer;
+
+    if (!success)
+        setWriteError(device);
+    return success;
 }
 
-void MapWriterPrivate::writeTileset(const Tileset &tileset, QIODevice *device,
+bool MapWriterPrivate::writeTileset(const Tileset &tileset, QIODevice *device,
                                     const QString &path)
 {
     mMapDir = QDir(path);
@@ -163,7 +181,13 @@ void MapWriterPrivate::writeTileset(const Tileset &tileset, QIODevice *device,
 
     writeTileset(*writer, tileset, 0);
     writer->writeEndDocument();
+
+    const bool success = !writer->hasError();
     delete writer;
+
+    if (!success)
+        setWriteError(device);
+    return success;
 }
 
 void MapWriterPrivate::writeMap(QXmlStreamWriter &w, const Map &map)
@@ -203,7 +227,7 @@ void MapWriterPrivate::writeMap(QXmlStreamWriter &w, const Map &map)
     w.writeAttribute(QLatin1String("nextobjectid"),
                      QString::number(map.nextObjectId()));
 
-    writeProperties(w, map.properties());
+    writeProperties(w, map.propertyList());
 
     mGidMapper.clear();
     unsigned firstGid = 1;
@@ -285,7 +309,7 @@ void MapWriterPrivate::writeTileset(QXmlStreamWriter &w, const Tileset &tileset,
     }
 
     // Write the tileset properties
-    writeProperties(w, tileset.properties());
+    writeProperties(w, tileset.propertyList());
 
     // Write the image element
     const QString &imageSource = tileset.imageSource();
@@ -320,7 +344,7 @@ void MapWriterPrivate::writeTileset(QXmlStreamWriter &w, const Tileset &tileset,
             w.writeAttribute(QLatin1String("name"), t->name());
             w.writeAttribute(QLatin1String("tile"), QString::number(t->imageTileId()));
 
-            writeProperties(w, t->properties());
+            writeProperties(w, t->propertyList());
 
             w.writeEndElement();
         }
@@ -329,7 +353,7 @@ void MapWriterPrivate::writeTileset(QXmlStreamWriter &w, const Tileset &tileset,
 
     // Write the properties for those tiles that have them
     for (const Tile *tile : tileset.tiles()) {
-        const Properties properties = tile->properties();
+        const PropertyList &properties = tile->propertyList();
         unsigned terrain = tile->terrain();
         float probability = tile->probability();
         ObjectGroup *objectGroup = tile->objectGroup();
@@ -402,7 +426,7 @@ void MapWriterPrivate::writeTileLayer(QXmlStreamWriter &w,
 {
     w.writeStartElement(QLatin1String("layer"));
     writeLayerAttributes(w, tileLayer);
-    writeProperties(w, tileLayer.properties());
+    writeProperties(w, tileLayer.propertyList());
 
     QString encoding;
     QString compression;
@@ -428,12 +452,19 @@ void MapWriterPrivate::writeTileLayer(QXmlStreamWriter &w,
         w.writeAttribute(QLatin1String("compression"), compression);
 
     if (mLayerDataFormat == Map::XML) {
+        // Neighbouring tiles are often the same, so the gid string is reused
+        unsigned lastGid = 0;
+        QString gidString = QString::number(lastGid);
+
         for (int y = 0; y < tileLayer.height(); ++y) {
             for (int x = 0; x < tileLayer.width(); ++x) {
                 const unsigned gid = mGidMapper.cellToGid(tileLayer.cellAt(x, y));
-                w.writeStartElement(QLatin1String("tile"));
-                w.writeAttribute(QLatin1String("gid"), QString::number(gid));
-                w.writeEndElement();
+                if (gid != lastGid) {
+                    lastGid = gid;
+                    gidString = QString::number(gid);
+                }
+                w.writeEmptyElement(QLatin1String("tile"));
+                w.writeAttribute(QLatin1String("gid"), gidString);
             }
         }
     } else if (mLayerDataFormat == Map::CSV) {
@@ -513,7 +544,7 @@ void MapWriterPrivate::writeObjectGroup(QXmlStreamWriter &w,
     }
 
     writeLayerAttributes(w, objectGroup);
-    writeProperties(w, objectGroup.properties());
+    writeProperties(w, objectGroup.propertyList());
 
     for (const MapObject *mapObject : objectGroup.objects())
         writeObject(w, *mapObject);
@@ -524,65 +555,81 @@ void MapWriterPrivate::writeObjectGroup(QXmlStreamWriter &w,
 void MapWriterPrivate::writeObject(QXmlStreamWriter &w,
                                    const MapObject &mapObject)
 {
-    w.writeStartElement(QLatin1String("object"));
-    w.writeAttribute(QLatin1String("id"), QString::number(mapObject.id()));
+    // Objects can be numerous, so this function avoids allocations where
+    // possible: the element and attribute names are static strings and the
+    // numbers are formatted into a reused buffer.
+    w.writeStartElement(QStringLiteral("object"));
+    writeNumberAttribute(w, QStringLiteral("id"), mapObject.id());
     const QString &name = mapObject.name();
     const QString &type = mapObject.type();
     if (!name.isEmpty())
-        w.writeAttribute(QLatin1String("name"), name);
+        w.writeAttribute(QStringLiteral("name"), name);
     if (!type.isEmpty())
-        w.writeAttribute(QLatin1String("type"), type);
+        w.writeAttribute(QStringLiteral("type"), type);
 
     if (!mapObject.cell().isEmpty()) {
         const unsigned gid = mGidMapper.cellToGid(mapObject.cell());
-        w.writeAttribute(QLatin1String("gid"), QString::number(gid));
+        writeNumberAttribute(w, QStringLiteral("gid"), gid);
     }
 
     const QPointF pos = mapObject.position();
     const QSizeF size = mapObject.size();
 
-    w.writeAttribute(QLatin1String("x"), QString::number(pos.x()));
-    w.writeAttribute(QLatin1String("y"), QString::number(pos.y()));
+    writeNumberAttribute(w, QStringLiteral("x"), pos.x());
+    writeNumberAttribute(w, QStringLiteral("y"), pos.y());
 
     if (size.width() != 0)
-        w.writeAttribute(QLatin1String("width"), QString::number(size.width()));
+        writeNumberAttribute(w, QStringLiteral("width"), size.width());
     if (size.height() != 0)
-        w.writeAttribute(QLatin1String("height"), QString::number(size.height()));
+        writeNumberAttribute(w, QStringLiteral("height"), size.height());
 
     const qreal rotation = mapObject.rotation();
     if (rotation != 0.0)
-        w.writeAttribute(QLatin1String("rotation"), QString::number(rotation));
+        writeNumberAttribute(w, QStringLiteral("rotation"), rotation);
 
     if (!mapObject.isVisible())
-        w.writeAttribute(QLatin1String("visible"), QLatin1String("0"));
+        w.writeAttribute(QStringLiteral("visible"), QStringLiteral("0"));
 
-    writeProperties(w, mapObject.properties());
+    writeProperties(w, mapObject.propertyList());
 
     const QPolygonF &polygon = mapObject.polygon();
     if (!polygon.isEmpty()) {
         if (mapObject.shape() == MapObject::Polygon)
-            w.writeStartElement(QLatin1String("polygon"));
+            w.writeStartElement(QStringLiteral("polygon"));
         else
-            w.writeStartElement(QLatin1String("polyline"));
+            w.writeStartElement(QStringLiteral("polyline"));
 
-        QString points;
+        mBuffer.resize(0);
         for (const QPointF &point : polygon) {
-            points.append(QString::number(point.x()));
-            points.append(QLatin1Char(','));
-            points.append(QString::number(point.y()));
-            points.append(QLatin1Char(' '));
+            appendNumber(mBuffer, point.x());
+            mBuffer.append(QLatin1Char(','));
+            appendNumber(mBuffer, point.y());
+            mBuffer.append(QLatin1Char(' '));
         }
-        points.chop(1);
-        w.writeAttribute(QLatin1String("points"), points);
+        mBuffer.chop(1);
+        w.writeAttribute(QStringLiteral("points"), mBuffer);
         w.writeEndElement();
     }
 
     if (mapObject.shape() == MapObject::Ellipse)
-        w.writeEmptyElement(QLatin1String("ellipse"));
+        w.writeEmptyElement(QStringLiteral("ellipse"));
 
     w.writeEndElement();
 }
 
+/**
+ * Writes an attribute with the given numeric \a value, formatted without
+ * loss of precision.
+ */
+void MapWriterPrivate::writeNumberAttribute(QXmlStreamWriter &w,
+                                            const QString &name,
+                                            double value)
+{
+    mBuffer.resize(0);
+    appendNumber(mBuffer, value);
+    w.writeAttribute(name, mBuffer);
+}
+
 void MapWriterPrivate::writeImageLayer(QXmlStreamWriter &w,
                                        const ImageLayer &imageLayer)
 {
@@ -613,31 +660,31 @@ void MapWriterPrivate::writeImageLayer(QXmlStreamWriter &w,
         w.writeEndElement();
     }
 
-    writeProperties(w, imageLayer.properties());
+    writeProperties(w, imageLayer.propertyList());
 
     w.writeEndElement();
 }
 
 void MapWriterPrivate::writeProperties(QXmlStreamWriter &w,
-                                       const Properties &properties)
+                                       const PropertyList &properties)
 {
     if (properties.isEmpty())
         return;
 
-    w.writeStartElement(QLatin1String("properties"));
+    w.writeStartElement(QStringLiteral("properties"));
+
+    for (int i = 0; i < properties.size(); ++i) {
+        const QVariant &propertyValue = properties.valueAt(i);
 
-    Properties::const_iterator it = properties.constBegin();
-    Properties::const_iterator it_end = properties.constEnd();
-    for (; it != it_end; ++it) {
-        w.writeStartElement(QLatin1String("property"));
-        w.writeAttribute(QLatin1String("name"), it.key());
+        w.writeStartElement(QStringLiteral("property"));
+        w.writeAttribute(QStringLiteral("name"), properties.nameAt(i));
 
-        int type = it.value().userType();
+        int type = propertyValue.userType();
         QString typeName = typeToName(type);
         if (typeName != QLatin1String("string"))
-            w.writeAttribute(QLatin1String("type"), typeName);
+            w.writeAttribute(QStringLiteral("type"), typeName);
 
-        QString value = toExportValue(it.value()).toString();
+        QString value = toExportValue(propertyValue).toString();
 
         if (type == filePathTypeId() && !mUseAbsolutePaths)
             value = mMapDir.relativeFilePath(value);
@@ -645,7 +692,7 @@ void MapWriterPrivate::writeProperties(QXmlStreamWriter &w,
         if (value.contains(QLatin1Char('\n')))
             w.writeCharacters(value);
         else
-            w.writeAttribute(QLatin1String("value"), value);
+            w.writeAttribute(QStringLiteral("value"), value);
 
         w.writeEndElement();
     }
@@ -664,10 +711,10 @@ MapWriter::~MapWriter()
     delete d;
 }
 
-void MapWriter::writeMap(const Map *map, QIODevice *device,
+bool MapWriter::writeMap(const Map *map, QIODevice *device,
                          const QString &path)
 {
-    d->writeMap(map, device, path);
+    return d->writeMap(map, device, path);
 }
 
 bool MapWriter::writeMap(const Map *map, const QString &fileName)
@@ -691,10 +738,10 @@ bool MapWriter::writeMap(const Map *map, const QString &fileName)
     return true;
 }
 
-void MapWriter::writeTileset(const Tileset &tileset, QIODevice *device,
+bool MapWriter::writeTileset(const Tileset &tileset, QIODevice *device,
                              const QString &path)
 {
-    d->writeTileset(tileset, device, path);
+    return d->writeTileset(tileset, device, path);
 }
 
 bool MapWriter::writeTileset(const Tileset &tileset, const QString &fileName)
@@ -60,10 +60,10 @@ public:
      * be given, which will be used to create relative references to external
      * images and tilesets.
      *
-     * Error checking will need to be done on the \a device after calling this
-     * function.
+     * Returns false and sets errorString() when writing to the \a device
+     * failed.
      */
-    void writeMap(const Map *map, QIODevice *device,
+    bool writeMap(const Map *map, QIODevice *device,
                   const QString &path = QString());
 
     /**
@@ -79,10 +79,10 @@ public:
      * be given, which will be used to create relative references to external
      * images.
      *
-     * Error checking will need to be done on the \a device after calling this
-     * function.
+     * Returns false and sets errorString() when writing to the \a device
+     * failed.
      */
-    void writeTileset(const Tileset &tileset, QIODevice *device,
+    bool writeTileset(const Tileset &tileset, QIODevice *device,
                       const QString &path = QString());
 
     /**
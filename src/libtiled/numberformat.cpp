@@ -0,0 +1,106 @@
+/*
+ * numberformat.cpp
+ * Copyright 2026, agent <agent@local>
+ *
+ * This file is part of libtiled.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE CONTRIBUTORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "numberformat.h"
+
+#include <QtNumeric>
+
+#include <cmath>
+#include <cstring>
+
+namespace Tiled {
+
+int formatNumber(char *buffer, double value)
+{
+    // Whole numbers are by far the most common, and don't need the floating
+    // point formatting below
+    if (value == std::floor(value) && std::fabs(value) < 1e15)
+        return formatInteger(buffer, static_cast<qint64>(value));
+
+    QByteArray formatted;
+
+    if (!qIsFinite(value)) {
+        formatted = QByteArray::number(value);
+    } else {
+        // Rounding to 15 significant digits reads back correctly for most
+        // values, and since trailing zeros are dropped it also gives the
+        // shortest representation in that case. Only few values need more.
+        for (int precision = 15; precision <= 17; ++precision) {
+            formatted = QByteArray::number(value, 'g', precision);
+            if (formatted.toDouble() == value)
+                break;
+        }
+    }
+
+    const int length = qMin(formatted.size(), NumberBufferSize);
+    std::memcpy(buffer, formatted.constData(), length);
+    return length;
+}
+
+int formatInteger(char *buffer, qint64 value)
+{
+    char digits[20];
+    int digitCount = 0;
+
+    quint64 magnitude = value < 0 ? 0 - static_cast<quint64>(value)
+                                  : static_cast<quint64>(value);
+    do {
+        digits[digitCount++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    int length = 0;
+    if (value < 0)
+        buffer[length++] = '-';
+    while (digitCount > 0)
+        buffer[length++] = digits[--digitCount];
+
+    return length;
+}
+
+/**
+ * Appends \a value to \a bytes, formatted by formatNumber().
+ */
+void appendNumber(QByteArray &bytes, double value)
+{
+    char buffer[NumberBufferSize];
+    const int length = formatNumber(buffer, value);
+    bytes.append(buffer, length);
+}
+
+/**
+ * Appends \a value to \a string, formatted by formatNumber().
+ */
+void appendNumber(QString &string, double value)
+{
+    char buffer[NumberBufferSize];
+    const int length = formatNumber(buffer, value);
+    string.append(QLatin1String(buffer, length));
+}
+
+} // namespace Tiled
@@ -0,0 +1,77 @@
+/*
+ * numberformat.h
+ * Copyright 2026, agent <agent@local>
+ *
+ * This file is part of libtiled.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE CONTRIBUTORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NUMBERFORMAT_H
+#define NUMBERFORMAT_H
+
+#include "tiled_global.h"
+
+#include <QByteArray>
+#include <QString>
+
+namespace Tiled {
+
+/**
+ * The size of a buffer that can hold any number formatted by formatNumber()
+ * or formatInteger().
+ */
+const int NumberBufferSize = 32;
+
+/**
+ * Writes the shortest representation of \a value that reads back as the
+ * same double to \a buffer, and returns the number of characters written.
+ * The buffer should have room for NumberBufferSize characters. It is not
+ * null-terminated.
+ *
+ * Whole numbers are written without a fraction or exponent. Unlike
+ * QString::number(), no precision is lost.
+ */
+TILEDSHARED_EXPORT int formatNumber(char *buffer, double value);
+
+/**
+ * Writes \a value in decimal notation to \a buffer, and returns the number of
+ * characters written. The buffer is not null-terminated.
+ */
+TILEDSHARED_EXPORT int formatInteger(char *buffer, qint64 value);
+
+TILEDSHARED_EXPORT void appendNumber(QByteArray &bytes, double value);
+TILEDSHARED_EXPORT void appendNumber(QString &string, double value);
+
+/**
+ * Convenience function that returns \a value formatted by formatNumber().
+ */
+inline QString numberToString(double value)
+{
+    QString string;
+    appendNumber(string, value);
+    return string;
+}
+
+} // namespace Tiled
+
+#endif // NUMBERFORMAT_H
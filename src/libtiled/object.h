@@ -68,14 +68,39 @@ public:
 
     /**
      * Returns the properties of this object.
+     *
+     * The properties are stored in a compact form, so this creates a new
+     * map. Use property() or hasProperty() to look up a single property, and
+     * propertyList() to go over all of them.
      */
-    const Properties &properties() const { return mProperties; }
+    Properties properties() const
+    { return mProperties.toProperties(); }
+
+    /**
+     * Returns the properties of this object in their compact form, which
+     * allows going over them without creating a map.
+     */
+    const PropertyList &propertyList() const
+    { return mProperties; }
 
     /**
      * Replaces all existing properties with a new set of properties.
      */
     void setProperties(const Properties &properties)
-    { mProperties = properties; }
+    { mProperties = PropertyList(properties); }
+
+    /**
+     * Replaces all existing properties with those of \a object. This shares
+     * the property storage instead of copying it.
+     */
+    void setProperties(const Object &object)
+    { mProperties = object.mProperties; }
+
+    /**
+     * Returns whether this object has any properties.
+     */
+    bool hasProperties() const
+    { return !mProperties.isEmpty(); }
 
     /**
      * Merges \a properties with the existing properties. Properties with the
@@ -121,7 +146,7 @@ public:
 
 private:
     TypeId mTypeId;
-    Properties mProperties;
+    PropertyList mProperties;
 };
 
 } // namespace Tiled
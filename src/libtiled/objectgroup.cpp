@@ -33,6 +33,8 @@
 #include "layer.h"
 #include "map.h"
 #include "mapobject.h"
+#include "maprenderer.h"
+#include "spatialindex.h"
 #include "tile.h"
 
 #include <cmath>
@@ -42,6 +44,9 @@ using namespace Tiled;
 ObjectGroup::ObjectGroup()
     : Layer(ObjectGroupType, QString(), 0, 0, 0, 0)
     , mDrawOrder(TopDownOrder)
+    , mFirstDirtyIndex(0)
+    , mObjectIndex(nullptr)
+    , mObjectIndexRenderer(nullptr)
 {
 }
 
@@ -49,37 +54,49 @@ ObjectGroup::ObjectGroup(const QString &name,
                          int x, int y, int width, int height)
     : Layer(ObjectGroupType, name, x, y, width, height)
     , mDrawOrder(TopDownOrder)
+    , mFirstDirtyIndex(0)
+    , mObjectIndex(nullptr)
+    , mObjectIndexRenderer(nullptr)
 {
 }
 
 ObjectGroup::~ObjectGroup()
 {
     qDeleteAll(mObjects);
+    delete mObjectIndex;
 }
 
 void ObjectGroup::addObject(MapObject *object)
 {
+    object->mIndex = mObjects.size();
+    if (mFirstDirtyIndex == object->mIndex)
+        ++mFirstDirtyIndex;
+
     mObjects.append(object);
     object->setObjectGroup(this);
     if (mMap && object->id() == 0)
         object->setId(mMap->takeNextObjectId());
+    objectGeometryChanged(object);
 }
 
 void ObjectGroup::insertObject(int index, MapObject *object)
 {
     mObjects.insert(index, object);
+    object->mIndex = index;
+    mFirstDirtyIndex = qMin(mFirstDirtyIndex, index + 1);
+
     object->setObjectGroup(this);
     if (mMap && object->id() == 0)
         object->setId(mMap->takeNextObjectId());
+    objectGeometryChanged(object);
 }
 
 int ObjectGroup::removeObject(MapObject *object)
 {
-    const int index = mObjects.indexOf(object);
+    const int index = indexOf(object);
     Q_ASSERT(index != -1);
 
-    mObjects.removeAt(index);
-    object->setObjectGroup(nullptr);
+    removeObjectAt(index);
     return index;
 }
 
@@ -87,6 +104,57 @@ void ObjectGroup::removeObjectAt(int index)
 {
     MapObject *object = mObjects.takeAt(index);
     object->setObjectGroup(nullptr);
+    mFirstDirtyIndex = qMin(mFirstDirtyIndex, index);
+
+    if (mObjectIndex) {
+        mObjectIndex->remove(object);
+        mObjectIndexPending.remove(object);
+    }
+}
+
+void ObjectGroup::removeObjects(const QList<MapObject*> &objects)
+{
+    // Detach the objects first, so they can be recognized in the list below
+    int removedCount = 0;
+    for (MapObject *object : objects) {
+        if (object->objectGroup() != this)
+            continue;
+
+        object->setObjectGroup(nullptr);
+        ++removedCount;
+
+        if (mObjectIndex) {
+            mObjectIndex->remove(object);
+            mObjectIndexPending.remove(object);
+        }
+    }
+
+    if (removedCount == 0)
+        return;
+
+    int count = 0;
+    for (int i = 0; i < mObjects.size(); ++i) {
+        MapObject *object = mObjects.at(i);
+        if (object->objectGroup() == this) {
+            object->mIndex = count;
+            mObjects[count++] = object;
+        }
+    }
+
+    mObjects.erase(mObjects.begin() + count, mObjects.end());
+    mFirstDirtyIndex = count;
+}
+
+void ObjectGroup::reorderObjects(const QList<MapObject*> &objects)
+{
+    Q_ASSERT(objects.size() == mObjects.size());
+
+    mObjects = objects;
+    for (int i = 0; i < mObjects.size(); ++i) {
+        Q_ASSERT(mObjects.at(i)->objectGroup() == this);
+        mObjects.at(i)->mIndex = i;
+    }
+    mFirstDirtyIndex = mObjects.size();
 }
 
 void ObjectGroup::moveObjects(int from, int to, int count)
@@ -100,6 +168,8 @@ void ObjectGroup::moveObjects(int from, int to, int count)
     if (to == from || to == from + count || count == 0)
         return;
 
+    mFirstDirtyIndex = qMin(mFirstDirtyIndex, qMin(from, to));
+
     const QList<MapObject*> movingObjects = mObjects.mid(from, count);
     mObjects.erase(mObjects.begin() + from,
                    mObjects.begin() + from + count);
@@ -111,6 +181,25 @@ void ObjectGroup::moveObjects(int from, int to, int count)
         mObjects.insert(to + i, movingObjects.at(i));
 }
 
+int ObjectGroup::indexOf(const MapObject *object) const
+{
+    if (object->objectGroup() != this)
+        return -1;
+
+    const int index = object->mIndex;
+    if (index >= 0 && index < mFirstDirtyIndex && mObjects.at(index) == object)
+        return index;
+
+    // Refresh the dirty part. When a supposedly valid index turned out to be
+    // wrong, the list was changed behind our back and we refresh everything.
+    const int first = index < mFirstDirtyIndex ? 0 : mFirstDirtyIndex;
+    for (int i = first; i < mObjects.size(); ++i)
+        mObjects.at(i)->mIndex = i;
+
+    mFirstDirtyIndex = mObjects.size();
+    return object->mIndex;
+}
+
 QRectF ObjectGroup::objectsBoundingRect() const
 {
     QRectF boundingRect;
@@ -119,6 +208,47 @@ QRectF ObjectGroup::objectsBoundingRect() const
     return boundingRect;
 }
 
+const SpatialIndex &ObjectGroup::objectIndex(const MapRenderer *renderer) const
+{
+    if (!mObjectIndex || mObjectIndexRenderer != renderer) {
+        if (!mObjectIndex)
+            mObjectIndex = new SpatialIndex;
+        else
+            mObjectIndex->clear();
+
+        mObjectIndexRenderer = renderer;
+        mObjectIndexPending.clear();
+
+        for (MapObject *object : mObjects)
+            mObjectIndex->insert(object, renderer->rotatedBoundingRect(object));
+
+    } else if (!mObjectIndexPending.isEmpty()) {
+        for (MapObject *object : mObjectIndexPending) {
+            mObjectIndex->remove(object);
+            mObjectIndex->insert(object, renderer->rotatedBoundingRect(object));
+        }
+
+        mObjectIndexPending.clear();
+    }
+
+    return *mObjectIndex;
+}
+
+void ObjectGroup::invalidateObjectIndex()
+{
+    mObjectIndexRenderer = nullptr;
+}
+
+/**
+ * Remembers the object for updating its bounds in the spatial index, which
+ * is done lazily since an object usually changes several times in a row.
+ */
+void ObjectGroup::objectGeometryChanged(MapObject *object)
+{
+    if (mObjectIndex)
+        mObjectIndexPending.insert(object);
+}
+
 bool ObjectGroup::isEmpty() const
 {
     return mObjects.isEmpty();
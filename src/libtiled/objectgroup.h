@@ -38,10 +38,13 @@
 #include <QColor>
 #include <QList>
 #include <QMetaType>
+#include <QSet>
 
 namespace Tiled {
 
 class MapObject;
+class MapRenderer;
+class SpatialIndex;
 
 /**
  * A group of objects on a map.
@@ -91,6 +94,17 @@ public:
      */
     MapObject *objectAt(int index) const { return mObjects.at(index); }
 
+    /**
+     * Returns the index of the given \a object in this object group, or -1
+     * when the object isn't part of this group.
+     *
+     * The index is cached on the object, so this is usually a constant-time
+     * lookup. Inserting, removing or moving objects only invalidates the
+     * cached indexes from the first affected position onwards, which are
+     * updated on the next lookup.
+     */
+    int indexOf(const MapObject *object) const;
+
     /**
      * Adds an object to this object group.
      */
@@ -121,6 +135,19 @@ public:
      */
     void removeObjectAt(int index);
 
+    /**
+     * Removes the given \a objects from this object group in a single pass.
+     * Objects that are not part of this group are ignored. Ownership of the
+     * removed objects is transferred to the caller.
+     */
+    void removeObjects(const QList<MapObject*> &objects);
+
+    /**
+     * Replaces the order of the objects in this group by the given list,
+     * which needs to contain exactly the objects already in this group.
+     */
+    void reorderObjects(const QList<MapObject*> &objects);
+
     /**
      * Moves \a count objects starting at \a from to the index given by \a to.
      *
@@ -134,6 +161,29 @@ public:
      */
     QRectF objectsBoundingRect() const;
 
+    /**
+     * Returns a spatial index of the objects in this group, using the
+     * rotated bounds in screen coordinates as given by \a renderer.
+     *
+     * The index is created on first use and kept up to date as objects are
+     * added, removed or changed. When another renderer is passed, or when
+     * the bounds may have changed for other reasons (like a change of the
+     * renderer settings or of tile sizes), the index is rebuilt.
+     *
+     * \sa invalidateObjectIndex(), MapRenderer::objectsAt()
+     */
+    const SpatialIndex &objectIndex(const MapRenderer *renderer) const;
+
+    /**
+     * Makes sure the spatial index is rebuilt the next time it is used.
+     */
+    void invalidateObjectIndex();
+
+    /**
+     * Called by MapObject when its bounds may have changed.
+     */
+    void objectGeometryChanged(MapObject *object);
+
     /**
      * Returns whether this object group contains any objects.
      */
@@ -192,9 +242,17 @@ protected:
     ObjectGroup *initializeClone(ObjectGroup *clone) const;
 
 private:
+    Q_DISABLE_COPY(ObjectGroup)
+
     QList<MapObject*> mObjects;
     QColor mColor;
     DrawOrder mDrawOrder;
+
+    mutable int mFirstDirtyIndex;   // objects from here on need reindexing
+
+    mutable SpatialIndex *mObjectIndex;
+    mutable const MapRenderer *mObjectIndexRenderer;
+    mutable QSet<MapObject*> mObjectIndexPending;
 };
 
 
@@ -34,6 +34,7 @@
 #include "tilelayer.h"
 #include "tileset.h"
 
+#include <QPainterPath>
 #include <QtCore/qmath.h>
 
 using namespace Tiled;
@@ -133,7 +134,8 @@ QPainterPath OrthogonalRenderer::shape(const MapObject *object) const
         case MapObject::Polygon:
         case MapObject::Polyline: {
             const QPointF &pos = object->position();
-            const QPolygonF polygon = object->polygon().translated(pos);
+            // Hit-testing at map resolution is accurate enough
+            const QPolygonF polygon = object->simplifiedPolygon(1).translated(pos);
             const QPolygonF screenPolygon = pixelToScreenCoords(polygon);
             if (object->shape() == MapObject::Polygon) {
                 path.addPolygon(screenPolygon);
@@ -316,21 +318,12 @@ void OrthogonalRenderer::drawMapObject(QPainter *painter,
                                      CellRenderer::BottomLeft);
 
         if (testFlag(ShowTileObjectOutlines)) {
-            const Tile *tile = cell.tile;
-            const QSize imgSize = tile->size();
-            const QPointF tileOffset = tile->offset();
-            QRectF rect(QPointF(tileOffset.x(),
-                                tileOffset.y() - imgSize.height()),
-                        imgSize);
-
-            QPen pen(Qt::SolidLine);
-            pen.setCosmetic(true);
-            painter->setPen(pen);
-            painter->drawRect(rect);
-            pen.setStyle(Qt::DotLine);
-            pen.setColor(color);
-            painter->setPen(pen);
-            painter->drawRect(rect);
+            const QRectF outline = tileObjectOutline(object);
+            if (!outline.isNull()) {
+                QPainterPath path;
+                path.addRect(outline.translated(-bounds.topLeft()));
+                drawTileObjectOutlines(painter, path, color);
+            }
         }
     } else {
         const qreal lineWidth = objectLineWidth();
@@ -375,7 +368,7 @@ void OrthogonalRenderer::drawMapObject(QPainter *painter,
         }
 
         case MapObject::Polyline: {
-            QPolygonF screenPolygon = pixelToScreenCoords(object->polygon());
+            QPolygonF screenPolygon = pixelToScreenCoords(object->simplifiedPolygon(painterScale()));
 
             QPen thickShadowPen(shadowPen);
             QPen thickLinePen(linePen);
@@ -396,7 +389,7 @@ void OrthogonalRenderer::drawMapObject(QPainter *painter,
         }
 
         case MapObject::Polygon: {
-            QPolygonF screenPolygon = pixelToScreenCoords(object->polygon());
+            QPolygonF screenPolygon = pixelToScreenCoords(object->simplifiedPolygon(painterScale()));
 
             QPen thickShadowPen(shadowPen);
             QPen thickLinePen(linePen);
@@ -435,6 +428,21 @@ void OrthogonalRenderer::drawMapObject(QPainter *painter,
     painter->restore();
 }
 
+QRectF OrthogonalRenderer::tileObjectOutline(const MapObject *object) const
+{
+    const Tile *tile = object->cell().tile;
+    if (!tile || !isOutlineVisible(object->size()))
+        return QRectF();
+
+    const QSize imgSize = tile->size();
+    const QPointF tileOffset = tile->offset();
+    const QPointF topLeft = object->bounds().topLeft();
+
+    return QRectF(QPointF(topLeft.x() + tileOffset.x(),
+                          topLeft.y() + tileOffset.y() - imgSize.height()),
+                  imgSize);
+}
+
 QPointF OrthogonalRenderer::pixelToTileCoords(qreal x, qreal y) const
 {
     return QPointF(x / map()->tileWidth(),
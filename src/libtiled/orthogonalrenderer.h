@@ -64,6 +64,8 @@ public:
                        const MapObject *object,
                        const QColor &color) const override;
 
+    QRectF tileObjectOutline(const MapObject *object) const override;
+
     using MapRenderer::pixelToTileCoords;
     QPointF pixelToTileCoords(qreal x, qreal y) const override;
 
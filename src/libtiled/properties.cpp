@@ -29,6 +29,10 @@
 #include "properties.h"
 
 #include <QColor>
+#include <QMutex>
+#include <QSet>
+
+#include <algorithm>
 
 namespace Tiled {
 
@@ -43,6 +47,108 @@ void Properties::merge(const Properties &other)
     }
 }
 
+PropertyList::PropertyList(const Properties &properties)
+{
+    mEntries.reserve(properties.size());
+
+    // The map is already sorted by name
+    Properties::const_iterator it = properties.constBegin();
+    const Properties::const_iterator it_end = properties.constEnd();
+    for (; it != it_end; ++it) {
+        const Entry entry = { internPropertyName(it.key()), it.value() };
+        mEntries.append(entry);
+    }
+}
+
+Properties PropertyList::toProperties() const
+{
+    Properties properties;
+    for (const Entry &entry : mEntries)
+        properties.insert(properties.constEnd(), entry.name, entry.value);
+    return properties;
+}
+
+QVariant PropertyList::value(const QString &name) const
+{
+    const int index = lowerBound(name);
+    if (index < mEntries.size() && mEntries.at(index).name == name)
+        return mEntries.at(index).value;
+    return QVariant();
+}
+
+bool PropertyList::contains(const QString &name) const
+{
+    const int index = lowerBound(name);
+    return index < mEntries.size() && mEntries.at(index).name == name;
+}
+
+void PropertyList::insert(const QString &name, const QVariant &value)
+{
+    const int index = lowerBound(name);
+    if (index < mEntries.size() && mEntries.at(index).name == name) {
+        mEntries[index].value = value;
+    } else {
+        const Entry entry = { internPropertyName(name), value };
+        mEntries.insert(index, entry);
+    }
+}
+
+void PropertyList::remove(const QString &name)
+{
+    const int index = lowerBound(name);
+    if (index < mEntries.size() && mEntries.at(index).name == name)
+        mEntries.remove(index);
+}
+
+void PropertyList::merge(const Properties &properties)
+{
+    Properties::const_iterator it = properties.constBegin();
+    const Properties::const_iterator it_end = properties.constEnd();
+    for (; it != it_end; ++it)
+        insert(it.key(), it.value());
+}
+
+bool PropertyList::operator==(const PropertyList &other) const
+{
+    return mEntries == other.mEntries;
+}
+
+/**
+ * Returns the index of the first entry with a name that is not smaller than
+ * \a name.
+ */
+int PropertyList::lowerBound(const QString &name) const
+{
+    const auto it = std::lower_bound(mEntries.constBegin(),
+                                     mEntries.constEnd(),
+                                     name,
+                                     [] (const Entry &entry, const QString &key) {
+        return entry.name < key;
+    });
+    return it - mEntries.constBegin();
+}
+
+/**
+ * Returns a shared copy of the given property \a name, so that objects using
+ * the same property names don't each store their own copy of them.
+ *
+ * This function is thread-safe.
+ */
+QString internPropertyName(const QString &name)
+{
+    static QMutex mutex;
+    static QSet<QString> names;
+
+    QMutexLocker locker(&mutex);
+
+    const auto it = names.constFind(name);
+    if (it != names.constEnd())
+        return *it;
+
+    names.insert(name);
+    return name;
+}
+
 void AggregatedProperties::aggregate(const Properties &properties)
 {
     auto it = properties.constEnd();
@@ -62,6 +168,19 @@ void AggregatedProperties::aggregate(const Properties &properties)
     ++mAggregatedCount;
 }
 
+void AggregatedProperties::aggregate(const PropertyList &properties)
+{
+    for (int i = 0; i < properties.size(); ++i) {
+        auto pit = find(properties.nameAt(i));
+        if (pit != end())
+            pit.value().aggregate(properties.valueAt(i));
+        else
+            insert(properties.nameAt(i), AggregatedPropertyData(properties.valueAt(i)));
+    }
+
+    ++mAggregatedCount;
+}
+
 QString typeToName(int type)
 {
     switch (type) {
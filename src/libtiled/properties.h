@@ -34,6 +34,7 @@
 #include <QMap>
 #include <QString>
 #include <QVariant>
+#include <QVector>
 
 namespace Tiled {
 
@@ -50,6 +51,54 @@ public:
     void merge(const Properties &other);
 };
 
+/**
+ * A compact list of properties, sorted by name. This is how an Object stores
+ * its properties.
+ *
+ * Many objects tend to share the same few property names, so the names are
+ * interned and each one is stored only once. The list itself is implicitly
+ * shared, which makes copying it when cloning objects cheap.
+ */
+class TILEDSHARED_EXPORT PropertyList
+{
+public:
+    PropertyList() {}
+    explicit PropertyList(const Properties &properties);
+
+    Properties toProperties() const;
+
+    bool isEmpty() const { return mEntries.isEmpty(); }
+    int size() const { return mEntries.size(); }
+
+    const QString &nameAt(int index) const { return mEntries.at(index).name; }
+    const QVariant &valueAt(int index) const { return mEntries.at(index).value; }
+
+    QVariant value(const QString &name) const;
+    bool contains(const QString &name) const;
+
+    void insert(const QString &name, const QVariant &value);
+    void remove(const QString &name);
+    void merge(const Properties &properties);
+
+    bool operator==(const PropertyList &other) const;
+    bool operator!=(const PropertyList &other) const
+    { return !(*this == other); }
+
+private:
+    struct Entry
+    {
+        QString name;
+        QVariant value;
+
+        bool operator==(const Entry &other) const
+        { return name == other.name && value == other.value; }
+    };
+
+    int lowerBound(const QString &name) const;
+
+    QVector<Entry> mEntries;
+};
+
 class TILEDSHARED_EXPORT AggregatedPropertyData
 {
 public:
@@ -94,14 +143,21 @@ private:
 class TILEDSHARED_EXPORT AggregatedProperties : public QMap<QString, AggregatedPropertyData>
 {
 public:
+    AggregatedProperties()
+        : mAggregatedCount(0)
+    {}
+
     void aggregate(const Properties &properties);
-    int aggregatedCount() { return mAggregatedCount; }
+    void aggregate(const PropertyList &properties);
+    int aggregatedCount() const { return mAggregatedCount; }
 
 private:
     int mAggregatedCount;
 };
 
 
+TILEDSHARED_EXPORT QString internPropertyName(const QString &name);
+
 TILEDSHARED_EXPORT int filePathTypeId();
 
 TILEDSHARED_EXPORT QString typeToName(int type);
@@ -0,0 +1,118 @@
+/*
+ * regionbuilder.cpp
+ * Copyright 2026, agent <agent@local>
+ *
+ * This file is part of libtiled.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE CONTRIBUTORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "regionbuilder.h"
+
+#include <algorithm>
+
+using namespace Tiled;
+
+/**
+ * Returns the region covered by all added spans.
+ *
+ * The rectangles are emitted in the same banded form QRegion produces
+ * itself: sorted by top and left, with vertically adjacent rows that have
+ * identical spans merged into a single band. This makes the result compare
+ * equal to a region that was built by uniting the spans one by one.
+ */
+QRegion RegionBuilder::region() const
+{
+    if (mSpans.isEmpty())
+        return QRegion();
+
+    QVector<Span> spans = mSpans;
+    if (!mSorted) {
+        std::sort(spans.begin(), spans.end(), [] (const Span &a, const Span &b) {
+            return a.y < b.y || (a.y == b.y && a.left < b.left);
+        });
+    }
+
+    // Merge overlapping and touching spans on the same row
+    int count = 0;
+    for (const Span &span : spans) {
+        if (count > 0) {
+            Span &previous = spans[count - 1];
+            if (previous.y == span.y && span.left <= previous.right + 1) {
+                previous.right = std::max(previous.right, span.right);
+                continue;
+            }
+        }
+        spans[count++] = span;
+    }
+
+    QVector<QRect> rects;
+    rects.reserve(count);
+
+    // The band currently being extended downwards, as a range of spans
+    int bandStart = 0;
+    int bandEnd = 0;
+    int bandHeight = 0;
+
+    auto flushBand = [&] () {
+        for (int i = bandStart; i < bandEnd; ++i) {
+            const Span &span = spans.at(i);
+            rects.append(QRect(span.left, span.y,
+                               span.right - span.left + 1, bandHeight));
+        }
+    };
+
+    int rowStart = 0;
+    while (rowStart < count) {
+        const int y = spans.at(rowStart).y;
+        int rowEnd = rowStart + 1;
+        while (rowEnd < count && spans.at(rowEnd).y == y)
+            ++rowEnd;
+
+        bool extendsBand = bandHeight > 0 &&
+                spans.at(bandStart).y + bandHeight == y &&
+                rowEnd - rowStart == bandEnd - bandStart;
+
+        for (int i = 0; extendsBand && i < rowEnd - rowStart; ++i) {
+            const Span &a = spans.at(bandStart + i);
+            const Span &b = spans.at(rowStart + i);
+            extendsBand = a.left == b.left && a.right == b.right;
+        }
+
+        if (extendsBand) {
+            ++bandHeight;
+        } else {
+            flushBand();
+            bandStart = rowStart;
+            bandEnd = rowEnd;
+            bandHeight = 1;
+        }
+
+        rowStart = rowEnd;
+    }
+
+    flushBand();
+
+    QRegion region;
+    region.setRects(rects.constData(), rects.size());
+    return region;
+}
@@ -0,0 +1,118 @@
+/*
+ * regionbuilder.h
+ * Copyright 2026, agent <agent@local>
+ *
+ * This file is part of libtiled.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE CONTRIBUTORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TILED_REGIONBUILDER_H
+#define TILED_REGIONBUILDER_H
+
+#include "tiled_global.h"
+
+#include <QRegion>
+#include <QVector>
+
+namespace Tiled {
+
+/**
+ * Collects horizontal spans of cells and turns them into a QRegion in one
+ * step.
+ *
+ * Uniting a QRegion with one rectangle at a time gets slower as the region
+ * grows, which makes building large regions quadratic. This class instead
+ * sorts the spans by row, coalesces them into bands and hands the resulting
+ * rectangles to QRegion::setRects().
+ *
+ * Spans may be added in any order and may overlap.
+ */
+class TILEDSHARED_EXPORT RegionBuilder
+{
+public:
+    RegionBuilder();
+
+    void reserve(int spanCount);
+    void clear();
+    bool isEmpty() const;
+
+    void addSpan(int left, int right, int y);
+
+    QRegion region() const;
+
+private:
+    struct Span
+    {
+        int y;
+        int left;
+        int right;
+    };
+
+    QVector<Span> mSpans;
+    bool mSorted;
+};
+
+
+inline RegionBuilder::RegionBuilder()
+    : mSorted(true)
+{
+}
+
+inline void RegionBuilder::reserve(int spanCount)
+{
+    mSpans.reserve(spanCount);
+}
+
+/**
+ * Removes all spans, so that the builder can be reused.
+ */
+inline void RegionBuilder::clear()
+{
+    mSpans.clear();
+    mSorted = true;
+}
+
+inline bool RegionBuilder::isEmpty() const
+{
+    return mSpans.isEmpty();
+}
+
+/**
+ * Adds the cells from \a left to \a right (inclusive) on row \a y.
+ */
+inline void RegionBuilder::addSpan(int left, int right, int y)
+{
+    Q_ASSERT(left <= right);
+
+    if (mSorted && !mSpans.isEmpty()) {
+        const Span &last = mSpans.last();
+        if (y < last.y || (y == last.y && left < last.left))
+            mSorted = false;
+    }
+
+    mSpans.append(Span { y, left, right });
+}
+
+} // namespace Tiled
+
+#endif // TILED_REGIONBUILDER_H
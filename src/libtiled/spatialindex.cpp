@@ -0,0 +1,433 @@
+/*
+ * spatialindex.cpp
+ * Copyright 2026, agent <agent@local>
+ *
+ * This file is part of libtiled.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE CONTRIBUTORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "spatialindex.h"
+
+#include <limits>
+
+using namespace Tiled;
+
+namespace {
+
+const int maxEntries = 16;
+const int minEntries = 6;
+
+/**
+ * Like QRectF::intersects, but also true for touching rectangles and for
+ * rectangles without area.
+ */
+inline bool overlaps(const QRectF &a, const QRectF &b)
+{
+    return a.left() <= b.right() && b.left() <= a.right() &&
+            a.top() <= b.bottom() && b.top() <= a.bottom();
+}
+
+/**
+ * Like QRectF::united, but without ignoring rectangles without area.
+ */
+inline QRectF unite(const QRectF &a, const QRectF &b)
+{
+    return QRectF(QPointF(qMin(a.left(), b.left()),
+                          qMin(a.top(), b.top())),
+                  QPointF(qMax(a.right(), b.right()),
+                          qMax(a.bottom(), b.bottom())));
+}
+
+inline qreal area(const QRectF &rect)
+{
+    return rect.width() * rect.height();
+}
+
+} // anonymous namespace
+
+
+struct SpatialIndex::Node
+{
+    Node(Node *parent, bool leaf)
+        : parent(parent)
+        , leaf(leaf)
+    {}
+
+    int indexInParent() const
+    {
+        const QVector<Entry> &siblings = parent->entries;
+        for (int i = 0; i < siblings.size(); ++i)
+            if (siblings.at(i).child == this)
+                return i;
+
+        Q_ASSERT(false);
+        return -1;
+    }
+
+    Node *parent;
+    bool leaf;
+    QVector<Entry> entries;
+};
+
+
+SpatialIndex::SpatialIndex()
+    : mRoot(new Node(nullptr, true))
+{
+}
+
+SpatialIndex::~SpatialIndex()
+{
+    deleteNode(mRoot);
+}
+
+/**
+ * Inserts the given \a object with the given \a bounds. The object should
+ * not already be part of the index.
+ */
+void SpatialIndex::insert(MapObject *object, const QRectF &bounds)
+{
+    Q_ASSERT(!mLeaves.contains(object));
+
+    const Entry entry = { bounds.normalized(), nullptr, object };
+    insertEntry(entry);
+}
+
+/**
+ * Removes the given \a object from the index. Returns whether the object was
+ * found.
+ */
+bool SpatialIndex::remove(MapObject *object)
+{
+    Node *leaf = mLeaves.take(object);
+    if (!leaf)
+        return false;
+
+    QVector<Entry> &entries = leaf->entries;
+    for (int i = 0; i < entries.size(); ++i) {
+        if (entries.at(i).object == object) {
+            entries.remove(i);
+            break;
+        }
+    }
+
+    condenseTree(leaf);
+    return true;
+}
+
+void SpatialIndex::clear()
+{
+    deleteNode(mRoot);
+    mRoot = new Node(nullptr, true);
+    mLeaves.clear();
+}
+
+/**
+ * Returns the bounding rectangle of all objects in the index.
+ */
+QRectF SpatialIndex::bounds() const
+{
+    return entriesBounds(mRoot->entries);
+}
+
+/**
+ * Returns the objects whose bounds intersect or touch the given \a rect, in
+ * no particular order.
+ */
+QVector<MapObject*> SpatialIndex::intersecting(const QRectF &rect) const
+{
+    const QRectF area = rect.normalized();
+
+    QVector<MapObject*> objects;
+    QVector<const Node*> pending;
+    pending.append(mRoot);
+
+    while (!pending.isEmpty()) {
+        const Node *node = pending.takeLast();
+
+        for (const Entry &entry : node->entries) {
+            if (!overlaps(entry.bounds, area))
+                continue;
+
+            if (node->leaf)
+                objects.append(entry.object);
+            else
+                pending.append(entry.child);
+        }
+    }
+
+    return objects;
+}
+
+QRectF SpatialIndex::entriesBounds(const QVector<Entry> &entries)
+{
+    if (entries.isEmpty())
+        return QRectF();
+
+    QRectF bounds = entries.first().bounds;
+    for (int i = 1; i < entries.size(); ++i)
+        bounds = unite(bounds, entries.at(i).bounds);
+    return bounds;
+}
+
+void SpatialIndex::insertEntry(const Entry &entry)
+{
+    Node *leaf = chooseLeaf(entry.bounds);
+    leaf->entries.append(entry);
+    mLeaves.insert(entry.object, leaf);
+
+    Node *sibling = nullptr;
+    if (leaf->entries.size() > maxEntries)
+        sibling = split(leaf);
+
+    adjustTree(leaf, sibling);
+}
+
+/**
+ * Descends the tree, each time choosing the entry that needs the least
+ * enlargement to include the given \a bounds.
+ */
+SpatialIndex::Node *SpatialIndex::chooseLeaf(const QRectF &bounds) const
+{
+    Node *node = mRoot;
+
+    while (!node->leaf) {
+        const Entry *best = nullptr;
+        qreal bestEnlargement = 0;
+        qreal bestArea = 0;
+
+        for (const Entry &entry : node->entries) {
+            const qreal entryArea = area(entry.bounds);
+            const qreal enlargement = area(unite(entry.bounds, bounds)) - entryArea;
+
+            if (!best || enlargement < bestEnlargement ||
+                    (enlargement == bestEnlargement && entryArea < bestArea)) {
+                best = &entry;
+                bestEnlargement = enlargement;
+                bestArea = entryArea;
+            }
+        }
+
+        node = best->child;
+    }
+
+    return node;
+}
+
+/**
+ * Splits the entries of the given overflowing \a node over the node and a
+ * new sibling, using the quadratic split algorithm. Returns the sibling,
+ * which still needs to be added to the parent.
+ */
+SpatialIndex::Node *SpatialIndex::split(Node *node)
+{
+    QVector<Entry> entries;
+    entries.swap(node->entries);
+
+    Node *sibling = new Node(node->parent, node->leaf);
+
+    // Start with the two entries that would waste the most area when put
+    // in the same node
+    int seedA = 0;
+    int seedB = 1;
+    qreal worstWaste = -std::numeric_limits<qreal>::max();
+
+    for (int i = 0; i < entries.size(); ++i) {
+        for (int j = i + 1; j < entries.size(); ++j) {
+            const QRectF &a = entries.at(i).bounds;
+            const QRectF &b = entries.at(j).bounds;
+            const qreal waste = area(unite(a, b)) - area(a) - area(b);
+            if (waste > worstWaste) {
+                worstWaste = waste;
+                seedA = i;
+                seedB = j;
+            }
+        }
+    }
+
+    QRectF boundsA = entries.at(seedA).bounds;
+    QRectF boundsB = entries.at(seedB).bounds;
+    node->entries.append(entries.at(seedA));
+    sibling->entries.append(entries.at(seedB));
+    entries.remove(seedB);  // seedB > seedA
+    entries.remove(seedA);
+
+    while (!entries.isEmpty()) {
+        // Make sure both nodes end up with the minimum amount of entries
+        if (node->entries.size() + entries.size() == minEntries) {
+            node->entries += entries;
+            break;
+        }
+        if (sibling->entries.size() + entries.size() == minEntries) {
+            sibling->entries += entries;
+            break;
+        }
+
+        // Assign the entry with the strongest preference for either node
+        int next = 0;
+        qreal nextGrowthA = 0;
+        qreal nextGrowthB = 0;
+        qreal strongestPreference = -1;
+
+        for (int i = 0; i < entries.size(); ++i) {
+            const QRectF &bounds = entries.at(i).bounds;
+            const qreal growthA = area(unite(boundsA, bounds)) - area(boundsA);
+            const qreal growthB = area(unite(boundsB, bounds)) - area(boundsB);
+            const qreal preference = qAbs(growthA - growthB);
+            if (preference > strongestPreference) {
+                strongestPreference = preference;
+                next = i;
+                nextGrowthA = growthA;
+                nextGrowthB = growthB;
+            }
+        }
+
+        const Entry entry = entries.at(next);
+        entries.remove(next);
+
+        bool toA;
+        if (nextGrowthA != nextGrowthB)
+            toA = nextGrowthA < nextGrowthB;
+        else if (area(boundsA) != area(boundsB))
+            toA = area(boundsA) < area(boundsB);
+        else
+            toA = node->entries.size() <= sibling->entries.size();
+
+        if (toA) {
+            node->entries.append(entry);
+            boundsA = unite(boundsA, entry.bounds);
+        } else {
+            sibling->entries.append(entry);
+            boundsB = unite(boundsB, entry.bounds);
+        }
+    }
+
+    // Update the references to the entries that moved to the sibling
+    for (const Entry &entry : sibling->entries) {
+        if (sibling->leaf)
+            mLeaves.insert(entry.object, sibling);
+        else
+            entry.child->parent = sibling;
+    }
+
+    return sibling;
+}
+
+/**
+ * Walks up from the given \a node, updating the bounds stored in its
+ * ancestors and adding the \a sibling resulting from a split, splitting
+ * further nodes as necessary.
+ */
+void SpatialIndex::adjustTree(Node *node, Node *sibling)
+{
+    while (node != mRoot) {
+        Node *parent = node->parent;
+        parent->entries[node->indexInParent()].bounds = entriesBounds(node->entries);
+
+        if (sibling) {
+            const Entry entry = { entriesBounds(sibling->entries), sibling, nullptr };
+            sibling->parent = parent;
+            parent->entries.append(entry);
+
+            sibling = nullptr;
+            if (parent->entries.size() > maxEntries)
+                sibling = split(parent);
+        }
+
+        node = parent;
+    }
+
+    if (sibling) {
+        // The root was split, so the tree grows by one level
+        Node *root = new Node(nullptr, false);
+        const Entry a = { entriesBounds(mRoot->entries), mRoot, nullptr };
+        const Entry b = { entriesBounds(sibling->entries), sibling, nullptr };
+        root->entries.append(a);
+        root->entries.append(b);
+        mRoot->parent = root;
+        sibling->parent = root;
+        mRoot = root;
+    }
+}
+
+/**
+ * Walks up from the given \a node after an entry was removed from it,
+ * dissolving nodes that have too few entries left and updating the bounds
+ * stored in the ancestors. The objects of dissolved nodes are re-inserted.
+ */
+void SpatialIndex::condenseTree(Node *node)
+{
+    QVector<Entry> orphans;
+
+    while (node != mRoot) {
+        Node *parent = node->parent;
+        const int index = node->indexInParent();
+
+        if (node->entries.size() < minEntries) {
+            parent->entries.remove(index);
+            takeLeafEntries(node, orphans);
+        } else {
+            parent->entries[index].bounds = entriesBounds(node->entries);
+        }
+
+        node = parent;
+    }
+
+    // Remove unnecessary levels at the top of the tree
+    while (!mRoot->leaf && mRoot->entries.size() == 1) {
+        Node *child = mRoot->entries.first().child;
+        child->parent = nullptr;
+        delete mRoot;
+        mRoot = child;
+    }
+
+    if (!mRoot->leaf && mRoot->entries.isEmpty())
+        mRoot->leaf = true;
+
+    for (const Entry &entry : orphans)
+        insertEntry(entry);
+}
+
+/**
+ * Moves the entries of all leaves under the given \a node to \a entries and
+ * deletes the node.
+ */
+void SpatialIndex::takeLeafEntries(Node *node, QVector<Entry> &entries)
+{
+    if (node->leaf) {
+        entries += node->entries;
+    } else {
+        for (const Entry &entry : node->entries)
+            takeLeafEntries(entry.child, entries);
+    }
+
+    delete node;
+}
+
+void SpatialIndex::deleteNode(Node *node)
+{
+    if (!node->leaf)
+        for (const Entry &entry : node->entries)
+            deleteNode(entry.child);
+
+    delete node;
+}
@@ -0,0 +1,115 @@
+/*
+ * spatialindex.h
+ * Copyright 2026, agent <agent@local>
+ *
+ * This file is part of libtiled.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE CONTRIBUTORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include "tiled_global.h"
+
+#include <QHash>
+#include <QRectF>
+#include <QVector>
+
+namespace Tiled {
+
+class MapObject;
+
+/**
+ * An R-tree that stores map objects by their bounding rectangle, allowing to
+ * quickly find the objects intersecting a given area.
+ *
+ * The index does not look at the objects themselves. It is up to the owner to
+ * update the bounds of an object by removing and re-inserting it when the
+ * object changes.
+ *
+ * Unlike QRectF::intersects(), rectangles without area, like those of point
+ * objects, are handled as well.
+ */
+class TILEDSHARED_EXPORT SpatialIndex
+{
+public:
+    SpatialIndex();
+    ~SpatialIndex();
+
+    void insert(MapObject *object, const QRectF &bounds);
+    bool remove(MapObject *object);
+    void clear();
+
+    bool contains(MapObject *object) const;
+    int size() const;
+    bool isEmpty() const;
+
+    QRectF bounds() const;
+
+    QVector<MapObject*> intersecting(const QRectF &rect) const;
+
+private:
+    Q_DISABLE_COPY(SpatialIndex)
+
+    struct Node;
+
+    struct Entry
+    {
+        QRectF bounds;
+        Node *child;            // set for entries of inner nodes
+        MapObject *object;      // set for entries of leaf nodes
+    };
+
+    static QRectF entriesBounds(const QVector<Entry> &entries);
+
+    void insertEntry(const Entry &entry);
+    Node *chooseLeaf(const QRectF &bounds) const;
+    Node *split(Node *node);
+    void adjustTree(Node *node, Node *sibling);
+    void condenseTree(Node *node);
+    void takeLeafEntries(Node *node, QVector<Entry> &entries);
+    void deleteNode(Node *node);
+
+    Node *mRoot;
+    QHash<MapObject*, Node*> mLeaves;
+};
+
+
+inline bool SpatialIndex::contains(MapObject *object) const
+{
+    return mLeaves.contains(object);
+}
+
+inline int SpatialIndex::size() const
+{
+    return mLeaves.size();
+}
+
+inline bool SpatialIndex::isEmpty() const
+{
+    return mLeaves.isEmpty();
+}
+
+} // namespace Tiled
+
+#endif // SPATIALINDEX_H
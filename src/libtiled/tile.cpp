@@ -69,6 +69,43 @@ QSharedPointer<Tileset> Tile::sharedTileset() const
     return mTileset->sharedPointer();
 }
 
+/**
+ * Returns the image of this tile.
+ *
+ * When the tileset image has not been decoded yet, this decodes it.
+ */
+const QPixmap &Tile::image() const
+{
+    if (mTileset->isImageLoadPending())
+        mTileset->loadPendingImage();
+
+    return mImage;
+}
+
+/**
+ * Returns the size of this tile. Does not require the tileset image to be
+ * decoded.
+ */
+QSize Tile::size() const
+{
+    if (mTileset->isImageLoadPending())
+        return mTileset->tileSize();
+
+    return mImage.size();
+}
+
+/**
+ * Returns whether the image referenced by this tile was loaded. When the
+ * tileset image has not been decoded yet, this decodes it to find out.
+ */
+bool Tile::imageLoaded() const
+{
+    if (mTileset->isImageLoadPending())
+        mTileset->loadPendingImage();
+
+    return !mImage.isNull();
+}
+
 /**
  * Returns the image for rendering this tile, taking into account tile
  * animations.
@@ -79,7 +116,7 @@ const QPixmap &Tile::currentFrameImage() const
         const Frame &frame = mFrames.at(mCurrentFrameIndex);
         return mTileset->findTile(frame.tileId)->image();
     } else {
-        return mImage;
+        return image();
     }
 }
 
@@ -172,14 +172,6 @@ inline Tileset *Tile::tileset() const
     return mTileset;
 }
 
-/**
- * Returns the image of this tile.
- */
-inline const QPixmap &Tile::image() const
-{
-    return mImage;
-}
-
 /**
  * Sets the image of this tile.
  */
@@ -208,7 +200,7 @@ inline void Tile::setImageSource(const QString &imageSource)
  */
 inline int Tile::width() const
 {
-    return mImage.width();
+    return size().width();
 }
 
 /**
@@ -216,15 +208,7 @@ inline int Tile::width() const
  */
 inline int Tile::height() const
 {
-    return mImage.height();
-}
-
-/**
- * Returns the size of this tile.
- */
-inline QSize Tile::size() const
-{
-    return mImage.size();
+    return size().height();
 }
 
 /**
@@ -291,14 +275,6 @@ inline int Tile::currentFrameIndex() const
     return mCurrentFrameIndex;
 }
 
-/**
- * Returns whether the image referenced by this tile was loaded.
- */
-inline bool Tile::imageLoaded() const
-{
-    return !mImage.isNull();
-}
-
 } // namespace Tiled
 
 #endif // TILE_H
@@ -84,25 +84,16 @@ QMargins TileLayer::drawMargins() const
 
 QRegion TileLayer::region(std::function<bool (const Cell &)> condition) const
 {
-    QRegion region;
+    return region<std::function<bool (const Cell &)>>(condition);
+}
 
-    for (int y = 0; y < mHeight; ++y) {
-        for (int x = 0; x < mWidth; ++x) {
-            if (condition(cellAt(x, y))) {
-                const int rangeStart = x;
-                for (++x; x <= mWidth; ++x) {
-                    if (x == mWidth || !condition(cellAt(x, y))) {
-                        const int rangeEnd = x;
-                        region += QRect(rangeStart + mX, y + mY,
-                                        rangeEnd - rangeStart, 1);
-                        break;
-                    }
-                }
-            }
-        }
-    }
+QRegion TileLayer::region() const
+{
+    // A layer that doesn't reference any tilesets can't contain any tiles
+    if (hasNoTiles())
+        return QRegion();
 
-    return region;
+    return region([] (const Cell &cell) { return !cell.isEmpty(); });
 }
 
 /**
@@ -431,6 +422,9 @@ QRegion TileLayer::computeDiffRegion(const TileLayer *other) const
 
 bool TileLayer::isEmpty() const
 {
+    if (hasNoTiles())
+        return true;
+
     for (const Cell &cell : mGrid)
         if (!cell.isEmpty())
             return false;
@@ -33,6 +33,7 @@
 #include "tiled_global.h"
 
 #include "layer.h"
+#include "regionbuilder.h"
 #include "tiled.h"
 
 #include <QMargins>
@@ -116,6 +117,13 @@ public:
      */
     QRegion region(std::function<bool (const Cell &)> condition) const;
 
+    /**
+     * Overload of the above that allows the \a condition to be inlined,
+     * which is considerably faster for large layers.
+     */
+    template<typename Condition>
+    QRegion region(Condition condition) const;
+
     /**
      * Calculates the region occupied by the tiles of this layer. Similar to
      * Layer::bounds(), but leaves out the regions without tiles.
@@ -243,6 +251,8 @@ protected:
     TileLayer *initializeClone(TileLayer *clone) const;
 
 private:
+    bool hasNoTiles() const;
+
     QVector<Cell> mGrid;
     mutable QSet<SharedTileset> mUsedTilesets;
     mutable bool mUsedTilesetsDirty;
@@ -262,9 +272,38 @@ inline bool TileLayer::contains(const QPoint &point) const
     return contains(point.x(), point.y());
 }
 
-inline QRegion TileLayer::region() const
+/**
+ * Returns true when the set of used tilesets is known to be empty, which
+ * means this layer has no tiles without having to look at every cell.
+ */
+inline bool TileLayer::hasNoTiles() const
 {
-    return region([] (const Cell &cell) { return !cell.isEmpty(); });
+    return !mUsedTilesetsDirty && mUsedTilesets.isEmpty();
+}
+
+template<typename Condition>
+QRegion TileLayer::region(Condition condition) const
+{
+    RegionBuilder builder;
+    const Cell *row = mGrid.constData();
+
+    for (int y = 0; y < mHeight; ++y, row += mWidth) {
+        int x = 0;
+        while (x < mWidth) {
+            if (!condition(row[x])) {
+                ++x;
+                continue;
+            }
+
+            const int rangeStart = x;
+            for (++x; x < mWidth && condition(row[x]); ++x)
+                ;
+
+            builder.addSpan(rangeStart + mX, x - 1 + mX, y + mY);
+        }
+    }
+
+    return builder.region();
 }
 
 /**
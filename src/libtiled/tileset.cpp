@@ -48,7 +48,9 @@ Tileset::Tileset(QString name, int tileWidth, int tileHeight,
     mExpectedRowCount(0),
     mNextTileId(0),
     mTerrainDistancesDirty(false),
-    mLoaded(true)
+    mLoaded(true),
+    mImageLoadPending(false),
+    mTerrainIndexDirty(true)
 {
     Q_ASSERT(tileSpacing >= 0);
     Q_ASSERT(margin >= 0);
@@ -102,6 +104,7 @@ Tile *Tileset::findOrCreateTile(int id)
         return tile;
 
     mNextTileId = std::max(mNextTileId, id + 1);
+    mTerrainIndexDirty = true;
     return mTiles[id] = new Tile(id, this);
 }
 
@@ -160,6 +163,7 @@ bool Tileset::loadFromImage(const QImage &image,
 
     if (image.isNull()) {
         mImageReference.loaded = false;
+        mImageLoadPending.storeRelease(false);
         return false;
     }
 
@@ -188,8 +192,10 @@ bool Tileset::loadFromImage(const QImage &image,
             auto it = mTiles.find(tileNum);
             if (it != mTiles.end())
                 it.value()->setImage(tilePixmap);
-            else
+            else {
                 mTiles.insert(tileNum, new Tile(tilePixmap, tileNum, this));
+                mTerrainIndexDirty = true;
+            }
 
             ++tileNum;
         }
@@ -210,6 +216,9 @@ bool Tileset::loadFromImage(const QImage &image,
     mColumnCount = columnCountForWidth(mImageReference.size.width());
     mImageReference.loaded = true;
 
+    // Only now may other threads use the tile images without locking
+    mImageLoadPending.storeRelease(false);
+
     return true;
 }
 
@@ -224,6 +233,64 @@ bool Tileset::loadImage()
     return loadFromImage(mImageReference.create(), mImageReference.source);
 }
 
+/**
+ * Like loadImage(), but only reads the size of the tileset image and creates
+ * its tiles, deferring the decoding of the image until a tile image is first
+ * needed. This way tools that only deal with tile IDs never decode it.
+ *
+ * Falls back to loadImage() when the image size can't be determined.
+ *
+ * The deferred decoding is serialized by loadPendingImage(), so the tile
+ * images may be requested from multiple threads.
+ */
+bool Tileset::loadImageLazily()
+{
+    const QSize imageSize = mImageReference.readSize();
+    if (!imageSize.isValid() || mTileWidth <= 0 || mTileHeight <= 0)
+        return loadImage();
+
+    const int columnCount = columnCountForWidth(imageSize.width());
+    const int tileCount = columnCount * rowCountForHeight(imageSize.height());
+
+    for (int tileNum = 0; tileNum < tileCount; ++tileNum)
+        findOrCreateTile(tileNum);
+
+    mImageReference.size = imageSize;
+    mColumnCount = columnCount;
+    mImageLoadPending.storeRelease(true);
+
+    return true;
+}
+
+/**
+ * Decodes the tileset image when this was deferred by loadImageLazily().
+ * Returns whether the image is loaded, which is not the case when decoding
+ * failed. Safe to call from multiple threads.
+ */
+bool Tileset::loadPendingImage()
+{
+    QMutexLocker locker(&mImageLoadMutex);
+
+    if (mImageLoadPending.loadAcquire())
+        loadImage();
+
+    return mImageReference.loaded;
+}
+
+/**
+ * Returns whether the image used by this tileset was loaded succesfully. Only
+ * valid for tilesets based on a single image (imageSource() != empty).
+ *
+ * When decoding the image was deferred, this decodes it to find out.
+ */
+bool Tileset::imageLoaded() const
+{
+    if (isImageLoadPending())
+        return const_cast<Tileset*>(this)->loadPendingImage();
+
+    return mImageReference.loaded;
+}
+
 /**
  * Returns whether the tiles in \a candidate use the same images as the ones
  * in \a subject. Note that \a candidate is allowed to have additional tiles
@@ -405,6 +472,66 @@ int Tileset::terrainTransitionPenalty(int terrainType0, int terrainType1) const
     return mTerrainTypes.at(terrainType0)->transitionDistance(terrainType1);
 }
 
+/**
+ * Returns the index into mTerrainIndex for the given consideration mask,
+ * which is made up of whole corners.
+ */
+static int cornerMaskIndex(unsigned considerationMask)
+{
+    int index = 0;
+    for (int corner = 0; corner < 4; ++corner) {
+        const unsigned cornerMask = considerationMask & (0xFFu << (corner * 8));
+        Q_ASSERT(cornerMask == 0 || cornerMask == (0xFFu << (corner * 8)));
+        if (cornerMask)
+            index |= 1 << corner;
+    }
+    return index;
+}
+
+/**
+ * Returns the tiles of which the terrain matches the given \a terrain on the
+ * corners selected by \a considerationMask. The mask needs to consist of
+ * whole corners (0xFF for each considered corner).
+ *
+ * The tiles are looked up in an index that is built on first use, which
+ * avoids searching through all tiles when painting terrain.
+ */
+const QVector<Tile*> &Tileset::tilesWithTerrain(unsigned terrain,
+                                                unsigned considerationMask) const
+{
+    if (mTerrainIndexDirty)
+        rebuildTerrainIndex();
+
+    static const QVector<Tile*> noTiles;
+
+    const QHash<unsigned, QVector<Tile*>> &tilesByTerrain =
+            mTerrainIndex.at(cornerMaskIndex(considerationMask));
+
+    auto it = tilesByTerrain.find(terrain & considerationMask);
+    if (it == tilesByTerrain.end())
+        return noTiles;
+
+    return it.value();
+}
+
+void Tileset::rebuildTerrainIndex() const
+{
+    mTerrainIndex.fill(QHash<unsigned, QVector<Tile*>>(), 16);
+
+    for (Tile *tile : mTiles) {
+        for (int index = 0; index < 16; ++index) {
+            unsigned mask = 0;
+            for (int corner = 0; corner < 4; ++corner)
+                if (index & (1 << corner))
+                    mask |= 0xFFu << (corner * 8);
+
+            mTerrainIndex[index][tile->terrain() & mask].append(tile);
+        }
+    }
+
+    mTerrainIndexDirty = false;
+}
+
 /**
  * Calculates the transition distance matrix for all terrain types.
  */
@@ -501,6 +628,8 @@ Tile *Tileset::addTile(const QPixmap &image, const QString &source)
     newTile->setImageSource(source);
 
     mTiles.insert(newTile->id(), newTile);
+    mTerrainIndexDirty = true;
+
     if (mTileHeight < image.height())
         mTileHeight = image.height();
     if (mTileWidth < image.width())
@@ -520,6 +649,7 @@ void Tileset::addTiles(const QList<Tile *> &tiles)
         mTiles.insert(tile->id(), tile);
     }
 
+    mTerrainIndexDirty = true;
     updateTileSize();
 }
 
@@ -535,6 +665,7 @@ void Tileset::removeTiles(const QList<Tile *> &tiles)
         mTiles.remove(tile->id());
     }
 
+    mTerrainIndexDirty = true;
     updateTileSize();
 }
 
@@ -544,6 +675,7 @@ void Tileset::removeTiles(const QList<Tile *> &tiles)
 void Tileset::deleteTile(int id)
 {
     delete mTiles.take(id);
+    mTerrainIndexDirty = true;
 }
 
 /**
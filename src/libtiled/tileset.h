@@ -33,8 +33,11 @@
 #include "imagereference.h"
 #include "object.h"
 
+#include <QAtomicInt>
 #include <QColor>
+#include <QHash>
 #include <QList>
+#include <QMutex>
 #include <QVector>
 #include <QPoint>
 #include <QSharedPointer>
@@ -141,6 +144,10 @@ public:
     bool loadFromImage(const QImage &image, const QString &fileName);
     bool loadFromImage(const QString &fileName);
     bool loadImage();
+    bool loadImageLazily();
+
+    bool isImageLoadPending() const;
+    bool loadPendingImage();
 
     SharedTileset findSimilarTileset(const QVector<SharedTileset> &tilesets) const;
 
@@ -161,6 +168,9 @@ public:
 
     int terrainTransitionPenalty(int terrainType0, int terrainType1) const;
 
+    const QVector<Tile*> &tilesWithTerrain(unsigned terrain,
+                                           unsigned considerationMask) const;
+
     Tile *addTile(const QPixmap &image, const QString &source = QString());
     void addTiles(const QList<Tile*> &tiles);
     void removeTiles(const QList<Tile *> &tiles);
@@ -185,6 +195,7 @@ public:
 private:
     void updateTileSize();
     void recalculateTerrainDistances();
+    void rebuildTerrainIndex() const;
 
     QString mName;
     QString mFileName;
@@ -202,6 +213,12 @@ private:
     QList<Terrain*> mTerrainTypes;
     bool mTerrainDistancesDirty;
     bool mLoaded;
+    QAtomicInt mImageLoadPending;
+    QMutex mImageLoadMutex;     // serializes decoding of a pending image
+
+    // For each combination of considered corners, the tiles by their terrain
+    mutable QVector<QHash<unsigned, QVector<Tile*>>> mTerrainIndex;
+    mutable bool mTerrainIndexDirty;
 
     QWeakPointer<Tileset> mWeakPointer;
 };
@@ -482,11 +499,13 @@ inline int Tileset::takeNextTileId()
 }
 
 /**
- * Used by the Tile class when its terrain information changes.
+ * Used by the Tile class when its terrain information changes. Also
+ * invalidates the index used by tilesWithTerrain().
  */
 inline void Tileset::markTerrainDistancesDirty()
 {
     mTerrainDistancesDirty = true;
+    mTerrainIndexDirty = true;
 }
 
 inline SharedTileset Tileset::sharedPointer() const
@@ -514,12 +533,12 @@ inline bool Tileset::loaded() const
 }
 
 /**
- * Returns whether the image used by this tileset was loaded succesfully. Only
- * valid for tilesets based on a single image (imageSource() != empty).
+ * Returns whether decoding the tileset image was deferred by
+ * loadImageLazily() and did not happen yet.
  */
-inline bool Tileset::imageLoaded() const
+inline bool Tileset::isImageLoadPending() const
 {
-    return mImageReference.loaded;
+    return mImageLoadPending.loadAcquire();
 }
 
 } // namespace Tiled
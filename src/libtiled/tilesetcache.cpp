@@ -0,0 +1,75 @@
+/*
+ * tilesetcache.cpp
+ * Copyright 2026, agent <agent@local>
+ *
+ * This file is part of libtiled.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE CONTRIBUTORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "tilesetcache.h"
+
+#include "tilesetformat.h"
+
+#include <QFileInfo>
+
+namespace Tiled {
+
+/**
+ * Returns the tileset at \a fileName, loading it only when it is not cached
+ * yet or was modified since it was cached.
+ *
+ * Failed loads are not cached, so the error is reported each time.
+ */
+SharedTileset TilesetCache::load(const QString &fileName, QString *error)
+{
+    const QString canonicalPath = QFileInfo(fileName).canonicalFilePath();
+    const QString key = canonicalPath.isEmpty() ? fileName : canonicalPath;
+    const QDateTime lastModified = QFileInfo(fileName).lastModified();
+
+    // Tileset formats are not reentrant, so loading is serialized as well
+    QMutexLocker locker(&mMutex);
+
+    Entry &entry = mTilesets[key];
+    if (!entry.tileset || entry.lastModified != lastModified) {
+        entry.lastModified = lastModified;
+        entry.tileset = readTileset(fileName, error);
+
+        if (!entry.tileset) {
+            mTilesets.remove(key);
+            return SharedTileset();
+        }
+    }
+
+    return entry.tileset;
+}
+
+/**
+ * Releases all cached tilesets.
+ */
+void TilesetCache::clear()
+{
+    QMutexLocker locker(&mMutex);
+    mTilesets.clear();
+}
+
+} // namespace Tiled
@@ -0,0 +1,70 @@
+/*
+ * tilesetcache.h
+ * Copyright 2026, agent <agent@local>
+ *
+ * This file is part of libtiled.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE CONTRIBUTORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TILED_TILESETCACHE_H
+#define TILED_TILESETCACHE_H
+
+#include "tileset.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+namespace Tiled {
+
+/**
+ * Keeps external tilesets that were loaded, so that maps sharing a tileset
+ * don't each need to load it again. A cached tileset is loaded again when
+ * its file was modified since it was cached.
+ *
+ * All functions are safe to call from multiple threads.
+ *
+ * @see MapReader::setTilesetCache()
+ */
+class TILEDSHARED_EXPORT TilesetCache
+{
+public:
+    SharedTileset load(const QString &fileName, QString *error = nullptr);
+
+    void clear();
+
+private:
+    struct Entry
+    {
+        QDateTime lastModified;
+        SharedTileset tileset;
+    };
+
+    QMutex mMutex;
+    QHash<QString, Entry> mTilesets;
+};
+
+} // namespace Tiled
+
+#endif // TILED_TILESETCACHE_H
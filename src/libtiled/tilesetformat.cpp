@@ -30,8 +30,45 @@
 
 #include "mapreader.h"
 
+#include <QBuffer>
+
 namespace Tiled {
 
+/**
+ * Reads a tileset from \a data, which is not copied. Only supported by
+ * formats with the ReadFromDevice capability.
+ *
+ * @see readFromDevice
+ */
+SharedTileset TilesetFormat::fromByteArray(const QByteArray &data,
+                                           const QString &fileName)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+
+    return readFromDevice(&buffer, fileName);
+}
+
+/**
+ * Writes \a tileset to a byte array. Returns an empty byte array when
+ * writing failed. Only supported by formats with the WriteToDevice
+ * capability.
+ *
+ * @see writeToDevice
+ */
+QByteArray TilesetFormat::toByteArray(const Tileset &tileset,
+                                      const QString &fileName)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    if (!writeToDevice(tileset, &buffer, fileName))
+        return QByteArray();
+
+    return buffer.data();
+}
+
 SharedTileset readTileset(const QString &fileName, QString *error)
 {
     // Try the first registered tileset format that claims to support the file
@@ -63,6 +63,43 @@ public:
      *         occurred. The error can be retrieved by errorString().
      */
     virtual bool write(const Tileset &tileset, const QString &fileName) = 0;
+
+    /**
+     * Reads a tileset from the given \a device. The \a fileName is used to
+     * resolve references to other files. When it is empty, references are
+     * expected to be absolute.
+     *
+     * Only supported by formats with the ReadFromDevice capability.
+     */
+    virtual SharedTileset readFromDevice(QIODevice *device,
+                                         const QString &fileName)
+    {
+        Q_UNUSED(device)
+        Q_UNUSED(fileName)
+        return SharedTileset();
+    }
+
+    /**
+     * Writes the given \a tileset to \a device. References to other files
+     * are written relative to the given \a fileName, or as absolute paths
+     * when it is empty.
+     *
+     * Only supported by formats with the WriteToDevice capability.
+     */
+    virtual bool writeToDevice(const Tileset &tileset, QIODevice *device,
+                               const QString &fileName)
+    {
+        Q_UNUSED(tileset)
+        Q_UNUSED(device)
+        Q_UNUSED(fileName)
+        return false;
+    }
+
+    SharedTileset fromByteArray(const QByteArray &data,
+                                const QString &fileName = QString());
+
+    QByteArray toByteArray(const Tileset &tileset,
+                           const QString &fileName = QString());
 };
 
 /**
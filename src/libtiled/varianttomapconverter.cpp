@@ -33,6 +33,7 @@
 #include "tilesetformat.h"
 
 #include <QScopedPointer>
+#include <QVector>
 
 using namespace Tiled;
 
@@ -111,7 +112,7 @@ Map *VariantToMapConverter::toMap(const QVariant &variant,
     auto tilesets = map->tilesets();
     for (SharedTileset &tileset : tilesets) {
         if (!tileset->imageSource().isEmpty() && tileset->fileName().isEmpty())
-            tileset->loadImage();
+            tileset->loadImageLazily();
     }
 
     return map.take();
@@ -125,7 +126,7 @@ SharedTileset VariantToMapConverter::toTileset(const QVariant &variant,
 
     SharedTileset tileset = toTileset(variant);
     if (tileset && !tileset->imageSource().isEmpty())
-        tileset->loadImage();
+        tileset->loadImageLazily();
 
     mReadingExternalTileset = false;
     return tileset;
@@ -365,6 +366,23 @@ TileLayer *VariantToMapConverter::toTileLayer(const QVariantMap &variantMap)
     switch (layerDataFormat) {
     case Map::XML:
     case Map::CSV: {
+        // Readers may provide the layer data as a vector of global tile IDs
+        if (dataVariant.userType() == qMetaTypeId<QVector<unsigned> >()) {
+            const QVector<unsigned> gids = dataVariant.value<QVector<unsigned> >();
+
+            if (gids.size() != width * height) {
+                mError = tr("Corrupt layer data for layer '%1'").arg(name);
+                return nullptr;
+            }
+
+            bool ok;
+            for (int i = 0; i < gids.size(); ++i) {
+                const Cell cell = mGidMapper.gidToCell(gids.at(i), ok);
+                tileLayer->setCell(i % width, i / width, cell);
+            }
+            break;
+        }
+
         const QVariantList dataVariantList = dataVariant.toList();
 
         if (dataVariantList.size() != width * height) {
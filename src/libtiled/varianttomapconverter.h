@@ -37,8 +37,8 @@ class Properties;
 class Tileset;
 
 /**
- * Converts a QVariant to a Map instance. Meant to be used together with
- * JsonReader.
+ * Converts a QVariant to a Map instance. Meant to be used together with the
+ * JsonPullReader of the JSON plugin.
  */
 class TILEDSHARED_EXPORT VariantToMapConverter
 {
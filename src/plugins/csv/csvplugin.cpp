@@ -49,40 +49,48 @@ bool CsvPlugin::write(const Map *map, const QString &fileName)
             
         const TileLayer *tileLayer = static_cast<const TileLayer*>(layer);
 
-        QSaveFile file(layerPaths.at(currentLayer));
-
-        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            mError = tr("Could not open file for writing.");
-            return false;
-        }
-
         // Write out tiles either by ID or their name, if given. -1 is "empty"
+        QByteArray contents;
         for (int y = 0; y < tileLayer->height(); ++y) {
             for (int x = 0; x < tileLayer->width(); ++x) {
                 if (x > 0)
-                    file.write(",", 1);
-    
+                    contents.append(',');
+
                 const Cell &cell = tileLayer->cellAt(x, y);
                 const Tile *tile = cell.tile;
                 if (tile && tile->hasProperty(QLatin1String("name"))) {
-                    file.write(tile->property(QLatin1String("name")).toString().toUtf8());
+                    contents.append(tile->property(QLatin1String("name")).toString().toUtf8());
                 } else {
                     const int id = tile ? tile->id() : -1;
-                    file.write(QByteArray::number(id));
+                    contents.append(QByteArray::number(id));
                 }
             }
-    
-            file.write("\n", 1);
-        }
-    
-        if (file.error() != QFile::NoError) {
-            mError = file.errorString();
-            return false;
+
+            contents.append('\n');
         }
 
-        if (!file.commit()) {
-            mError = file.errorString();
-            return false;
+        // Leave files of unchanged layers alone, so that tools watching them
+        // are not triggered needlessly
+        const QString &layerPath = layerPaths.at(currentLayer);
+        if (!fileHasContents(layerPath, contents)) {
+            QSaveFile file(layerPath);
+
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+                mError = tr("Could not open file for writing.");
+                return false;
+            }
+
+            file.write(contents);
+
+            if (file.error() != QFile::NoError) {
+                mError = file.errorString();
+                return false;
+            }
+
+            if (!file.commit()) {
+                mError = file.errorString();
+                return false;
+            }
         }
 
         ++currentLayer;
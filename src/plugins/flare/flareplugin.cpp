@@ -292,8 +292,9 @@ bool FlarePlugin::write(const Tiled::Map *map, const QString &fileName)
     out << "orientation=" << orientationToString(map->orientation()) << "\n";
 
     // write all properties for this map
-    Properties::const_iterator it = map->properties().constBegin();
-    Properties::const_iterator it_end = map->properties().constEnd();
+    const Properties mapProperties = map->properties();
+    Properties::const_iterator it = mapProperties.constBegin();
+    Properties::const_iterator it_end = mapProperties.constEnd();
     for (; it != it_end; ++it) {
         out << it.key() << "=" << toExportValue(it.value()).toString() << "\n";
     }
@@ -363,10 +364,10 @@ bool FlarePlugin::write(const Tiled::Map *map, const QString &fileName)
                     out << "," << w << "," << h << "\n";
 
                     // write all properties for this object
-                    Properties::const_iterator it = o->properties().constBegin();
-                    Properties::const_iterator it_end = o->properties().constEnd();
-                    for (; it != it_end; ++it) {
-                        out << it.key() << "=" << it.value().toString() << "\n";
+                    const PropertyList &objectProperties = o->propertyList();
+                    for (int i = 0; i < objectProperties.size(); ++i) {
+                        out << objectProperties.nameAt(i) << "="
+                            << objectProperties.valueAt(i).toString() << "\n";
                     }
                     out << "\n";
                 }
@@ -3,8 +3,10 @@ include(../plugin.pri)
 DEFINES += JSON_LIBRARY
 
 SOURCES += jsonplugin.cpp \
-    qjsonparser/json.cpp
+    jsonpullreader.cpp \
+    jsonstreamwriter.cpp
 
 HEADERS += jsonplugin.h \
     json_global.h \
-    qjsonparser/json.h
+    jsonpullreader.h \
+    jsonstreamwriter.h
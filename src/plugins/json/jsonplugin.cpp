@@ -21,18 +21,28 @@
 
 #include "jsonplugin.h"
 
+#include "jsonpullreader.h"
+#include "jsonstreamwriter.h"
 #include "maptovariantconverter.h"
 #include "varianttomapconverter.h"
 
-#include "qjsonparser/json.h"
-
-#include <QFile>
 #include <QFileInfo>
 #include <QSaveFile>
-#include <QTextStream>
+#include <QSettings>
 
 namespace Json {
 
+/**
+ * Returns the directory of the given file, relative to which references are
+ * resolved. Returns the default QDir when there is no file name.
+ */
+static QDir directoryOf(const QString &fileName)
+{
+    if (fileName.isEmpty())
+        return QDir();
+    return QFileInfo(fileName).dir();
+}
+
 void JsonPlugin::initialize()
 {
     addObject(new JsonMapFormat(JsonMapFormat::Json, this));
@@ -48,35 +58,52 @@ JsonMapFormat::JsonMapFormat(SubFormat subFormat, QObject *parent)
 
 Tiled::Map *JsonMapFormat::read(const QString &fileName)
 {
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    Tiled::MappedFile file(fileName);
+    if (!file.open()) {
         mError = tr("Could not open file for reading.");
         return nullptr;
     }
 
-    JsonReader reader;
-    QByteArray contents = file.readAll();
-    if (mSubFormat == JavaScript && contents.size() > 0 && contents[0] != '{') {
-        // Scan past JSONP prefix; look for an open curly at the start of the line
-        int i = contents.indexOf(QLatin1String("\n{"));
-        if (i > 0) {
-            contents.remove(0, i);
-            contents = contents.trimmed(); // potential trailing whitespace
-            if (contents.endsWith(';')) contents.chop(1);
-            if (contents.endsWith(')')) contents.chop(1);
-        }
+    return readFromDevice(file.device(), fileName);
+}
+
+bool JsonMapFormat::write(const Tiled::Map *map, const QString &fileName)
+{
+    QSaveFile file(fileName);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        mError = tr("Could not open file for writing.");
+        return false;
     }
-    reader.parse(contents);
 
-    const QVariant variant = reader.result();
+    if (!writeToDevice(map, &file, fileName))
+        return false;
+
+    if (!file.commit()) {
+        mError = file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+Tiled::Map *JsonMapFormat::readFromDevice(QIODevice *device,
+                                          const QString &fileName)
+{
+    JsonPullReader reader(device);
+    if (mSubFormat == JavaScript)
+        reader.skipJsonpPrefix();
+
+    // The JavaScript format has the map followed by the end of a function call
+    const QVariant variant = reader.read(mSubFormat == Json);
 
     if (!variant.isValid()) {
-        mError = tr("Error parsing file.");
+        mError = tr("Error parsing file:\n%1").arg(reader.errorString());
         return nullptr;
     }
 
     Tiled::VariantToMapConverter converter;
-    Tiled::Map *map = converter.toMap(variant, QFileInfo(fileName).dir());
+    Tiled::Map *map = converter.toMap(variant, directoryOf(fileName));
 
     if (!map)
         mError = converter.errorString();
@@ -84,56 +111,42 @@ Tiled::Map *JsonMapFormat::read(const QString &fileName)
     return map;
 }
 
-bool JsonMapFormat::write(const Tiled::Map *map, const QString &fileName)
+bool JsonMapFormat::writeToDevice(const Tiled::Map *map, QIODevice *device,
+                                  const QString &fileName)
 {
-    QSaveFile file(fileName);
-
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        mError = tr("Could not open file for writing.");
-        return false;
-    }
-
     Tiled::MapToVariantConverter converter;
-    QVariant variant = converter.toVariant(map, QFileInfo(fileName).dir());
+    converter.setCompactLayerData(true);
+    converter.setUseAbsolutePaths(fileName.isEmpty());
+    QVariant variant = converter.toVariant(map, directoryOf(fileName));
 
-    JsonWriter writer;
+    JsonStreamWriter writer(device);
     writer.setAutoFormatting(true);
 
-    if (!writer.stringify(variant)) {
-        // This can only happen due to coding error
-        mError = writer.errorString();
-        return false;
-    }
+    // Set in the Preferences dialog of Tiled, which can't be linked to here
+    const QSettings settings;
+    writer.setTileRowsOnSeparateLines(
+                settings.value(QLatin1String("Storage/JsonTileRowsOnSeparateLines"),
+                               false).toBool());
 
-    QTextStream out(&file);
-    if (mSubFormat == JavaScript) {
-        // Trim and escape name
-        JsonWriter nameWriter;
-        QString baseName = QFileInfo(fileName).baseName();
-        nameWriter.stringify(baseName);
-        out << "(function(name,data){\n if(typeof onTileMapLoaded === 'undefined') {\n";
-        out << "  if(typeof TileMaps === 'undefined') TileMaps = {};\n";
-        out << "  TileMaps[name] = data;\n";
-        out << " } else {\n";
-        out << "  onTileMapLoaded(name,data);\n";
-        out << " }\n";
-        out << " if(typeof module === 'object' && module && module.exports) {\n";
-        out << "  module.exports = data;\n";
-        out << " }})(" << nameWriter.result() << ",\n";
-    }
-    out << writer.result();
     if (mSubFormat == JavaScript) {
-        out << ");";
+        writer.writeRaw("(function(name,data){\n if(typeof onTileMapLoaded === 'undefined') {\n"
+                        "  if(typeof TileMaps === 'undefined') TileMaps = {};\n"
+                        "  TileMaps[name] = data;\n"
+                        " } else {\n"
+                        "  onTileMapLoaded(name,data);\n"
+                        " }\n"
+                        " if(typeof module === 'object' && module && module.exports) {\n"
+                        "  module.exports = data;\n"
+                        " }})(");
+        writer.writeString(QFileInfo(fileName).baseName());
+        writer.writeRaw(",\n");
     }
-    out.flush();
+    writer.writeValue(variant);
+    if (mSubFormat == JavaScript)
+        writer.writeRaw(");");
 
-    if (file.error() != QFile::NoError) {
-        mError = tr("Error while writing file:\n%1").arg(file.errorString());
-        return false;
-    }
-
-    if (!file.commit()) {
-        mError = file.errorString();
+    if (!writer.flush()) {
+        mError = tr("Error while writing file:\n%1").arg(writer.errorString());
         return false;
     }
 
@@ -169,35 +182,13 @@ JsonTilesetFormat::JsonTilesetFormat(QObject *parent)
 
 Tiled::SharedTileset JsonTilesetFormat::read(const QString &fileName)
 {
-    QFile file(fileName);
-
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    Tiled::MappedFile file(fileName);
+    if (!file.open()) {
         mError = tr("Could not open file for reading.");
         return Tiled::SharedTileset();
     }
 
-    JsonReader reader;
-    QByteArray contents = file.readAll();
-
-    reader.parse(contents);
-
-    const QVariant variant = reader.result();
-
-    if (!variant.isValid()) {
-        mError = tr("Error parsing file.");
-        return Tiled::SharedTileset();
-    }
-
-    Tiled::VariantToMapConverter converter;
-    Tiled::SharedTileset tileset = converter.toTileset(variant,
-                                                       QFileInfo(fileName).dir());
-
-    if (!tileset)
-        mError = converter.errorString();
-    else
-        tileset->setFileName(fileName);
-
-    return tileset;
+    return readFromDevice(file.device(), fileName);
 }
 
 bool JsonTilesetFormat::supportsFile(const QString &fileName) const
@@ -215,29 +206,54 @@ bool JsonTilesetFormat::write(const Tiled::Tileset &tileset,
         return false;
     }
 
-    Tiled::MapToVariantConverter converter;
-    QVariant variant = converter.toVariant(tileset, QFileInfo(fileName).dir());
-
-    JsonWriter writer;
-    writer.setAutoFormatting(true);
+    if (!writeToDevice(tileset, &file, fileName))
+        return false;
 
-    if (!writer.stringify(variant)) {
-        // This can only happen due to coding error
-        mError = writer.errorString();
+    if (!file.commit()) {
+        mError = file.errorString();
         return false;
     }
 
-    QTextStream out(&file);
-    out << writer.result();
-    out.flush();
+    return true;
+}
 
-    if (file.error() != QFile::NoError) {
-        mError = tr("Error while writing file:\n%1").arg(file.errorString());
-        return false;
+Tiled::SharedTileset JsonTilesetFormat::readFromDevice(QIODevice *device,
+                                                       const QString &fileName)
+{
+    JsonPullReader reader(device);
+    const QVariant variant = reader.read();
+
+    if (!variant.isValid()) {
+        mError = tr("Error parsing file:\n%1").arg(reader.errorString());
+        return Tiled::SharedTileset();
     }
 
-    if (!file.commit()) {
-        mError = file.errorString();
+    Tiled::VariantToMapConverter converter;
+    Tiled::SharedTileset tileset = converter.toTileset(variant,
+                                                       directoryOf(fileName));
+
+    if (!tileset)
+        mError = converter.errorString();
+    else if (!fileName.isEmpty())
+        tileset->setFileName(fileName);
+
+    return tileset;
+}
+
+bool JsonTilesetFormat::writeToDevice(const Tiled::Tileset &tileset,
+                                      QIODevice *device,
+                                      const QString &fileName)
+{
+    Tiled::MapToVariantConverter converter;
+    converter.setUseAbsolutePaths(fileName.isEmpty());
+    QVariant variant = converter.toVariant(tileset, directoryOf(fileName));
+
+    JsonStreamWriter writer(device);
+    writer.setAutoFormatting(true);
+    writer.writeValue(variant);
+
+    if (!writer.flush()) {
+        mError = tr("Error while writing file:\n%1").arg(writer.errorString());
         return false;
     }
 
@@ -60,11 +60,19 @@ public:
 
     JsonMapFormat(SubFormat subFormat, QObject *parent = nullptr);
 
+    Capabilities capabilities() const override
+    { return ReadWrite | ReadFromDevice | WriteToDevice; }
+
     Tiled::Map *read(const QString &fileName) override;
     bool supportsFile(const QString &fileName) const override;
 
     bool write(const Tiled::Map *map, const QString &fileName) override;
 
+    Tiled::Map *readFromDevice(QIODevice *device,
+                               const QString &fileName) override;
+    bool writeToDevice(const Tiled::Map *map, QIODevice *device,
+                       const QString &fileName) override;
+
     QString nameFilter() const override;
     QString errorString() const override;
 
@@ -82,11 +90,19 @@ class JSONSHARED_EXPORT JsonTilesetFormat : public Tiled::TilesetFormat
 public:
     JsonTilesetFormat(QObject *parent = nullptr);
 
+    Capabilities capabilities() const override
+    { return ReadWrite | ReadFromDevice | WriteToDevice; }
+
     Tiled::SharedTileset read(const QString &fileName) override;
     bool supportsFile(const QString &fileName) const override;
 
     bool write(const Tiled::Tileset &tileset, const QString &fileName) override;
 
+    Tiled::SharedTileset readFromDevice(QIODevice *device,
+                                        const QString &fileName) override;
+    bool writeToDevice(const Tiled::Tileset &tileset, QIODevice *device,
+                       const QString &fileName) override;
+
     QString nameFilter() const override;
     QString errorString() const override;
 
@@ -0,0 +1,504 @@
+/*
+ * jsonpullreader.cpp
+ * Copyright 2026, agent <agent@local>
+ *
+ *
+ * This file is part of Tiled.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "jsonpullreader.h"
+
+#include <QBuffer>
+
+#include <climits>
+
+using namespace Json;
+
+static const int ChunkSize = 64 * 1024;
+static const int MaxDepth = 512;
+
+static inline bool isDigit(int c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static void appendUtf8(QByteArray &out, uint code)
+{
+    if (code < 0x80) {
+        out.append(char(code));
+    } else if (code < 0x800) {
+        out.append(char(0xC0 | (code >> 6)));
+        out.append(char(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        out.append(char(0xE0 | (code >> 12)));
+        out.append(char(0x80 | ((code >> 6) & 0x3F)));
+        out.append(char(0x80 | (code & 0x3F)));
+    } else {
+        out.append(char(0xF0 | (code >> 18)));
+        out.append(char(0x80 | ((code >> 12) & 0x3F)));
+        out.append(char(0x80 | ((code >> 6) & 0x3F)));
+        out.append(char(0x80 | (code & 0x3F)));
+    }
+}
+
+/**
+ * Moves the gids collected so far over to the generic \a list, for when a
+ * "data" array turns out not to contain only gids.
+ */
+static void moveGidsToList(QVector<unsigned> &gids, QVariantList &list)
+{
+    list.reserve(gids.size());
+    for (unsigned gid : gids)
+        list.append(gid);
+    gids.clear();
+}
+
+
+JsonPullReader::JsonPullReader(QIODevice *device)
+    : mDevice(device)
+    , mPos(0)
+    , mEnd(0)
+    , mLine(1)
+    , mNumberLength(0)
+    , mNumberIsInteger(false)
+{
+    mNumber[0] = '\0';
+
+    // Parse the data of a buffer in place, which avoids copying it when
+    // reading from memory or from a memory-mapped file
+    if (QBuffer *buffer = qobject_cast<QBuffer*>(device)) {
+        const QByteArray &data = buffer->data();
+        const int pos = static_cast<int>(buffer->pos());
+        mBuffer = QByteArray::fromRawData(data.constData() + pos,
+                                          data.size() - pos);
+        mEnd = mBuffer.size();
+        mDevice = nullptr;
+    }
+}
+
+bool JsonPullReader::fill()
+{
+    if (!mDevice)
+        return false;
+
+    if (mBuffer.size() != ChunkSize)
+        mBuffer.resize(ChunkSize);
+
+    const qint64 length = mDevice->read(mBuffer.data(), ChunkSize);
+    mPos = 0;
+    mEnd = length > 0 ? int(length) : 0;
+    return mEnd > 0;
+}
+
+inline int JsonPullReader::peek()
+{
+    if (mPos == mEnd && !fill())
+        return -1;
+    return uchar(mBuffer.constData()[mPos]);
+}
+
+inline int JsonPullReader::get()
+{
+    const int c = peek();
+    if (c != -1) {
+        ++mPos;
+        if (c == '\n')
+            ++mLine;
+    }
+    return c;
+}
+
+void JsonPullReader::skipJsonpPrefix()
+{
+    int previous = '\n';
+    for (;;) {
+        const int c = peek();
+        if (c == -1 || (c == '{' && previous == '\n'))
+            return;
+        previous = get();
+    }
+}
+
+QVariant JsonPullReader::read(bool requireEnd)
+{
+    mError.clear();
+
+    skipWhitespace();
+    const QVariant result = readValue(0, false);
+    if (hasError())
+        return QVariant();
+
+    if (!result.isValid()) {
+        setError(tr("Unexpected null value"));
+        return QVariant();
+    }
+
+    if (requireEnd) {
+        skipWhitespace();
+        if (peek() != -1) {
+            setError(tr("Unexpected data after the end of the document"));
+            return QVariant();
+        }
+    }
+
+    return result;
+}
+
+void JsonPullReader::skipWhitespace()
+{
+    for (;;) {
+        switch (peek()) {
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':
+            get();
+            break;
+        default:
+            return;
+        }
+    }
+}
+
+QVariant JsonPullReader::readValue(int depth, bool gidArray)
+{
+    if (depth > MaxDepth) {
+        setError(tr("Maximum nesting depth exceeded"));
+        return QVariant();
+    }
+
+    const int c = peek();
+    switch (c) {
+    case '{':
+        return readObject(depth + 1);
+    case '[':
+        return readArray(depth + 1, gidArray);
+    case '"':
+        if (!readString(mString))
+            return QVariant();
+        return QString::fromUtf8(mString.constData(), mString.size());
+    case 't':
+        if (readLiteral("true"))
+            return true;
+        return QVariant();
+    case 'f':
+        if (readLiteral("false"))
+            return false;
+        return QVariant();
+    case 'n':
+        readLiteral("null");
+        return QVariant();
+    case -1:
+        setError(tr("Unexpected end of file"));
+        return QVariant();
+    }
+
+    if (c == '-' || isDigit(c)) {
+        if (!readNumberToken())
+            return QVariant();
+        return numberTokenToVariant();
+    }
+
+    setError(tr("Unexpected character '%1'").arg(QChar(c)));
+    return QVariant();
+}
+
+QVariant JsonPullReader::readObject(int depth)
+{
+    get(); // '{'
+
+    QVariantMap map;
+
+    skipWhitespace();
+    if (peek() == '}') {
+        get();
+        return map;
+    }
+
+    for (;;) {
+        skipWhitespace();
+        if (peek() != '"') {
+            setError(tr("Expected a string"));
+            return QVariant();
+        }
+        if (!readString(mString))
+            return QVariant();
+
+        // Share the keys, since the same few are used by many objects
+        QString &sharedKey = mKeys[mString];
+        if (sharedKey.isNull())
+            sharedKey = QString::fromUtf8(mString.constData(), mString.size());
+        const QString key = sharedKey;
+        const bool gidArray = mString == "data";
+
+        skipWhitespace();
+        if (get() != ':') {
+            setError(tr("Expected ':'"));
+            return QVariant();
+        }
+        skipWhitespace();
+
+        const QVariant value = readValue(depth, gidArray);
+        if (hasError())
+            return QVariant();
+
+        map.insert(key, value);
+
+        skipWhitespace();
+        const int c = get();
+        if (c == '}')
+            return map;
+        if (c != ',') {
+            setError(tr("Expected ',' or '}'"));
+            return QVariant();
+        }
+    }
+}
+
+QVariant JsonPullReader::readArray(int depth, bool gidArray)
+{
+    get(); // '['
+
+    QVariantList list;
+    QVector<unsigned> gids;
+
+    skipWhitespace();
+    if (peek() == ']') {
+        get();
+        return list;
+    }
+
+    for (;;) {
+        skipWhitespace();
+
+        if (gidArray && isDigit(peek())) {
+            if (!readNumberToken())
+                return QVariant();
+
+            unsigned gid;
+            if (numberTokenToGid(gid)) {
+                gids.append(gid);
+            } else {
+                moveGidsToList(gids, list);
+                gidArray = false;
+                list.append(numberTokenToVariant());
+            }
+        } else {
+            if (gidArray) {
+                moveGidsToList(gids, list);
+                gidArray = false;
+            }
+            list.append(readValue(depth, false));
+        }
+
+        if (hasError())
+            return QVariant();
+
+        skipWhitespace();
+        const int c = get();
+        if (c == ']')
+            break;
+        if (c != ',') {
+            setError(tr("Expected ',' or ']'"));
+            return QVariant();
+        }
+    }
+
+    if (gidArray) {
+        gids.squeeze();
+        return QVariant::fromValue(gids);
+    }
+
+    return list;
+}
+
+bool JsonPullReader::readString(QByteArray &out)
+{
+    get(); // '"'
+
+    out.resize(0);
+
+    for (;;) {
+        if (mPos == mEnd && !fill()) {
+            setError(tr("Unexpected end of file"));
+            return false;
+        }
+
+        // Copy runs of plain characters in one go
+        const char *begin = mBuffer.constData() + mPos;
+        const char *end = mBuffer.constData() + mEnd;
+        const char *p = begin;
+        while (p != end && *p != '"' && *p != '\\' && uchar(*p) >= 0x20)
+            ++p;
+
+        out.append(begin, int(p - begin));
+        mPos += int(p - begin);
+
+        if (p == end)
+            continue;
+
+        const int c = get();
+        if (c == '"')
+            return true;
+
+        if (c != '\\') {
+            setError(tr("Unescaped control character in string"));
+            return false;
+        }
+
+        switch (get()) {
+        case '"':   out.append('"'); break;
+        case '\\':  out.append('\\'); break;
+        case '/':   out.append('/'); break;
+        case 'b':   out.append('\b'); break;
+        case 'f':   out.append('\f'); break;
+        case 'n':   out.append('\n'); break;
+        case 'r':   out.append('\r'); break;
+        case 't':   out.append('\t'); break;
+        case 'u': {
+            uint code;
+            if (!readHex4(code))
+                return false;
+
+            // Combine surrogate pairs into a single code point
+            if (code >= 0xD800 && code < 0xDC00) {
+                uint low;
+                if (get() != '\\' || get() != 'u' || !readHex4(low) ||
+                        low < 0xDC00 || low > 0xDFFF) {
+                    setError(tr("Invalid surrogate pair in string"));
+                    return false;
+                }
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            }
+
+            appendUtf8(out, code);
+            break;
+        }
+        default:
+            setError(tr("Invalid escape sequence in string"));
+            return false;
+        }
+    }
+}
+
+bool JsonPullReader::readHex4(uint &code)
+{
+    code = 0;
+
+    for (int i = 0; i < 4; ++i) {
+        const int c = get();
+        uint digit;
+        if (c >= '0' && c <= '9')
+            digit = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            digit = c - 'A' + 10;
+        else {
+            setError(tr("Invalid escape sequence in string"));
+            return false;
+        }
+        code = (code << 4) | digit;
+    }
+
+    return true;
+}
+
+bool JsonPullReader::readNumberToken()
+{
+    mNumberLength = 0;
+    mNumberIsInteger = true;
+
+    for (;;) {
+        const int c = peek();
+        if (c == '.' || c == 'e' || c == 'E' || c == '+')
+            mNumberIsInteger = false;
+        else if (!isDigit(c) && c != '-')
+            break;
+
+        if (mNumberLength == int(sizeof(mNumber)) - 1) {
+            setError(tr("Number too long"));
+            return false;
+        }
+
+        mNumber[mNumberLength++] = char(get());
+    }
+
+    mNumber[mNumberLength] = '\0';
+    return true;
+}
+
+bool JsonPullReader::numberTokenToGid(unsigned &gid) const
+{
+    if (!mNumberIsInteger || mNumberLength > 10)
+        return false;
+
+    quint64 value = 0;
+    for (int i = 0; i < mNumberLength; ++i) {
+        if (!isDigit(mNumber[i]))
+            return false;
+        value = value * 10 + (mNumber[i] - '0');
+    }
+
+    if (value > 0xFFFFFFFFu)
+        return false;
+
+    gid = unsigned(value);
+    return true;
+}
+
+QVariant JsonPullReader::numberTokenToVariant()
+{
+    const QByteArray token = QByteArray::fromRawData(mNumber, mNumberLength);
+    bool ok;
+
+    if (mNumberIsInteger) {
+        const qlonglong value = token.toLongLong(&ok);
+        if (ok) {
+            if (value >= INT_MIN && value <= INT_MAX)
+                return int(value);
+            return value;
+        }
+        // Integers that don't fit in 64 bits are read as double
+    }
+
+    const double value = token.toDouble(&ok);
+    if (!ok) {
+        setError(tr("Invalid number '%1'").arg(QString::fromLatin1(token)));
+        return QVariant();
+    }
+
+    return value;
+}
+
+bool JsonPullReader::readLiteral(const char *literal)
+{
+    for (const char *c = literal; *c; ++c) {
+        // Peek first, so that the error points at the line of the mismatch
+        if (peek() != *c) {
+            setError(tr("Invalid literal, expected '%1'").arg(QLatin1String(literal)));
+            return false;
+        }
+        get();
+    }
+    return true;
+}
+
+void JsonPullReader::setError(const QString &message)
+{
+    if (mError.isEmpty())
+        mError = tr("Line %1: %2").arg(mLine).arg(message);
+}
@@ -0,0 +1,105 @@
+/*
+ * jsonpullreader.h
+ * Copyright 2026, agent <agent@local>
+ *
+ *
+ * This file is part of Tiled.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONPULLREADER_H
+#define JSONPULLREADER_H
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QHash>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+class QIODevice;
+
+namespace Json {
+
+/**
+ * A JSON reader that pulls its input from a QIODevice in small chunks,
+ * rather than requiring the whole file to be loaded into memory first.
+ *
+ * Arrays that are stored under a "data" key and consist only of unsigned
+ * integers are parsed straight into a QVector<unsigned>, avoiding a QVariant
+ * for each tile in a layer. Object keys are shared between all objects.
+ *
+ * When the device is a QBuffer, its data is parsed in place.
+ */
+class JsonPullReader
+{
+    Q_DECLARE_TR_FUNCTIONS(JsonPullReader)
+
+public:
+    explicit JsonPullReader(QIODevice *device);
+
+    /**
+     * Skips a JSONP prefix like the one written by the JavaScript map format,
+     * by looking for an open curly brace at the start of a line.
+     */
+    void skipJsonpPrefix();
+
+    /**
+     * Reads a single JSON value. When \a requireEnd is true, only whitespace
+     * is allowed after the value.
+     *
+     * Returns an invalid QVariant on error.
+     */
+    QVariant read(bool requireEnd = true);
+
+    QString errorString() const { return mError; }
+
+private:
+    int peek();
+    int get();
+    bool fill();
+    void skipWhitespace();
+
+    QVariant readValue(int depth, bool gidArray);
+    QVariant readObject(int depth);
+    QVariant readArray(int depth, bool gidArray);
+    bool readString(QByteArray &out);
+    bool readHex4(uint &code);
+    bool readNumberToken();
+    bool numberTokenToGid(unsigned &gid) const;
+    QVariant numberTokenToVariant();
+    bool readLiteral(const char *literal);
+
+    bool hasError() const { return !mError.isEmpty(); }
+    void setError(const QString &message);
+
+    QIODevice *mDevice;
+    QByteArray mBuffer;
+    int mPos;
+    int mEnd;
+    int mLine;
+
+    QByteArray mString;
+    char mNumber[64];
+    int mNumberLength;
+    bool mNumberIsInteger;
+
+    QHash<QByteArray, QString> mKeys;
+    QString mError;
+};
+
+} // namespace Json
+
+#endif // JSONPULLREADER_H
@@ -0,0 +1,276 @@
+/*
+ * jsonstreamwriter.cpp
+ * Copyright 2026, agent <agent@local>
+ *
+ *
+ * This file is part of Tiled.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "jsonstreamwriter.h"
+
+#include "numberformat.h"
+
+#include <QIODevice>
+#include <QtNumeric>
+
+#include <cstring>
+
+using namespace Json;
+
+JsonStreamWriter::JsonStreamWriter(QIODevice *device)
+    : mDevice(device)
+    , mBuffer(BufferSize, Qt::Uninitialized)
+    , mData(mBuffer.data())
+    , mLength(0)
+    , mAutoFormatting(false)
+    , mTileRowsOnSeparateLines(false)
+{
+}
+
+void JsonStreamWriter::writeValue(const QVariant &variant)
+{
+    writeValue(variant, 0, 0);
+}
+
+void JsonStreamWriter::writeString(const QString &string)
+{
+    write('"');
+    writeEscaped(string);
+    write('"');
+}
+
+void JsonStreamWriter::writeRaw(const char *text)
+{
+    write(text, int(std::strlen(text)));
+}
+
+bool JsonStreamWriter::flush()
+{
+    flushBuffer();
+    return mError.isEmpty();
+}
+
+void JsonStreamWriter::writeValue(const QVariant &variant, int depth,
+                                  int rowLength)
+{
+    const int type = variant.userType();
+
+    if (type == qMetaTypeId<QVector<unsigned> >()) {
+        writeGids(variant.value<QVector<unsigned> >(), depth, rowLength);
+    } else if (type == QMetaType::QVariantList || type == QMetaType::QStringList) {
+        writeList(variant.toList(), depth);
+    } else if (type == QMetaType::QVariantMap) {
+        writeMap(variant.toMap(), depth);
+    } else if (type == QMetaType::QString || type == QMetaType::QByteArray) {
+        writeString(variant.toString());
+    } else if (type == QMetaType::Double || type == QMetaType::Float) {
+        const double value = variant.toDouble();
+        if (qIsFinite(value)) {
+            char buffer[Tiled::NumberBufferSize];
+            write(buffer, Tiled::formatNumber(buffer, value));
+        } else {
+            write("null", 4);
+        }
+    } else if (type == QMetaType::Bool) {
+        if (variant.toBool())
+            write("true", 4);
+        else
+            write("false", 5);
+    } else if (type == QMetaType::UnknownType) {
+        write("null", 4);
+    } else if (type == QMetaType::ULongLong || type == QMetaType::UInt) {
+        writeUnsigned(variant.toULongLong());
+    } else if (type == QMetaType::LongLong || type == QMetaType::Int) {
+        writeInteger(variant.toLongLong());
+    } else if (type == QMetaType::QChar) {
+        writeString(QString(variant.toChar()));
+    } else if (variant.canConvert<qlonglong>()) {
+        writeInteger(variant.toLongLong());
+    } else if (variant.canConvert<QString>()) {
+        writeString(variant.toString());
+    } else {
+        if (mError.isEmpty())
+            mError = tr("Unsupported type %1 (id: %2)")
+                    .arg(QString::fromUtf8(variant.typeName()))
+                    .arg(type);
+        write("null", 4);
+    }
+}
+
+void JsonStreamWriter::writeEscaped(const QString &string)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+
+    for (const QChar c : string) {
+        const ushort unicode = c.unicode();
+
+        switch (unicode) {
+        case '\b':  write("\\b", 2); break;
+        case '\f':  write("\\f", 2); break;
+        case '\n':  write("\\n", 2); break;
+        case '\r':  write("\\r", 2); break;
+        case '\t':  write("\\t", 2); break;
+        case '"':   write("\\\"", 2); break;
+        case '\\':  write("\\\\", 2); break;
+        case '/':   write("\\/", 2); break;
+        default:
+            if (unicode < 0x20 || unicode > 127) {
+                const char escaped[6] = {
+                    '\\', 'u',
+                    hexDigits[(unicode >> 12) & 0xF],
+                    hexDigits[(unicode >> 8) & 0xF],
+                    hexDigits[(unicode >> 4) & 0xF],
+                    hexDigits[unicode & 0xF]
+                };
+                write(escaped, 6);
+            } else {
+                write(char(unicode));
+            }
+            break;
+        }
+    }
+}
+
+void JsonStreamWriter::writeMap(const QVariantMap &map, int depth)
+{
+    if (mAutoFormatting && depth != 0) {
+        write('\n');
+        writeIndent(depth);
+        write("{\n", 2);
+    } else {
+        write('{');
+    }
+
+    for (QVariantMap::const_iterator it = map.constBegin(); it != map.constEnd(); ++it) {
+        if (it != map.constBegin()) {
+            write(',');
+            if (mAutoFormatting)
+                write('\n');
+        }
+        if (mAutoFormatting) {
+            writeIndent(depth);
+            write(' ');
+        }
+
+        writeString(it.key());
+        write(':');
+
+        // The tiles of a tile layer may be written one row per line
+        int rowLength = 0;
+        if (mAutoFormatting && mTileRowsOnSeparateLines && it.key() == QLatin1String("data"))
+            rowLength = map.value(QLatin1String("width")).toInt();
+
+        writeValue(it.value(), depth + 1, rowLength);
+    }
+
+    if (mAutoFormatting) {
+        write('\n');
+        writeIndent(depth);
+    }
+    write('}');
+}
+
+void JsonStreamWriter::writeList(const QVariantList &list, int depth)
+{
+    write('[');
+    for (int i = 0; i < list.size(); ++i) {
+        if (i != 0) {
+            write(',');
+            if (mAutoFormatting)
+                write(' ');
+        }
+        writeValue(list.at(i), depth + 1, 0);
+    }
+    write(']');
+}
+
+void JsonStreamWriter::writeGids(const QVector<unsigned> &gids, int depth,
+                                 int rowLength)
+{
+    write('[');
+    for (int i = 0; i < gids.size(); ++i) {
+        if (i != 0)
+            write(',');
+
+        if (rowLength > 0 && i % rowLength == 0) {
+            write('\n');
+            writeIndent(depth);
+        } else if (i != 0 && mAutoFormatting) {
+            write(' ');
+        }
+
+        writeUnsigned(gids.at(i));
+    }
+
+    if (rowLength > 0 && !gids.isEmpty()) {
+        write('\n');
+        writeIndent(depth - 1);
+        write(' ');
+    }
+    write(']');
+}
+
+void JsonStreamWriter::writeIndent(int depth)
+{
+    for (int i = 0; i < depth; ++i)
+        write("    ", 4);
+}
+
+void JsonStreamWriter::writeInteger(qint64 value)
+{
+    char buffer[Tiled::NumberBufferSize];
+    write(buffer, Tiled::formatInteger(buffer, value));
+}
+
+void JsonStreamWriter::writeUnsigned(quint64 value)
+{
+    char digits[20];
+    int digitCount = 0;
+    do {
+        digits[digitCount++] = char('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    if (mLength + digitCount > BufferSize)
+        flushBuffer();
+    while (digitCount > 0)
+        mData[mLength++] = digits[--digitCount];
+}
+
+void JsonStreamWriter::write(const char *data, int length)
+{
+    if (mLength + length > BufferSize) {
+        flushBuffer();
+
+        if (length >= BufferSize) {
+            if (mError.isEmpty() && mDevice->write(data, length) != length)
+                mError = mDevice->errorString();
+            return;
+        }
+    }
+
+    std::memcpy(mData + mLength, data, length);
+    mLength += length;
+}
+
+void JsonStreamWriter::flushBuffer()
+{
+    if (mLength > 0 && mError.isEmpty()) {
+        if (mDevice->write(mData, mLength) != mLength)
+            mError = mDevice->errorString();
+    }
+    mLength = 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * jsonstreamwriter.h
+ * Copyright 2026, agent <agent@local>
+ *
+ *
+ * This file is part of Tiled.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONSTREAMWRITER_H
+#define JSONSTREAMWRITER_H
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+class QIODevice;
+
+namespace Json {
+
+/**
+ * A JSON writer that writes UTF-8 to a QIODevice through a fixed-size buffer,
+ * rather than building up the whole document in memory.
+ *
+ * Besides the usual variant types, it supports arrays of global tile IDs
+ * stored as QVector<unsigned>, as produced by the MapToVariantConverter in
+ * compact mode. These are written on a single line, like any other array,
+ * unless tile rows on separate lines are requested.
+ *
+ * Doubles are written without loss of precision, and any non-ASCII or
+ * control characters in strings are escaped.
+ */
+class JsonStreamWriter
+{
+    Q_DECLARE_TR_FUNCTIONS(JsonStreamWriter)
+
+public:
+    explicit JsonStreamWriter(QIODevice *device);
+
+    void setAutoFormatting(bool autoFormatting)
+    { mAutoFormatting = autoFormatting; }
+    bool autoFormatting() const { return mAutoFormatting; }
+
+    /**
+     * Sets whether the "data" array of a tile layer is written with each
+     * row of tiles on its own line. Requires auto-formatting.
+     */
+    void setTileRowsOnSeparateLines(bool separateLines)
+    { mTileRowsOnSeparateLines = separateLines; }
+    bool tileRowsOnSeparateLines() const { return mTileRowsOnSeparateLines; }
+
+    void writeValue(const QVariant &variant);
+    void writeString(const QString &string);
+    void writeRaw(const char *text);
+
+    /**
+     * Writes any buffered data to the device. Returns whether everything
+     * was written successfully.
+     */
+    bool flush();
+
+    QString errorString() const { return mError; }
+
+private:
+    void writeValue(const QVariant &variant, int depth, int rowLength);
+    void writeEscaped(const QString &string);
+    void writeMap(const QVariantMap &map, int depth);
+    void writeList(const QVariantList &list, int depth);
+    void writeGids(const QVector<unsigned> &gids, int depth, int rowLength);
+    void writeIndent(int depth);
+    void writeInteger(qint64 value);
+    void writeUnsigned(quint64 value);
+
+    void write(char c)
+    {
+        if (mLength == BufferSize)
+            flushBuffer();
+        mData[mLength++] = c;
+    }
+
+    void write(const char *data, int length);
+    void flushBuffer();
+
+    enum { BufferSize = 64 * 1024 };
+
+    QIODevice *mDevice;
+    QByteArray mBuffer;
+    char *mData;
+    int mLength;
+    bool mAutoFormatting;
+    bool mTileRowsOnSeparateLines;
+    QString mError;
+};
+
+} // namespace Json
+
+#endif // JSONSTREAMWRITER_H
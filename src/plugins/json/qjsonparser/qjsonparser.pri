@@ -1,5 +0,0 @@
-INCLUDEPATH += $$PWD
-
-SOURCES += json.cpp
-HEADERS += json.h
-
@@ -47,6 +47,7 @@ using namespace Lua;
 using namespace Tiled;
 
 LuaPlugin::LuaPlugin()
+    : mUseAbsolutePaths(false)
 {
 }
 
@@ -59,20 +60,31 @@ bool LuaPlugin::write(const Map *map, const QString &fileName)
         return false;
     }
 
-    mMapDir = QFileInfo(fileName).path();
-
-    LuaTableWriter writer(&file);
-    writer.writeStartDocument();
-    writeMap(writer, map);
-    writer.writeEndDocument();
+    if (!writeToDevice(map, &file, fileName))
+        return false;
 
-    if (file.error() != QFile::NoError) {
+    if (!file.commit()) {
         mError = file.errorString();
         return false;
     }
 
-    if (!file.commit()) {
-        mError = file.errorString();
+    return true;
+}
+
+bool LuaPlugin::writeToDevice(const Map *map, QIODevice *device,
+                              const QString &fileName)
+{
+    // Without a file name, references are written as absolute paths
+    mUseAbsolutePaths = fileName.isEmpty();
+    mMapDir = mUseAbsolutePaths ? QDir() : QFileInfo(fileName).dir();
+
+    LuaTableWriter writer(device);
+    writer.writeStartDocument();
+    writeMap(writer, map);
+    writer.writeEndDocument();
+
+    if (writer.hasError()) {
+        mError = device->errorString();
         return false;
     }
 
@@ -132,7 +144,7 @@ void LuaPlugin::writeMap(LuaTableWriter &writer, const Map *map)
         writer.setSuppressNewlines(false);
     }
 
-    writeProperties(writer, map->properties());
+    writeProperties(writer, map->propertyList());
 
     writer.writeStartTable("tilesets");
 
@@ -167,19 +179,18 @@ void LuaPlugin::writeMap(LuaTableWriter &writer, const Map *map)
 }
 
 void LuaPlugin::writeProperties(LuaTableWriter &writer,
-                                const Properties &properties)
+                                const PropertyList &properties)
 {
     writer.writeStartTable("properties");
 
-    Properties::const_iterator it = properties.constBegin();
-    Properties::const_iterator it_end = properties.constEnd();
-    for (; it != it_end; ++it) {
-        QVariant value = toExportValue(it.value());
+    for (int i = 0; i < properties.size(); ++i) {
+        const QVariant &propertyValue = properties.valueAt(i);
+        QVariant value = toExportValue(propertyValue);
 
-        if (it.value().userType() == filePathTypeId())
-            value = mMapDir.relativeFilePath(value.toString());
+        if (propertyValue.userType() == filePathTypeId())
+            value = referenceTo(value.toString());
 
-        writer.writeQuotedKeyAndValue(it.key(), value);
+        writer.writeQuotedKeyAndValue(properties.nameAt(i), value);
     }
 
     writer.writeEndTable();
@@ -187,7 +198,7 @@ void LuaPlugin::writeProperties(LuaTableWriter &writer,
 
 static bool includeTile(const Tile *tile)
 {
-    if (!tile->properties().isEmpty())
+    if (tile->hasProperties())
         return true;
     if (!tile->imageSource().isEmpty())
         return true;
@@ -212,7 +223,7 @@ void LuaPlugin::writeTileset(LuaTableWriter &writer, const Tileset *tileset,
     writer.writeKeyAndValue("firstgid", firstGid);
 
     if (!tileset->fileName().isEmpty()) {
-        const QString rel = mMapDir.relativeFilePath(tileset->fileName());
+        const QString rel = referenceTo(tileset->fileName());
         writer.writeKeyAndValue("filename", rel);
     }
 
@@ -225,7 +236,7 @@ void LuaPlugin::writeTileset(LuaTableWriter &writer, const Tileset *tileset,
     writer.writeKeyAndValue("margin", tileset->margin());
 
     if (!tileset->imageSource().isEmpty()) {
-        const QString rel = mMapDir.relativeFilePath(tileset->imageSource());
+        const QString rel = referenceTo(tileset->imageSource());
         writer.writeKeyAndValue("image", rel);
         writer.writeKeyAndValue("imagewidth", tileset->imageWidth());
         writer.writeKeyAndValue("imageheight", tileset->imageHeight());
@@ -242,7 +253,7 @@ void LuaPlugin::writeTileset(LuaTableWriter &writer, const Tileset *tileset,
     writer.writeKeyAndValue("y", offset.y());
     writer.writeEndTable();
 
-    writeProperties(writer, tileset->properties());
+    writeProperties(writer, tileset->propertyList());
 
     writer.writeStartTable("terrains");
     for (int i = 0; i < tileset->terrainCount(); ++i) {
@@ -252,7 +263,7 @@ void LuaPlugin::writeTileset(LuaTableWriter &writer, const Tileset *tileset,
         writer.writeKeyAndValue("name", t->name());
         writer.writeKeyAndValue("tile", t->imageTileId());
 
-        writeProperties(writer, t->properties());
+        writeProperties(writer, t->propertyList());
 
         writer.writeEndTable();
     }
@@ -268,11 +279,11 @@ void LuaPlugin::writeTileset(LuaTableWriter &writer, const Tileset *tileset,
         writer.writeStartTable();
         writer.writeKeyAndValue("id", tile->id());
 
-        if (!tile->properties().isEmpty())
-            writeProperties(writer, tile->properties());
+        if (tile->hasProperties())
+            writeProperties(writer, tile->propertyList());
 
         if (!tile->imageSource().isEmpty()) {
-            const QString src = mMapDir.relativeFilePath(tile->imageSource());
+            const QString src = referenceTo(tile->imageSource());
             const QSize tileSize = tile->size();
             writer.writeKeyAndValue("image", src);
             if (!tileSize.isNull()) {
@@ -336,19 +347,25 @@ void LuaPlugin::writeTileLayer(LuaTableWriter &writer,
     writer.writeKeyAndValue("offsetx", offset.x());
     writer.writeKeyAndValue("offsety", offset.y());
 
-    writeProperties(writer, tileLayer->properties());
+    writeProperties(writer, tileLayer->propertyList());
 
     switch (format) {
     case Map::XML:
     case Map::CSV:
         writer.writeKeyAndValue("encoding", "lua");
         writer.writeStartTable("data");
-        for (int y = 0; y < tileLayer->height(); ++y) {
-            if (y > 0)
-                writer.prepareNewLine();
+        {
+            QVector<unsigned> row(tileLayer->width());
+
+            for (int y = 0; y < tileLayer->height(); ++y) {
+                if (y > 0)
+                    writer.prepareNewLine();
 
-            for (int x = 0; x < tileLayer->width(); ++x)
-                writer.writeValue(mGidMapper.cellToGid(tileLayer->cellAt(x, y)));
+                for (int x = 0; x < tileLayer->width(); ++x)
+                    row[x] = mGidMapper.cellToGid(tileLayer->cellAt(x, y));
+
+                writer.writeValues(row.constData(), row.size());
+            }
         }
         writer.writeEndTable();
         break;
@@ -392,7 +409,7 @@ void LuaPlugin::writeObjectGroup(LuaTableWriter &writer,
 
     writer.writeKeyAndValue("draworder", drawOrderToString(objectGroup->drawOrder()));
 
-    writeProperties(writer, objectGroup->properties());
+    writeProperties(writer, objectGroup->propertyList());
 
     writer.writeStartTable("objects");
     for (MapObject *mapObject : objectGroup->objects())
@@ -416,7 +433,7 @@ void LuaPlugin::writeImageLayer(LuaTableWriter &writer,
     writer.writeKeyAndValue("offsetx", offset.x());
     writer.writeKeyAndValue("offsety", offset.y());
 
-    const QString rel = mMapDir.relativeFilePath(imageLayer->imageSource());
+    const QString rel = referenceTo(imageLayer->imageSource());
     writer.writeKeyAndValue("image", rel);
 
     if (imageLayer->transparentColor().isValid()) {
@@ -424,7 +441,7 @@ void LuaPlugin::writeImageLayer(LuaTableWriter &writer,
                                 imageLayer->transparentColor().name());
     }
 
-    writeProperties(writer, imageLayer->properties());
+    writeProperties(writer, imageLayer->propertyList());
 
     writer.writeEndTable();
 }
@@ -539,7 +556,14 @@ void LuaPlugin::writeMapObject(LuaTableWriter &writer,
         writer.writeEndTable();
     }
 
-    writeProperties(writer, mapObject->properties());
+    writeProperties(writer, mapObject->propertyList());
 
     writer.writeEndTable();
 }
+
+QString LuaPlugin::referenceTo(const QString &fileName) const
+{
+    if (mUseAbsolutePaths)
+        return fileName;
+    return mMapDir.relativeFilePath(fileName);
+}
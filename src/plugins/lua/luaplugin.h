@@ -33,7 +33,7 @@
 namespace Tiled {
 class MapObject;
 class ObjectGroup;
-class Properties;
+class PropertyList;
 class TileLayer;
 class Tileset;
 }
@@ -53,13 +53,17 @@ class LUASHARED_EXPORT LuaPlugin : public Tiled::WritableMapFormat
 public:
     LuaPlugin();
 
+    Capabilities capabilities() const override { return Write | WriteToDevice; }
+
     bool write(const Tiled::Map *map, const QString &fileName) override;
+    bool writeToDevice(const Tiled::Map *map, QIODevice *device,
+                       const QString &fileName) override;
     QString nameFilter() const override;
     QString errorString() const override;
 
 private:
     void writeMap(LuaTableWriter &, const Tiled::Map *);
-    void writeProperties(LuaTableWriter &, const Tiled::Properties &);
+    void writeProperties(LuaTableWriter &, const Tiled::PropertyList &);
     void writeTileset(LuaTableWriter &, const Tiled::Tileset *, unsigned firstGid);
     void writeTileLayer(LuaTableWriter &, const Tiled::TileLayer *,
                         Tiled::Map::LayerDataFormat);
@@ -68,8 +72,11 @@ private:
     void writeImageLayer(LuaTableWriter &, const Tiled::ImageLayer *);
     void writeMapObject(LuaTableWriter &, const Tiled::MapObject *);
 
+    QString referenceTo(const QString &fileName) const;
+
     QString mError;
     QDir mMapDir;     // The directory in which the map is being saved
+    bool mUseAbsolutePaths;
     Tiled::GidMapper mGidMapper;
 };
 
@@ -33,6 +33,7 @@ LuaTableWriter::LuaTableWriter(QIODevice *device)
     , m_valueWritten(false)
     , m_error(false)
 {
+    m_buffer.reserve(BufferSize);
 }
 
 void LuaTableWriter::writeStartDocument()
@@ -44,6 +45,7 @@ void LuaTableWriter::writeEndDocument()
 {
     Q_ASSERT(m_indent == 0);
     write('\n');
+    flush();
 }
 
 void LuaTableWriter::writeStartTable()
@@ -93,6 +95,36 @@ void LuaTableWriter::writeValue(const QByteArray &value)
     m_valueWritten = true;
 }
 
+/**
+ * Writes a sequence of values, with the same result as calling writeValue
+ * for each of them. Meant for large arrays like tile layer data, for which
+ * it avoids most of the per-value overhead.
+ */
+void LuaTableWriter::writeValues(const unsigned *values, int count)
+{
+    if (count == 0)
+        return;
+
+    // Takes care of the separator and newline before the first value
+    writeValue(values[0]);
+
+    char buffer[4096];
+    int length = 0;
+
+    for (int i = 1; i < count; ++i) {
+        if (length > int(sizeof(buffer)) - Tiled::NumberBufferSize - 2) {
+            write(buffer, length);
+            length = 0;
+        }
+
+        buffer[length++] = m_valueSeparator;
+        buffer[length++] = ' ';
+        length += Tiled::formatInteger(buffer + length, values[i]);
+    }
+
+    write(buffer, length);
+}
+
 void LuaTableWriter::writeUnquotedValue(const QByteArray &value)
 {
     prepareNewValue();
@@ -134,11 +166,15 @@ void LuaTableWriter::writeQuotedKeyAndValue(const QString &key,
     write("] = ");
 
     switch (value.type()) {
+    case QVariant::Double: {
+        char buffer[Tiled::NumberBufferSize];
+        write(buffer, Tiled::formatNumber(buffer, value.toDouble()));
+        break;
+    }
     case QVariant::Int:
     case QVariant::UInt:
     case QVariant::LongLong:
     case QVariant::ULongLong:
-    case QVariant::Double:
     case QVariant::Bool:
         write(value.toString().toLatin1());
         break;
@@ -220,10 +256,20 @@ void LuaTableWriter::writeNewline()
     }
 }
 
-void LuaTableWriter::write(const char *bytes, unsigned length)
+/**
+ * Writes any buffered output to the device. Returns whether all output so
+ * far was written successfully.
+ */
+bool LuaTableWriter::flush()
 {
-    if (m_device->write(bytes, length) != length)
-        m_error = true;
+    if (!m_buffer.isEmpty()) {
+        if (m_device->write(m_buffer) != m_buffer.size())
+            m_error = true;
+
+        m_buffer.resize(0);
+    }
+
+    return !m_error;
 }
 
 } // namespace Lua
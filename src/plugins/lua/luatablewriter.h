@@ -21,6 +21,8 @@
 #ifndef LUATABLEWRITER_H
 #define LUATABLEWRITER_H
 
+#include "numberformat.h"
+
 #include <QByteArray>
 #include <QString>
 #include <QVariant>
@@ -49,6 +51,7 @@ public:
     void writeValue(unsigned value);
     void writeValue(const QByteArray &value);
     void writeValue(const QString &value);
+    void writeValues(const unsigned *values, int count);
 
     void writeUnquotedValue(const QByteArray &value);
 
@@ -69,6 +72,8 @@ public:
 
     void prepareNewLine();
 
+    bool flush();
+
     bool hasError() const { return m_error; }
 
     static QString quote(const QString &str);
@@ -83,7 +88,10 @@ private:
     void write(const QByteArray &bytes);
     void write(char c);
 
+    enum { BufferSize = 64 * 1024 };
+
     QIODevice *m_device;
+    QByteArray m_buffer;
     int m_indent;
     char m_valueSeparator;
     bool m_suppressNewlines;
@@ -92,23 +100,48 @@ private:
     bool m_error;
 };
 
+/*
+ * Numbers are formatted into a buffer on the stack, since allocating a
+ * QByteArray for each of them adds up for large maps.
+ */
+
 inline void LuaTableWriter::writeValue(int value)
-{ writeUnquotedValue(QByteArray::number(value)); }
+{
+    char buffer[Tiled::NumberBufferSize];
+    const int length = Tiled::formatInteger(buffer, value);
+    writeUnquotedValue(QByteArray::fromRawData(buffer, length));
+}
 
 inline void LuaTableWriter::writeValue(unsigned value)
-{ writeUnquotedValue(QByteArray::number(value)); }
+{
+    char buffer[Tiled::NumberBufferSize];
+    const int length = Tiled::formatInteger(buffer, value);
+    writeUnquotedValue(QByteArray::fromRawData(buffer, length));
+}
 
 inline void LuaTableWriter::writeValue(const QString &value)
 { writeUnquotedValue(quote(value).toUtf8()); }
 
 inline void LuaTableWriter::writeKeyAndValue(const QByteArray &key, int value)
-{ writeKeyAndUnquotedValue(key, QByteArray::number(value)); }
+{
+    char buffer[Tiled::NumberBufferSize];
+    const int length = Tiled::formatInteger(buffer, value);
+    writeKeyAndUnquotedValue(key, QByteArray::fromRawData(buffer, length));
+}
 
 inline void LuaTableWriter::writeKeyAndValue(const QByteArray &key, unsigned value)
-{ writeKeyAndUnquotedValue(key, QByteArray::number(value)); }
+{
+    char buffer[Tiled::NumberBufferSize];
+    const int length = Tiled::formatInteger(buffer, value);
+    writeKeyAndUnquotedValue(key, QByteArray::fromRawData(buffer, length));
+}
 
 inline void LuaTableWriter::writeKeyAndValue(const QByteArray &key, double value)
-{ writeKeyAndUnquotedValue(key, QByteArray::number(value)); }
+{
+    char buffer[Tiled::NumberBufferSize];
+    const int length = Tiled::formatNumber(buffer, value);
+    writeKeyAndUnquotedValue(key, QByteArray::fromRawData(buffer, length));
+}
 
 inline void LuaTableWriter::writeKeyAndValue(const QByteArray &key, bool value)
 { writeKeyAndUnquotedValue(key, value ? "true" : "false"); }
@@ -116,6 +149,18 @@ inline void LuaTableWriter::writeKeyAndValue(const QByteArray &key, bool value)
 inline void LuaTableWriter::writeKeyAndValue(const QByteArray &key, const QString &value)
 { writeKeyAndUnquotedValue(key, quote(value).toUtf8()); }
 
+/*
+ * Output is collected in a buffer that is only written to the device when it
+ * gets full, since the writer produces a lot of very small pieces.
+ */
+
+inline void LuaTableWriter::write(const char *bytes, unsigned length)
+{
+    m_buffer.append(bytes, length);
+    if (m_buffer.size() >= BufferSize)
+        flush();
+}
+
 inline void LuaTableWriter::write(const char *bytes)
 { write(bytes, qstrlen(bytes)); }
 
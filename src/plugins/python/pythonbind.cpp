@@ -89,6 +89,7 @@ typedef enum _PyBindGenWrapperFlags {
 #include "tilelayer.h"
 #include "objectgroup.h"
 #include "tileset.h"
+#include "gidmapper.h"
 #include <QImage>
 #include <QFileDialog>
 #include <QWidget>
@@ -2422,6 +2423,72 @@ bool loadTilesetFromFile(Tiled::Tileset *ts, QString file)
     return ts->loadFromImage(img, file);
 }
 
+/*
+ * Bulk access to the gids of a tile layer. The gids are stored as native
+ * endian 32-bit unsigned integers in row-major order, so the result can be
+ * wrapped with numpy.frombuffer(data, numpy.uint32) or memoryview(data)
+ * without copying it again.
+ */
+PyObject* tileLayerGids(Tiled::Map *map, Tiled::TileLayer *layer)
+{
+    const Tiled::GidMapper gidMapper(map->tilesets());
+    const int width = layer->width();
+    const int height = layer->height();
+
+    PyObject *data = PyByteArray_FromStringAndSize(NULL, Py_ssize_t(width) * height * sizeof(quint32));
+    if (!data)
+        return NULL;
+
+    quint32 *gids = reinterpret_cast<quint32*>(PyByteArray_AS_STRING(data));
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            *gids++ = gidMapper.cellToGid(layer->cellAt(x, y));
+
+    return data;
+}
+
+/*
+ * Replaces all cells of a tile layer by the gids in the given buffer, which
+ * needs to have the layout returned by tileLayerGids. Nothing is changed
+ * when the buffer has the wrong size or contains an invalid gid.
+ */
+bool setTileLayerGids(Tiled::Map *map, Tiled::TileLayer *layer, PyObject *data)
+{
+    Py_buffer view;
+    if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) != 0) {
+        PyErr_Clear();
+        return false;
+    }
+
+    const Tiled::GidMapper gidMapper(map->tilesets());
+    const int width = layer->width();
+    const int size = width * layer->height();
+
+    bool ok = view.len == Py_ssize_t(size) * Py_ssize_t(sizeof(quint32));
+    QVector<Tiled::Cell> cells;
+
+    if (ok) {
+        cells.resize(size);
+        const char *bytes = static_cast<const char*>(view.buf);
+
+        for (int i = 0; ok && i < size; ++i) {
+            quint32 gid;
+            memcpy(&gid, bytes + i * sizeof(quint32), sizeof(quint32));
+            cells[i] = gidMapper.gidToCell(gid, ok);
+        }
+    }
+
+    PyBuffer_Release(&view);
+
+    if (!ok)
+        return false;
+
+    for (int i = 0; i < size; ++i)
+        layer->setCell(i % width, i / width, cells.at(i));
+
+    return true;
+}
+
 #if PY_VERSION_HEX >= 0x03000000
 static struct PyModuleDef qt_moduledef = {
     PyModuleDef_HEAD_INIT,
@@ -6319,12 +6386,61 @@ _wrap_tiled_tileLayerAt(PyObject * PYBINDGEN_UNUSED(dummy), PyObject *args, PyOb
 }
 PyObject * _wrap_tiled_tileLayerAt(PyObject * PYBINDGEN_UNUSED(dummy), PyObject *args, PyObject *kwargs);
 
+
+PyObject *
+_wrap_tiled_tileLayerGids(PyObject * PYBINDGEN_UNUSED(dummy), PyObject *args, PyObject *kwargs)
+{
+    PyObject *py_retval;
+    PyObject *retval;
+    PyTiledMap *map;
+    Tiled::Map *map_ptr;
+    PyTiledTileLayer *layer;
+    Tiled::TileLayer *layer_ptr;
+    const char *keywords[] = {"map", "layer", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, (char *) "O!O!", (char **) keywords, &PyTiledMap_Type, &map, &PyTiledTileLayer_Type, &layer)) {
+        return NULL;
+    }
+    map_ptr = (map ? map->obj : NULL);
+    layer_ptr = (layer ? layer->obj : NULL);
+    retval = tileLayerGids(map_ptr, layer_ptr);
+    py_retval = Py_BuildValue((char *) "N", retval);
+    return py_retval;
+}
+PyObject * _wrap_tiled_tileLayerGids(PyObject * PYBINDGEN_UNUSED(dummy), PyObject *args, PyObject *kwargs);
+
+
+PyObject *
+_wrap_tiled_setTileLayerGids(PyObject * PYBINDGEN_UNUSED(dummy), PyObject *args, PyObject *kwargs)
+{
+    PyObject *py_retval;
+    bool retval;
+    PyTiledMap *map;
+    Tiled::Map *map_ptr;
+    PyTiledTileLayer *layer;
+    Tiled::TileLayer *layer_ptr;
+    PyObject *data;
+    const char *keywords[] = {"map", "layer", "data", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, (char *) "O!O!O", (char **) keywords, &PyTiledMap_Type, &map, &PyTiledTileLayer_Type, &layer, &data)) {
+        return NULL;
+    }
+    map_ptr = (map ? map->obj : NULL);
+    layer_ptr = (layer ? layer->obj : NULL);
+    retval = setTileLayerGids(map_ptr, layer_ptr, data);
+    py_retval = Py_BuildValue((char *) "N", PyBool_FromLong(retval));
+    return py_retval;
+}
+PyObject * _wrap_tiled_setTileLayerGids(PyObject * PYBINDGEN_UNUSED(dummy), PyObject *args, PyObject *kwargs);
+
 static PyMethodDef tiled_functions[] = {
     {(char *) "isTileLayerAt", (PyCFunction) _wrap_tiled_isTileLayerAt, METH_KEYWORDS|METH_VARARGS, NULL },
     {(char *) "loadTilesetFromFile", (PyCFunction) _wrap_tiled_loadTilesetFromFile, METH_KEYWORDS|METH_VARARGS, NULL },
     {(char *) "objectGroupAt", (PyCFunction) _wrap_tiled_objectGroupAt, METH_KEYWORDS|METH_VARARGS, NULL },
     {(char *) "isObjectGroupAt", (PyCFunction) _wrap_tiled_isObjectGroupAt, METH_KEYWORDS|METH_VARARGS, NULL },
     {(char *) "tileLayerAt", (PyCFunction) _wrap_tiled_tileLayerAt, METH_KEYWORDS|METH_VARARGS, NULL },
+    {(char *) "tileLayerGids", (PyCFunction) _wrap_tiled_tileLayerGids, METH_KEYWORDS|METH_VARARGS, NULL },
+    {(char *) "setTileLayerGids", (PyCFunction) _wrap_tiled_setTileLayerGids, METH_KEYWORDS|METH_VARARGS, NULL },
     {NULL, NULL, 0, NULL}
 };
 /* --- classes --- */
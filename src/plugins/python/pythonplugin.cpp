@@ -22,9 +22,9 @@
 
 #include "map.h"
 
-#include <QDateTime>
 #include <QDir>
 #include <QDirIterator>
+#include <QElapsedTimer>
 
 namespace Python {
 
@@ -39,9 +39,47 @@ static void handleError()
         PyErr_Print();
 }
 
+/**
+ * Holds the Python global interpreter lock for the lifetime of the object.
+ * Needed around all use of the Python API, since map formats may also be
+ * used from worker threads.
+ */
+class GilLocker
+{
+public:
+    GilLocker() : mState(PyGILState_Ensure()) {}
+    ~GilLocker() { PyGILState_Release(mState); }
+
+private:
+    PyGILState_STATE mState;
+};
+
+/**
+ * Implements tiled.reportProgress(value, maximum), which scripts can call
+ * to report their progress while reading or writing a map.
+ */
+static PyObject *reportProgress(PyObject *self, PyObject *args)
+{
+    int value, maximum;
+    if (!PyArg_ParseTuple(args, "ii:reportProgress", &value, &maximum))
+        return nullptr;
+
+    void *plugin = PyCapsule_GetPointer(self, nullptr);
+    static_cast<PythonPlugin*>(plugin)->reportProgress(value, maximum);
+
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef reportProgressMethod = {
+    "reportProgress", reportProgress, METH_VARARGS,
+    "reportProgress(value, maximum)"
+};
+
 PythonPlugin::PythonPlugin()
     : mScriptDir(QDir::homePath() + "/.tiled")
     , mPluginClass(nullptr)
+    , mMainThreadState(nullptr)
+    , mActiveCalls(0)
 {
     mReloadTimer.setSingleShot(true);
     mReloadTimer.setInterval(1000);
@@ -52,6 +90,9 @@ PythonPlugin::PythonPlugin()
 
 PythonPlugin::~PythonPlugin()
 {
+    if (mMainThreadState)
+        PyEval_RestoreThread(mMainThreadState);
+
     for (const ScriptEntry &script : mScripts) {
         Py_DECREF(script.module);
         Py_DECREF(script.mapFormat->pythonClass());
@@ -72,13 +113,13 @@ void PythonPlugin::initialize()
         Py_NoUserSiteDirectory = 1;
 
         Py_Initialize();
+        PyEval_InitThreads();
         inittiled();
 
         // Get reference to base class to find its extensions later on
         PyObject *pmod = PyImport_ImportModule("tiled");
         if (pmod) {
             PyObject *tiledPlugin = PyObject_GetAttrString(pmod, "Plugin");
-            Py_DECREF(pmod);
 
             if (tiledPlugin) {
                 if (PyCallable_Check(tiledPlugin)) {
@@ -87,11 +128,22 @@ void PythonPlugin::initialize()
                     Py_DECREF(tiledPlugin);
                 }
             }
+
+            PyObject *self = PyCapsule_New(this, nullptr, nullptr);
+            PyObject *function = PyCFunction_New(&reportProgressMethod, self);
+            Py_XDECREF(self);
+            if (function) {
+                PyObject_SetAttrString(pmod, "reportProgress", function);
+                Py_DECREF(function);
+            }
+
+            Py_DECREF(pmod);
         }
 
         if (!mPluginClass) {
             log(Tiled::LoggingInterface::ERROR, "Can't find tiled.Plugin baseclass\n");
             handleError();
+            mMainThreadState = PyEval_SaveThread();
             return;
         }
 
@@ -118,6 +170,9 @@ void PythonPlugin::initialize()
                            .arg(mScriptDir).toUtf8().constData());
 
         log(QString("-- Added %1 to path\n").arg(mScriptDir));
+
+        // Release the GIL, so that scripts can run in other threads
+        mMainThreadState = PyEval_SaveThread();
     }
 
     reloadModules();
@@ -142,10 +197,34 @@ void PythonPlugin::log(const QString &msg)
 }
 
 /**
- * (Re)load modules in the script directory
+ * Reports progress on behalf of the format that is running a script in the
+ * calling thread. Requires the GIL to be held.
+ */
+void PythonPlugin::reportProgress(int value, int maximum)
+{
+    PyThreadState *threadState = PyThreadState_Get();
+
+    for (const ScriptEntry &script : mScripts) {
+        if (script.mapFormat && script.mapFormat->isRunningIn(threadState)) {
+            emit script.mapFormat->progressChanged(value, maximum);
+            break;
+        }
+    }
+}
+
+/**
+ * (Re)load modules in the script directory that were added or changed
  */
 void PythonPlugin::reloadModules()
 {
+    GilLocker gil;
+
+    // Formats can't be replaced while one of them is running a script
+    if (mActiveCalls > 0) {
+        mReloadTimer.start();
+        return;
+    }
+
     log(tr("Reloading Python scripts"));
 
     const QStringList pyfilter("*.py");
@@ -154,10 +233,17 @@ void PythonPlugin::reloadModules()
     while (iter.hasNext()) {
         iter.next();
 
-        QString name = iter.fileInfo().baseName();
+        const QFileInfo fileInfo = iter.fileInfo();
+        const QString name = fileInfo.baseName();
+        const QDateTime lastModified = fileInfo.lastModified();
+
+        auto it = mScripts.constFind(name);
+        if (it != mScripts.constEnd() && it->lastModified == lastModified)
+            continue;
 
         ScriptEntry script = mScripts.take(name);
         script.name = name;
+        script.lastModified = lastModified;
 
         // Throw away any existing class reference
         if (script.mapFormat) {
@@ -217,6 +303,9 @@ bool PythonPlugin::loadOrReloadModule(ScriptEntry &script)
 {
     const QByteArray name = script.name.toUtf8();
 
+    QElapsedTimer timer;
+    timer.start();
+
     if (script.module) {
         PySys_WriteStdout("-- Reloading %s\n", name.constData());
 
@@ -239,6 +328,8 @@ bool PythonPlugin::loadOrReloadModule(ScriptEntry &script)
         return false;
     }
 
+    log(tr("-- Loaded %1 in %2 ms").arg(script.name).arg(timer.elapsed()));
+
     if (script.mapFormat) {
         script.mapFormat->setPythonClass(pluginClass);
     } else {
@@ -257,26 +348,49 @@ PythonMapFormat::PythonMapFormat(const QString &scriptFile,
     , mClass(nullptr)
     , mPlugin(plugin)
     , mScriptFile(scriptFile)
+    , mThreadState(nullptr)
+    , mCancelled(false)
+    , mCallPending(false)
 {
     setPythonClass(class_);
 }
 
 Tiled::Map *PythonMapFormat::read(const QString &fileName)
 {
+    GilLocker gil;
     mError = QString();
 
     mPlugin.log(tr("-- Using script %1 to read %2").arg(mScriptFile, fileName));
 
-    if (!PyObject_HasAttrString(mClass, "read")) {
-        mError = "Please define class that extends tiled.Plugin and "
-                "has @classmethod read(cls, filename)";
-        return nullptr;
+    QElapsedTimer timer;
+    timer.start();
+
+    PyObject *pluginClass = beginCall();
+    PyObject *pinst = nullptr;
+
+    if (pluginClass) {
+        if (!PyObject_HasAttrString(pluginClass, "read")) {
+            endCall(pluginClass);
+            mError = "Please define class that extends tiled.Plugin and "
+                    "has @classmethod read(cls, filename)";
+            return nullptr;
+        }
+
+        pinst = PyObject_CallMethod(pluginClass, (char *)"read",
+                                    (char *)"(s)", fileName.toUtf8().constData());
     }
-    PyObject *pinst = PyObject_CallMethod(mClass, (char *)"read",
-                                          (char *)"(s)", fileName.toUtf8().constData());
+
+    const bool cancelled = endCall(pluginClass);
+
+    mPlugin.log(tr("-- Script %1 read %2 in %3 ms")
+                .arg(mScriptFile, fileName).arg(timer.elapsed()));
 
     Tiled::Map *ret = nullptr;
-    if (!pinst) {
+    if (cancelled) {
+        Py_XDECREF(pinst);
+        mError = tr("Reading was cancelled.");
+        return nullptr;
+    } else if (!pinst) {
         PySys_WriteStderr("** Uncaught exception in script **\n");
     } else {
         _wrap_convert_py2c__Tiled__Map___star__(pinst, &ret);
@@ -291,19 +405,40 @@ Tiled::Map *PythonMapFormat::read(const QString &fileName)
 
 bool PythonMapFormat::write(const Tiled::Map *map, const QString &fileName)
 {
+    GilLocker gil;
     mError = QString();
 
     mPlugin.log(tr("-- Using script %1 to write %2").arg(mScriptFile, fileName));
 
-    PyObject *pmap = _wrap_convert_c2py__Tiled__Map_const(map);
-    if (!pmap)
-        return false;
-    PyObject *pinst = PyObject_CallMethod(mClass,
-                                          (char *)"write", (char *)"(Ns)",
-                                          pmap,
-                                          fileName.toUtf8().constData());
+    QElapsedTimer timer;
+    timer.start();
 
-    if (!pinst) {
+    PyObject *pluginClass = beginCall();
+    PyObject *pinst = nullptr;
+
+    if (pluginClass) {
+        PyObject *pmap = _wrap_convert_c2py__Tiled__Map_const(map);
+        if (!pmap) {
+            endCall(pluginClass);
+            return false;
+        }
+
+        pinst = PyObject_CallMethod(pluginClass,
+                                    (char *)"write", (char *)"(Ns)",
+                                    pmap,
+                                    fileName.toUtf8().constData());
+    }
+
+    const bool cancelled = endCall(pluginClass);
+
+    mPlugin.log(tr("-- Script %1 wrote %2 in %3 ms")
+                .arg(mScriptFile, fileName).arg(timer.elapsed()));
+
+    if (cancelled) {
+        Py_XDECREF(pinst);
+        mError = tr("Writing was cancelled.");
+        return false;
+    } else if (!pinst) {
         PySys_WriteStderr("** Uncaught exception in script **\n");
         mError = tr("Uncaught exception in script. Please check console.");
     } else {
@@ -320,6 +455,8 @@ bool PythonMapFormat::write(const Tiled::Map *map, const QString &fileName)
 
 bool PythonMapFormat::supportsFile(const QString &fileName) const
 {
+    GilLocker gil;
+
     if (!PyObject_HasAttrString(mClass, "supportsFile"))
         return false;
 
@@ -339,6 +476,7 @@ bool PythonMapFormat::supportsFile(const QString &fileName) const
 
 QString PythonMapFormat::nameFilter() const
 {
+    GilLocker gil;
     QString ret;
 
     // find fun
@@ -368,10 +506,85 @@ QString PythonMapFormat::errorString() const
     return mError;
 }
 
+/**
+ * Interrupts a running read or write by raising KeyboardInterrupt in the
+ * thread running the script. When the script did not start yet, the request
+ * is remembered and the script is not run at all.
+ */
+void PythonMapFormat::cancel()
+{
+    GilLocker gil;
+
+    if (mCancelled || (!mThreadState && !mCallPending))
+        return;
+
+    mCancelled = true;
+    if (mThreadState)
+        PyThreadState_SetAsyncExc(mThreadState->thread_id, PyExc_KeyboardInterrupt);
+}
+
+/**
+ * Counts the upcoming call as active already, so that the modules are not
+ * reloaded before the worker thread gets to run the script.
+ */
+void PythonMapFormat::aboutToRunInThread()
+{
+    GilLocker gil;
+
+    mCallPending = true;
+    mCancelled = false;
+    ++mPlugin.mActiveCalls;
+}
+
+/**
+ * Marks the start of a script call from the current thread. Returns a new
+ * reference to the plugin class, so that a module reload can't pull it away
+ * while the script is running, or null when the call was already cancelled.
+ * Either way, endCall() needs to be called.
+ */
+PyObject *PythonMapFormat::beginCall()
+{
+    // Calls that were not announced are counted here
+    if (mCallPending)
+        mCallPending = false;
+    else
+        ++mPlugin.mActiveCalls;
+
+    if (mCancelled)
+        return nullptr;
+
+    mThreadState = PyThreadState_Get();
+
+    Py_INCREF(mClass);
+    return mClass;
+}
+
+/**
+ * Marks the end of a script call. Returns whether the call was cancelled,
+ * in which case the resulting exception is cleared.
+ */
+bool PythonMapFormat::endCall(PyObject *class_)
+{
+    const bool cancelled = mCancelled;
+
+    if (cancelled && mThreadState) {
+        // Drop the exception in case the script finished before it was raised
+        PyThreadState_SetAsyncExc(mThreadState->thread_id, nullptr);
+        PyErr_Clear();
+    }
+
+    Py_XDECREF(class_);
+    --mPlugin.mActiveCalls;
+    mThreadState = nullptr;
+    mCancelled = false;
+
+    return cancelled;
+}
+
 void PythonMapFormat::setPythonClass(PyObject *class_)
 {
     mClass = class_;
-    mCapabilities = NoCapability;
+    mCapabilities = Tiled::MapFormat::Threaded;
 
     // @classmethod nameFilter(cls)
     if (PyObject_HasAttrString(mClass, "nameFilter")) {
@@ -31,6 +31,7 @@
 #include "mapformat.h"
 #include "plugin.h"
 
+#include <QDateTime>
 #include <QFileSystemWatcher>
 #include <QMap>
 #include <QObject>
@@ -52,6 +53,7 @@ struct ScriptEntry
     {}
 
     QString name;
+    QDateTime lastModified;
     PyObject *module;
     PythonMapFormat *mapFormat;
 };
@@ -71,6 +73,8 @@ public:
     void log(Tiled::LoggingInterface::OutputType type, const QString &msg);
     void log(const QString &msg);
 
+    void reportProgress(int value, int maximum);
+
 private slots:
     void reloadModules();
 
@@ -81,11 +85,15 @@ private:
     QString mScriptDir;
     QMap<QString,ScriptEntry> mScripts;
     PyObject *mPluginClass;
+    PyThreadState *mMainThreadState;
+    int mActiveCalls;   // protected by the GIL
 
     QFileSystemWatcher mFileSystemWatcher;
     QTimer mReloadTimer;
 
     Tiled::LoggingInterface mLogger;
+
+    friend class PythonMapFormat;
 };
 
 
@@ -120,15 +128,27 @@ public:
     QString nameFilter() const override;
     QString errorString() const override;
 
+    void cancel() override;
+    void aboutToRunInThread() override;
+
     PyObject *pythonClass() const { return mClass; }
     void setPythonClass(PyObject *class_);
 
+    bool isRunningIn(PyThreadState *threadState) const
+    { return mThreadState == threadState; }
+
 private:
+    PyObject *beginCall();
+    bool endCall(PyObject *class_);
+
     PyObject *mClass;
     PythonPlugin &mPlugin;
     QString mScriptFile;
     QString mError;
     Capabilities mCapabilities;
+    PyThreadState *mThreadState;
+    bool mCancelled;
+    bool mCallPending;  // announced by aboutToRunInThread()
 };
 
 } // namespace Python
@@ -30,6 +30,7 @@ mod.add_include('"imagelayer.h"')
 mod.add_include('"tilelayer.h"')
 mod.add_include('"objectgroup.h"')
 mod.add_include('"tileset.h"')
+mod.add_include('"gidmapper.h"')
 
 mod.header.writeln('#pragma GCC diagnostic ignored "-Wmissing-field-initializers"')
 
@@ -285,6 +286,83 @@ bool loadTilesetFromFile(Tiled::Tileset *ts, QString file)
 }
 """)
 
+mod.add_function('tileLayerGids',
+    retval('PyObject*', caller_owns_return=True),
+    [param('Tiled::Map*','map',transfer_ownership=False),
+     param('Tiled::TileLayer*','layer',transfer_ownership=False)])
+mod.add_function('setTileLayerGids', 'bool',
+    [param('Tiled::Map*','map',transfer_ownership=False),
+     param('Tiled::TileLayer*','layer',transfer_ownership=False),
+     param('PyObject*','data',transfer_ownership=False)])
+
+mod.body.writeln("""
+/*
+ * Bulk access to the gids of a tile layer. The gids are stored as native
+ * endian 32-bit unsigned integers in row-major order, so the result can be
+ * wrapped with numpy.frombuffer(data, numpy.uint32) or memoryview(data)
+ * without copying it again.
+ */
+PyObject* tileLayerGids(Tiled::Map *map, Tiled::TileLayer *layer)
+{
+    const Tiled::GidMapper gidMapper(map->tilesets());
+    const int width = layer->width();
+    const int height = layer->height();
+
+    PyObject *data = PyByteArray_FromStringAndSize(NULL, Py_ssize_t(width) * height * sizeof(quint32));
+    if (!data)
+        return NULL;
+
+    quint32 *gids = reinterpret_cast<quint32*>(PyByteArray_AS_STRING(data));
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            *gids++ = gidMapper.cellToGid(layer->cellAt(x, y));
+
+    return data;
+}
+
+/*
+ * Replaces all cells of a tile layer by the gids in the given buffer, which
+ * needs to have the layout returned by tileLayerGids. Nothing is changed
+ * when the buffer has the wrong size or contains an invalid gid.
+ */
+bool setTileLayerGids(Tiled::Map *map, Tiled::TileLayer *layer, PyObject *data)
+{
+    Py_buffer view;
+    if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) != 0) {
+        PyErr_Clear();
+        return false;
+    }
+
+    const Tiled::GidMapper gidMapper(map->tilesets());
+    const int width = layer->width();
+    const int size = width * layer->height();
+
+    bool ok = view.len == Py_ssize_t(size) * Py_ssize_t(sizeof(quint32));
+    QVector<Tiled::Cell> cells;
+
+    if (ok) {
+        cells.resize(size);
+        const char *bytes = static_cast<const char*>(view.buf);
+
+        for (int i = 0; ok && i < size; ++i) {
+            quint32 gid;
+            memcpy(&gid, bytes + i * sizeof(quint32), sizeof(quint32));
+            cells[i] = gidMapper.gidToCell(gid, ok);
+        }
+    }
+
+    PyBuffer_Release(&view);
+
+    if (!ok)
+        return false;
+
+    for (int i = 0; i < size; ++i)
+        layer->setCell(i % width, i / width, cells.at(i));
+
+    return true;
+}
+""")
+
 """
  C++ class PythonScript is seen as Tiled.Plugin from Python script
  (naming describes the opposite side from either perspective)
@@ -27,11 +27,17 @@
 
 #include <QGuiApplication>
 
+#include <QCryptographicHash>
 #include <QDebug>
+#include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
 #include <QPainter>
+#include <QRunnable>
+#include <QSet>
 #include <QStringList>
+#include <QThreadPool>
 
 using namespace Tiled;
 
@@ -43,13 +49,18 @@ struct CommandLineOptions {
         , showVersion(false)
         , overwrite(false)
         , embedImage(false)
+        , headless(false)
+        , jobs(0)
     {}
 
     bool showHelp;
     bool showVersion;
     bool overwrite;
     bool embedImage;
+    bool headless;
+    int jobs;
     QString target;
+    QString cacheDirectory;
     QStringList sources;
     QStringList terrainPriority;
     QList<QStringList> combineList;
@@ -68,6 +79,11 @@ static void showHelp()
             "     --overwrite   : Target is overwritten rather than extended.\n"
             "  -e --embed-image : Tile images will be embedded in the TSX file instead\n"
             "                     of being saved as a separated PNG file.\n"
+            "     --headless    : Run without a windowing system.\n"
+            "  -j --jobs N      : Number of threads used to generate tiles (defaults to\n"
+            "                     the number of CPU cores).\n"
+            "     --cache DIR   : Store generated tiles in DIR and reuse them when the\n"
+            "                     same combination of images is generated again.\n"
             "  -c --combine T1[ T2 [Tn ...]]\n"
             "                   : Specify the terrains to combine together (all combinations).\n"
             "  -s --source TS1[ TS2 [TSn ...]]\n"
@@ -166,6 +182,25 @@ static bool parseCommandLineArguments(CommandLineOptions &options)
             }
         } else if (arg == QLatin1String("--overwrite")) {
             options.overwrite = true;
+        } else if (arg == QLatin1String("--headless")) {
+            options.headless = true;
+        } else if (arg == QLatin1String("-j")
+                || arg == QLatin1String("--jobs")) {
+            i++;
+            bool ok = false;
+            if (i < arguments.size())
+                options.jobs = arguments.at(i).toInt(&ok);
+            if (!ok || options.jobs < 1) {
+                qWarning() << "Invalid argument to" << arg << "option";
+                return false;
+            }
+        } else if (arg == QLatin1String("--cache")) {
+            i++;
+            if (i >= arguments.size()) {
+                qWarning() << "Missing argument to" << arg << "option";
+                return false;
+            }
+            options.cacheDirectory = arguments.at(i);
         } else if (arg == QLatin1String("-e")
                 || arg == QLatin1String("--embed-image")) {
             options.embedImage = true;
@@ -270,6 +305,14 @@ struct TileTerrainNames
         return list;
     }
 
+    bool operator == (const TileTerrainNames &other) const
+    {
+        return topLeft == other.topLeft &&
+                topRight == other.topRight &&
+                bottomLeft == other.bottomLeft &&
+                bottomRight == other.bottomRight;
+    }
+
     bool operator < (const TileTerrainNames &other) const
     {
         if (topLeft != other.topLeft)
@@ -288,6 +331,15 @@ struct TileTerrainNames
     QString bottomRight;
 };
 
+static uint qHash(const TileTerrainNames &names, uint seed = 0)
+{
+    seed ^= qHash(names.topLeft) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= qHash(names.topRight) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= qHash(names.bottomLeft) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= qHash(names.bottomRight) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+}
+
 struct TerrainLessThan
 {
     bool operator () (const QString &terrainA, const QString &terrainB) const
@@ -325,9 +377,112 @@ static bool isEmpty(const QImage &image)
     return true;
 }
 
+/**
+ * A tile that needs to be generated by drawing a number of tile images on
+ * top of each other.
+ */
+struct GenerateTileJob
+{
+    QVector<QImage> layers;
+    QImage result;
+};
+
+/**
+ * Returns a key that identifies the result of drawing the given layers, based
+ * on their contents.
+ */
+static QByteArray cacheKey(const QSize &tileSize, const QVector<QImage> &layers)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(tileSize.width()) + 'x' +
+                 QByteArray::number(tileSize.height()));
+
+    for (const QImage &layer : layers) {
+        Q_ASSERT(layer.format() == QImage::Format_ARGB32);
+
+        hash.addData(':' + QByteArray::number(layer.width()) + 'x' +
+                     QByteArray::number(layer.height()));
+
+        for (int y = 0; y < layer.height(); ++y)
+            hash.addData(reinterpret_cast<const char*>(layer.constScanLine(y)),
+                         layer.width() * 4);
+    }
+
+    return hash.result().toHex();
+}
+
+/**
+ * Generates a tile image on a worker thread. Only QImage is used here, since
+ * QPixmap may only be used on the GUI thread.
+ */
+class GenerateTileTask : public QRunnable
+{
+public:
+    GenerateTileTask(GenerateTileJob &job,
+                     const QSize &tileSize,
+                     const QString &cacheDirectory)
+        : mJob(job)
+        , mTileSize(tileSize)
+        , mCacheDirectory(cacheDirectory)
+    {}
+
+    void run() override
+    {
+        QString cacheFileName;
+
+        if (!mCacheDirectory.isEmpty()) {
+            const QString key = QString::fromLatin1(cacheKey(mTileSize, mJob.layers));
+            cacheFileName = QDir(mCacheDirectory).filePath(key + QLatin1String(".png"));
+
+            QImage cached;
+            if (cached.load(cacheFileName, "PNG") && cached.size() == mTileSize) {
+                mJob.result = cached.convertToFormat(QImage::Format_ARGB32);
+                return;
+            }
+        }
+
+        QImage tileImage(mTileSize, QImage::Format_ARGB32);
+        tileImage.fill(Qt::transparent);
+
+        QPainter painter(&tileImage);
+        for (const QImage &layer : mJob.layers)
+            painter.drawImage(0, 0, layer);
+        painter.end();
+
+        if (!cacheFileName.isEmpty() && !tileImage.save(cacheFileName, "PNG"))
+            qWarning() << "Failed to write" << cacheFileName;
+
+        mJob.result = tileImage;
+    }
+
+private:
+    GenerateTileJob &mJob;
+    const QSize mTileSize;
+    const QString mCacheDirectory;
+};
+
+/**
+ * Returns the image of the given tile as a QImage, converting it only once.
+ */
+static QImage tileImage(Tile *tile, QHash<Tile*, QImage> &images)
+{
+    auto it = images.find(tile);
+    if (it == images.end()) {
+        const QImage image = tile->image().toImage().convertToFormat(QImage::Format_ARGB32);
+        it = images.insert(tile, image);
+    }
+    return it.value();
+}
 
 int main(int argc, char *argv[])
 {
+    // Check for headless mode before the application is created, since it
+    // determines the platform plugin to use
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--headless") == 0 && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     QGuiApplication a(argc, argv);
 
     a.setOrganizationDomain(QLatin1String("mapeditor.org"));
@@ -418,7 +573,7 @@ int main(int argc, char *argv[])
     }
 
     // Set up a mapping from terrain to tile, for quick lookup
-    QMap<TileTerrainNames, Tile*> terrainToTile;
+    QHash<TileTerrainNames, Tile*> terrainToTile;
     foreach (const SharedTileset &tileset, sources)
         foreach (Tile *tile, tileset->tiles())
             if (tile->terrain() != 0xFFFFFFFF)
@@ -520,33 +675,50 @@ int main(int argc, char *argv[])
         }
     }
 
-    // Go through each combination of terrains and add the tile to the target
-    // tileset if it's not in there yet.
-    foreach (TileTerrainNames terrainNames, process) {
+    if (options.jobs > 0)
+        QThreadPool::globalInstance()->setMaxThreadCount(options.jobs);
+
+    if (!options.cacheDirectory.isEmpty() && !QDir().mkpath(options.cacheDirectory))
+        qFatal("Could not create cache directory %s", qPrintable(options.cacheDirectory));
+
+    // Go through each combination of terrains and determine the tiles that
+    // need to be added to the target tileset.
+    struct NewTile
+    {
+        TileTerrainNames terrainNames;
+        QPixmap image;          // when copied from another tileset
+        int job;                // when generated, otherwise -1
+    };
+
+    QVector<NewTile> newTiles;
+    QVector<GenerateTileJob> jobs;
+    QSet<TileTerrainNames> scheduled;
+    QHash<Tile*, QImage> tileImages;
+
+    foreach (const TileTerrainNames &terrainNames, process) {
+        if (scheduled.contains(terrainNames))
+            continue;
+
         Tile *tile = terrainToTile.value(terrainNames);
 
         if (tile && tile->tileset() == targetTileset)
             continue;
 
-        QPixmap image;
+        NewTile newTile;
+        newTile.terrainNames = terrainNames;
+        newTile.job = -1;
 
         if (!tile) {
             qWarning() << "Generating" << terrainNames;
 
-            // Start a new image
-            QImage tileImage = QImage(targetTileset->tileWidth(),
-                                      targetTileset->tileHeight(),
-                                      QImage::Format_ARGB32);
-            tileImage.fill(Qt::transparent);
-            QPainter painter(&tileImage);
+            GenerateTileJob job;
 
             QStringList terrainList = terrainNames.terrainList();
             qSort(terrainList.begin(), terrainList.end(), lessThan);
 
             // Draw the lowest terrain to avoid pixel gaps
             QString baseTerrain = terrainList.first();
-            QPixmap baseImage = terrains[baseTerrain]->imageTile()->image();
-            painter.drawPixmap(0, 0, baseImage);
+            job.layers.append(tileImage(terrains[baseTerrain]->imageTile(), tileImages));
 
             foreach (const QString &terrainName, terrainList) {
                 TileTerrainNames filtered = terrainNames.filter(terrainName);
@@ -556,20 +728,39 @@ int main(int argc, char *argv[])
                     continue;
                 }
 
-                painter.drawPixmap(0, 0, tile->image());
+                job.layers.append(tileImage(tile, tileImages));
             }
 
-            image = QPixmap::fromImage(tileImage);
+            newTile.job = jobs.size();
+            jobs.append(job);
         } else {
             qWarning() << "Copying" << terrainNames << "from"
                        << QFileInfo(tile->tileset()->fileName()).fileName();
 
-            image = tile->image();
+            newTile.image = tile->image();
         }
 
-        Tile *newTile = targetTileset->addTile(image);
-        newTile->setTerrain(terrainNames.toTerrain(*targetTileset));
-        terrainToTile.insert(terrainNames, newTile);
+        scheduled.insert(terrainNames);
+        newTiles.append(newTile);
+    }
+
+    // Generate the tile images in parallel
+    const QSize tileSize = targetTileset->tileSize();
+    QThreadPool *threadPool = QThreadPool::globalInstance();
+    for (GenerateTileJob &job : jobs)
+        threadPool->start(new GenerateTileTask(job, tileSize, options.cacheDirectory));
+    threadPool->waitForDone();
+
+    // Add the tiles in a fixed order, so that the tile IDs don't depend on
+    // the order in which the jobs finished
+    for (const NewTile &newTile : newTiles) {
+        const QPixmap image = newTile.job == -1
+                ? newTile.image
+                : QPixmap::fromImage(jobs.at(newTile.job).result);
+
+        Tile *tile = targetTileset->addTile(image);
+        tile->setTerrain(newTile.terrainNames.toTerrain(*targetTileset));
+        terrainToTile.insert(newTile.terrainNames, tile);
     }
 
     if (targetTileset->tileCount() == 0)
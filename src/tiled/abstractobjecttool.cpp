@@ -130,12 +130,7 @@ ObjectGroup *AbstractObjectTool::currentObjectGroup() const
 
 MapObjectItem *AbstractObjectTool::topMostObjectItemAt(QPointF pos) const
 {
-    const QList<QGraphicsItem *> &items = mMapScene->items(pos);
-    for (QGraphicsItem *item : items) {
-        if (MapObjectItem *objectItem = qgraphicsitem_cast<MapObjectItem*>(item))
-            return objectItem;
-    }
-    return nullptr;
+    return mMapScene->topMostObjectItemAt(pos);
 }
 
 void AbstractObjectTool::duplicateObjects()
@@ -27,6 +27,8 @@
 
 #include <QCoreApplication>
 
+#include <algorithm>
+
 using namespace Tiled;
 using namespace Tiled::Internal;
 
@@ -88,3 +90,64 @@ RemoveMapObject::RemoveMapObject(MapDocument *mapDocument,
 {
     setText(QCoreApplication::translate("Undo Commands", "Remove Object"));
 }
+
+
+RemoveMapObjects::RemoveMapObjects(MapDocument *mapDocument,
+                                   const QList<MapObject *> &mapObjects,
+                                   QUndoCommand *parent)
+    : QUndoCommand(parent)
+    , mMapDocument(mapDocument)
+    , mMapObjects(mapObjects)
+    , mOwnsObjects(false)
+{
+    setText(QCoreApplication::translate("Undo Commands",
+                                        "Remove %n Object(s)",
+                                        nullptr, mapObjects.size()));
+}
+
+RemoveMapObjects::~RemoveMapObjects()
+{
+    if (mOwnsObjects)
+        qDeleteAll(mMapObjects);
+}
+
+void RemoveMapObjects::undo()
+{
+    MapObjectModel *mapObjectModel = mMapDocument->mapObjectModel();
+
+    // The entries are sorted by object group and index, so the objects of
+    // each group can be inserted back in one go
+    int i = 0;
+    while (i < mEntries.size()) {
+        ObjectGroup *objectGroup = mEntries.at(i).objectGroup;
+        QList<int> indexes;
+        QList<MapObject*> mapObjects;
+
+        for (; i < mEntries.size() && mEntries.at(i).objectGroup == objectGroup; ++i) {
+            indexes.append(mEntries.at(i).index);
+            mapObjects.append(mEntries.at(i).mapObject);
+        }
+
+        mapObjectModel->insertObjects(objectGroup, indexes, mapObjects);
+    }
+
+    mOwnsObjects = false;
+}
+
+void RemoveMapObjects::redo()
+{
+    // Remember where each object was, to be able to put it back
+    mEntries.clear();
+    mEntries.reserve(mMapObjects.size());
+
+    for (MapObject *mapObject : mMapObjects) {
+        ObjectGroup *objectGroup = mapObject->objectGroup();
+        const Entry entry = { objectGroup, objectGroup->indexOf(mapObject), mapObject };
+        mEntries.append(entry);
+    }
+
+    std::sort(mEntries.begin(), mEntries.end());
+
+    mMapDocument->mapObjectModel()->removeObjects(mMapObjects);
+    mOwnsObjects = true;
+}
@@ -21,7 +21,9 @@
 #ifndef ADDREMOVEMAPOBJECT_H
 #define ADDREMOVEMAPOBJECT_H
 
+#include <QList>
 #include <QUndoCommand>
+#include <QVector>
 
 namespace Tiled {
 
@@ -89,6 +91,44 @@ public:
     { removeObject(); }
 };
 
+/**
+ * Undo command that removes a number of objects from a map.
+ *
+ * Unlike a macro of RemoveMapObject commands, the objects are removed from
+ * each object group in one go, which keeps deleting many objects fast.
+ */
+class RemoveMapObjects : public QUndoCommand
+{
+public:
+    RemoveMapObjects(MapDocument *mapDocument,
+                     const QList<MapObject*> &mapObjects,
+                     QUndoCommand *parent = nullptr);
+    ~RemoveMapObjects();
+
+    void undo() override;
+    void redo() override;
+
+private:
+    struct Entry
+    {
+        ObjectGroup *objectGroup;
+        int index;
+        MapObject *mapObject;
+
+        bool operator<(const Entry &other) const
+        {
+            if (objectGroup != other.objectGroup)
+                return objectGroup < other.objectGroup;
+            return index < other.index;
+        }
+    };
+
+    MapDocument *mMapDocument;
+    QList<MapObject*> mMapObjects;
+    QVector<Entry> mEntries;
+    bool mOwnsObjects;
+};
+
 } // namespace Internal
 } // namespace Tiled
 
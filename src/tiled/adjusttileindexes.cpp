@@ -167,17 +167,17 @@ AdjustTileMetaData::AdjustTileMetaData(MapDocument *mapDocument,
     };
 
     auto applyMetaData = [&](Tile *toTile,
-                             const Properties &properties,
+                             const PropertyList &properties,
                              unsigned terrain,
                              float probability,
                              ObjectGroup *objectGroup,
                              const QVector<Frame> &frames)
     {
-        if (properties != toTile->properties()) {
+        if (properties != toTile->propertyList()) {
             new ChangeProperties(mapDocument,
                                  QCoreApplication::translate("MapDocument", "Tile"),
                                  toTile,
-                                 properties,
+                                 properties.toProperties(),
                                  this);
         }
 
@@ -217,7 +217,7 @@ AdjustTileMetaData::AdjustTileMetaData(MapDocument *mapDocument,
             objectGroup = static_cast<ObjectGroup*>(fromTile->objectGroup()->clone());
 
         applyMetaData(toTile,
-                      fromTile->properties(),
+                      fromTile->propertyList(),
                       fromTile->terrain(),
                       fromTile->probability(),
                       objectGroup,
@@ -241,7 +241,7 @@ AdjustTileMetaData::AdjustTileMetaData(MapDocument *mapDocument,
     QSetIterator<Tile*> resetIterator(tilesToReset);
     while (resetIterator.hasNext()) {
         applyMetaData(resetIterator.next(),
-                      Properties(), -1, 1.0f, nullptr, QVector<Frame>());
+                      PropertyList(), -1, 1.0f, nullptr, QVector<Frame>());
     }
 
     if (!tilesChangingProbability.isEmpty()) {
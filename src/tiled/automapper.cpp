@@ -417,7 +417,8 @@ bool AutoMapper::setupTilesets(Map *src, Map *dst)
 
         // Merge the tile properties
         for (Tile *replacementTile : replacement->tiles()) {
-            if (Tile *originalTile = tileset->findTile(replacementTile->id())) {
+            Tile *originalTile = tileset->findTile(replacementTile->id());
+            if (originalTile && originalTile->hasProperties()) {
                 Properties properties = replacementTile->properties();
                 properties.merge(originalTile->properties());
                 undoStack->push(new ChangeProperties(mMapDocument,
@@ -0,0 +1,402 @@
+/*
+ * batchexporter.cpp
+ * Copyright 2026, agent <agent@local>
+ *
+ *
+ * This file is part of Tiled.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "batchexporter.h"
+
+#include "imagelayer.h"
+#include "map.h"
+#include "mapformat.h"
+#include "mapreader.h"
+#include "pluginmanager.h"
+#include "tile.h"
+
+#include <QBuffer>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QtConcurrentMap>
+
+#include <cstdio>
+
+using namespace Tiled;
+using namespace Tiled::Internal;
+
+namespace {
+
+/**
+ * Returns the file extension used by the given format, taken from its name
+ * filter.
+ */
+QString formatExtension(const MapFormat *format)
+{
+    static const QRegularExpression extension(QLatin1String("\\*\\.([^\\s\\)]+)"));
+    return extension.match(format->nameFilter()).captured(1);
+}
+
+/**
+ * Returns the files the export of \a map depends on, besides the format.
+ */
+QStringList inputFiles(const QString &sourceFile, const Map &map)
+{
+    QStringList files(sourceFile);
+
+    for (const SharedTileset &tileset : map.tilesets()) {
+        if (tileset->isExternal())
+            files.append(tileset->fileName());
+        if (!tileset->imageSource().isEmpty())
+            files.append(tileset->imageSource());
+        for (const Tile *tile : tileset->tiles())
+            if (!tile->imageSource().isEmpty())
+                files.append(tile->imageSource());
+    }
+
+    for (Layer *layer : map.layers())
+        if (ImageLayer *imageLayer = layer->asImageLayer())
+            if (!imageLayer->imageSource().isEmpty())
+                files.append(imageLayer->imageSource());
+
+    files.removeDuplicates();
+    return files;
+}
+
+} // anonymous namespace
+
+
+BatchExporter::BatchExporter()
+{
+}
+
+BatchExporter::~BatchExporter()
+{
+    qDeleteAll(mFormatMutexes);
+}
+
+bool BatchExporter::loadManifest(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        mError = tr("Could not open manifest: %1").arg(file.errorString());
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        mError = tr("Error parsing manifest: %1").arg(parseError.errorString());
+        return false;
+    }
+
+    const QDir manifestDir = QFileInfo(fileName).absoluteDir();
+    const QJsonObject manifest = document.object();
+
+    const QString summary = manifest.value(QLatin1String("summary")).toString();
+    if (!summary.isEmpty())
+        mSummaryFile = manifestDir.absoluteFilePath(summary);
+
+    const QString cache = manifest.value(QLatin1String("cache")).toString();
+    if (!cache.isEmpty()) {
+        mCache.reset(new ExportCache);
+        if (!mCache->load(manifestDir.absoluteFilePath(cache))) {
+            mError = mCache->errorString();
+            return false;
+        }
+    }
+
+    // Maps are grouped by source file, so that each map is read only once
+    QHash<QString, int> jobIndexes;
+
+    for (const QJsonValue &jobValue : manifest.value(QLatin1String("jobs")).toArray()) {
+        const QJsonObject jobObject = jobValue.toObject();
+        const QString source = jobObject.value(QLatin1String("source")).toString();
+        const QString target = jobObject.value(QLatin1String("target")).toString();
+
+        if (source.isEmpty() || target.isEmpty()) {
+            mError = tr("Each job needs a source and a target");
+            return false;
+        }
+
+        QVector<MapFormat*> formats;
+        for (const QJsonValue &formatValue : jobObject.value(QLatin1String("formats")).toArray()) {
+            MapFormat *format = findFormat(formatValue.toString());
+            if (!format)
+                return false;
+            formats.append(format);
+        }
+
+        const QDir targetDir(manifestDir.absoluteFilePath(target));
+        if (!targetDir.mkpath(QLatin1String("."))) {
+            mError = tr("Could not create target directory: %1").arg(targetDir.path());
+            return false;
+        }
+
+        const QFileInfo sourceInfo(manifestDir.absoluteFilePath(source));
+        const QDir sourceDir = sourceInfo.absoluteDir();
+        const QStringList sourceNames = sourceDir.entryList(QStringList(sourceInfo.fileName()),
+                                                            QDir::Files, QDir::Name);
+
+        if (sourceNames.isEmpty())
+            qWarning() << qPrintable(tr("No maps found matching %1").arg(source));
+
+        for (const QString &sourceName : sourceNames) {
+            const QString sourceFile = sourceDir.absoluteFilePath(sourceName);
+
+            int index = jobIndexes.value(sourceFile, -1);
+            if (index == -1) {
+                index = mJobs.size();
+                jobIndexes.insert(sourceFile, index);
+
+                Job job;
+                job.sourceFile = sourceFile;
+                mJobs.append(job);
+            }
+
+            for (MapFormat *format : formats) {
+                Export mapExport;
+                mapExport.format = format;
+                mapExport.targetFile = targetDir.absoluteFilePath(QFileInfo(sourceName).completeBaseName() +
+                                                                  QLatin1Char('.') +
+                                                                  formatExtension(format));
+                mapExport.success = false;
+                mapExport.skipped = false;
+                mapExport.milliseconds = 0;
+                mJobs[index].exports.append(mapExport);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool BatchExporter::exportMaps()
+{
+    QtConcurrent::blockingMap(mJobs, [this](Job &job) { exportMap(job); });
+
+    if (mCache && !mCache->save())
+        qWarning() << qPrintable(mCache->errorString());
+
+    for (const Job &job : mJobs)
+        for (const Export &mapExport : job.exports)
+            if (!mapExport.success)
+                return false;
+
+    return true;
+}
+
+bool BatchExporter::writeSummary()
+{
+    QJsonArray results;
+    int failed = 0;
+    int skipped = 0;
+
+    for (const Job &job : mJobs) {
+        for (const Export &mapExport : job.exports) {
+            QJsonObject result;
+            result.insert(QLatin1String("source"), job.sourceFile);
+            result.insert(QLatin1String("target"), mapExport.targetFile);
+            result.insert(QLatin1String("format"), mapExport.format->nameFilter());
+            result.insert(QLatin1String("success"), mapExport.success);
+            if (mapExport.skipped) {
+                result.insert(QLatin1String("skipped"), true);
+                ++skipped;
+            }
+            result.insert(QLatin1String("milliseconds"), double(mapExport.milliseconds));
+            if (!mapExport.success) {
+                result.insert(QLatin1String("error"), mapExport.error);
+                ++failed;
+            }
+            results.append(result);
+        }
+    }
+
+    QJsonObject summary;
+    summary.insert(QLatin1String("exported"), results.size() - failed - skipped);
+    summary.insert(QLatin1String("skipped"), skipped);
+    summary.insert(QLatin1String("failed"), failed);
+    summary.insert(QLatin1String("results"), results);
+
+    const QByteArray json = QJsonDocument(summary).toJson();
+
+    QFile file;
+    bool opened;
+    if (mSummaryFile.isEmpty()) {
+        opened = file.open(stdout, QIODevice::WriteOnly);
+    } else {
+        file.setFileName(mSummaryFile);
+        opened = file.open(QIODevice::WriteOnly);
+    }
+
+    if (!opened || file.write(json) != json.size()) {
+        mError = tr("Could not write summary: %1").arg(file.errorString());
+        return false;
+    }
+
+    return true;
+}
+
+void BatchExporter::exportMap(Job &job)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Skip the exports whose inputs and outputs did not change
+    bool upToDate = true;
+    for (Export &mapExport : job.exports) {
+        if (mCache && mCache->isUpToDate(mapExport.targetFile, mapExport.format)) {
+            mapExport.success = true;
+            mapExport.skipped = true;
+            mapExport.milliseconds = timer.elapsed();
+        } else {
+            upToDate = false;
+        }
+    }
+
+    if (upToDate)
+        return;
+
+    // Hash the map before reading it, so its stored hash is never newer than
+    // the contents that were exported
+    if (mCache)
+        mCache->inputHashes(QStringList(job.sourceFile));
+
+    MapReader reader;
+    reader.setTilesetCache(&mTilesetCache);
+    QScopedPointer<Map> map(reader.readMap(job.sourceFile));
+
+    if (!map) {
+        for (Export &mapExport : job.exports) {
+            if (mapExport.skipped)
+                continue;
+            mapExport.error = reader.errorString();
+            mapExport.milliseconds = timer.elapsed();
+        }
+        return;
+    }
+
+    const qint64 readTime = timer.elapsed();
+
+    // The inputs are hashed before exporting, so that changes made to them
+    // in the meantime are picked up by the next run
+    ExportCache::Hashes inputs;
+    if (mCache)
+        inputs = mCache->inputHashes(inputFiles(job.sourceFile, *map));
+
+    for (Export &mapExport : job.exports) {
+        if (mapExport.skipped)
+            continue;
+
+        timer.restart();
+
+        QMutexLocker locker(mFormatMutexes.value(mapExport.format));
+        mapExport.success = writeMap(map.data(), mapExport.format,
+                                     mapExport.targetFile, &mapExport.error);
+        const QStringList outputs = mapExport.format->outputFiles(map.data(),
+                                                                  mapExport.targetFile);
+        locker.unlock();
+
+        if (mCache) {
+            if (mapExport.success)
+                mCache->update(mapExport.targetFile, mapExport.format, inputs, outputs);
+            else
+                mCache->remove(mapExport.targetFile);
+        }
+
+        // The time spent reading the map is included in each export
+        mapExport.milliseconds = readTime + timer.elapsed();
+    }
+}
+
+/**
+ * Writes \a map to \a targetFile using \a format. When the format can write
+ * to a device, the target file is left untouched if its contents would not
+ * change, so that tools watching it are not triggered.
+ */
+bool BatchExporter::writeMap(const Map *map, MapFormat *format,
+                             const QString &targetFile, QString *error)
+{
+    if (!format->hasCapabilities(MapFormat::WriteToDevice)) {
+        if (format->write(map, targetFile))
+            return true;
+
+        *error = format->errorString();
+        return false;
+    }
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    if (!format->writeToDevice(map, &buffer, targetFile)) {
+        *error = format->errorString();
+        return false;
+    }
+
+    if (fileHasContents(targetFile, buffer.data()))
+        return true;
+
+    QSaveFile file(targetFile);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text) ||
+            file.write(buffer.data()) != buffer.size() ||
+            !file.commit()) {
+        *error = file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+MapFormat *BatchExporter::findFormat(const QString &name)
+{
+    MapFormat *chosenFormat = nullptr;
+
+    for (MapFormat *format : PluginManager::objects<MapFormat>()) {
+        if (!format->hasCapabilities(MapFormat::Write))
+            continue;
+
+        if (format->nameFilter().compare(name, Qt::CaseInsensitive) == 0) {
+            chosenFormat = format;
+            break;
+        }
+
+        if (formatExtension(format).compare(name, Qt::CaseInsensitive) == 0) {
+            if (chosenFormat) {
+                mError = tr("Non-unique file extension: %1").arg(name);
+                return nullptr;
+            }
+            chosenFormat = format;
+        }
+    }
+
+    if (!chosenFormat) {
+        mError = tr("Format not recognized: %1 (see --export-formats)").arg(name);
+        return nullptr;
+    }
+
+    if (!mFormatMutexes.contains(chosenFormat))
+        mFormatMutexes.insert(chosenFormat, new QMutex);
+
+    return chosenFormat;
+}
@@ -0,0 +1,124 @@
+/*
+ * batchexporter.h
+ * Copyright 2026, agent <agent@local>
+ *
+ *
+ * This file is part of Tiled.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BATCHEXPORTER_H
+#define BATCHEXPORTER_H
+
+#include "exportcache.h"
+#include "tilesetcache.h"
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QScopedPointer>
+#include <QString>
+#include <QVector>
+
+namespace Tiled {
+
+class Map;
+class MapFormat;
+
+namespace Internal {
+
+/**
+ * Exports a batch of maps to one or more formats, as described by a JSON
+ * manifest:
+ *
+ * \code
+ * {
+ *     "jobs": [
+ *         { "source": "maps/level-*.tmx", "target": "export", "formats": ["json", "lua"] }
+ *     ],
+ *     "summary": "summary.json",
+ *     "cache": "export-cache.json"
+ * }
+ * \endcode
+ *
+ * Paths are relative to the manifest. Formats are given by file extension
+ * or by name filter, as listed by --export-formats. When no summary file is
+ * given, the summary is written to the standard output.
+ *
+ * When a cache file is given, exports whose inputs and outputs did not
+ * change since the last run are skipped. Output files are only rewritten
+ * when their contents change.
+ *
+ * The maps are exported concurrently, and external tilesets are shared
+ * between all maps that use them.
+ */
+class BatchExporter
+{
+    Q_DECLARE_TR_FUNCTIONS(BatchExporter)
+
+public:
+    BatchExporter();
+    ~BatchExporter();
+
+    bool loadManifest(const QString &fileName);
+
+    /**
+     * Exports all maps. Returns whether all of them were exported
+     * successfully.
+     */
+    bool exportMaps();
+
+    bool writeSummary();
+
+    QString errorString() const { return mError; }
+
+private:
+    struct Export
+    {
+        MapFormat *format;
+        QString targetFile;
+        bool success;
+        bool skipped;
+        QString error;
+        qint64 milliseconds;
+    };
+
+    struct Job
+    {
+        QString sourceFile;
+        QVector<Export> exports;
+    };
+
+    void exportMap(Job &job);
+    bool writeMap(const Map *map, MapFormat *format,
+                  const QString &targetFile, QString *error);
+    MapFormat *findFormat(const QString &name);
+
+    QList<Job> mJobs;
+    QString mSummaryFile;
+    QString mError;
+    QScopedPointer<ExportCache> mCache;
+
+    TilesetCache mTilesetCache;
+
+    // Formats are not reentrant, so each one is used by one thread at a time
+    QHash<MapFormat*, QMutex*> mFormatMutexes;
+};
+
+} // namespace Internal
+} // namespace Tiled
+
+#endif // BATCHEXPORTER_H
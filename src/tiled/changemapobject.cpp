@@ -113,7 +113,8 @@ void ChangeMapObjects::swap()
             std::swap(cell.tile, change.tile);
             change.object->setCell(cell);
         }
-        emit mMapObjectModel->objectsChanged(objectList(mChanges));
+        emit mMapObjectModel->objectsChanged(objectList(mChanges),
+                                             MapObject::CellProperty);
         break;
     }
 }
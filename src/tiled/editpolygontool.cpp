@@ -246,7 +246,7 @@ void EditPolygonTool::mousePressed(QGraphicsSceneMouseEvent *event)
                                                                Qt::DescendingOrder,
                                                                viewTransform(event));
 
-        mClickedObjectItem = first<MapObjectItem>(items);
+        mClickedObjectItem = mapScene()->topMostObjectItemAt(mStart);
         mClickedHandle = first<PointHandle>(items);
         break;
     }
@@ -438,16 +438,12 @@ void EditPolygonTool::updateSelection(QGraphicsSceneMouseEvent *event)
 
     if (oldSelection.isEmpty()) {
         // Allow selecting some map objects only when there aren't any selected
-        QSet<MapObjectItem*> selectedItems;
+        QPainterPath path;
+        path.addRect(rect);
 
-        foreach (QGraphicsItem *item, mapScene()->items(rect,
-                                                        Qt::IntersectsItemShape,
-                                                        Qt::DescendingOrder,
-                                                        viewTransform(event))) {
-            MapObjectItem *mapObjectItem = dynamic_cast<MapObjectItem*>(item);
-            if (mapObjectItem)
-                selectedItems.insert(mapObjectItem);
-        }
+        QSet<MapObjectItem*> selectedItems;
+        for (MapObjectItem *item : mapScene()->objectItemsIntersecting(path))
+            selectedItems.insert(item);
 
 
         QSet<MapObjectItem*> newSelection;
@@ -532,6 +528,8 @@ void EditPolygonTool::updateMovingItems(const QPointF &pos,
         diff = renderer->pixelToScreenCoords(newAlignPixelPos) - alignScreenPos;
     }
 
+    QList<MapObject*> changedObjects;
+
     int i = 0;
     foreach (PointHandle *handle, mSelectedHandles) {
         // update handle position
@@ -548,10 +546,16 @@ void EditPolygonTool::updateMovingItems(const QPointF &pos,
         MapObject *mapObject = item->mapObject();
         QPolygonF polygon = mapObject->polygon();
         polygon[handle->pointIndex()] = newPixelPos - mapObject->position();
-        mapDocument()->mapObjectModel()->setObjectPolygon(mapObject, polygon);
+        mapObject->setPolygon(polygon);
+
+        if (changedObjects.isEmpty() || changedObjects.last() != mapObject)
+            changedObjects.append(mapObject);
 
         ++i;
     }
+
+    mapDocument()->scheduleObjectsChanged(changedObjects,
+                                          MapObject::ShapeProperty);
 }
 
 void EditPolygonTool::finishMoving(const QPointF &pos)
@@ -0,0 +1,230 @@
+/*
+ * exportcache.cpp
+ * Copyright 2026, agent <agent@local>
+ *
+ *
+ * This file is part of Tiled.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "exportcache.h"
+
+#include "mapformat.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+using namespace Tiled;
+using namespace Tiled::Internal;
+
+static const int CacheVersion = 1;
+
+static QJsonObject hashesToJson(const ExportCache::Hashes &hashes)
+{
+    QJsonObject json;
+    for (auto it = hashes.constBegin(); it != hashes.constEnd(); ++it)
+        json.insert(it.key(), QString::fromLatin1(it.value()));
+    return json;
+}
+
+static ExportCache::Hashes hashesFromJson(const QJsonObject &json)
+{
+    ExportCache::Hashes hashes;
+    for (auto it = json.constBegin(); it != json.constEnd(); ++it)
+        hashes.insert(it.key(), it.value().toString().toLatin1());
+    return hashes;
+}
+
+bool ExportCache::load(const QString &fileName)
+{
+    mFileName = fileName;
+    mEntries.clear();
+    mInputHashes.clear();
+
+    QFile file(fileName);
+    if (!file.exists())
+        return true;
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        mError = tr("Could not open export cache: %1").arg(file.errorString());
+        return false;
+    }
+
+    const QJsonObject json = QJsonDocument::fromJson(file.readAll()).object();
+
+    // Caches written by other versions are ignored
+    if (json.value(QLatin1String("version")).toInt() != CacheVersion)
+        return true;
+
+    const QJsonObject exports = json.value(QLatin1String("exports")).toObject();
+    for (auto it = exports.constBegin(); it != exports.constEnd(); ++it) {
+        const QJsonObject entryJson = it.value().toObject();
+
+        Entry entry;
+        entry.format = entryJson.value(QLatin1String("format")).toString();
+        entry.version = entryJson.value(QLatin1String("tiledVersion")).toString();
+        entry.inputs = hashesFromJson(entryJson.value(QLatin1String("inputs")).toObject());
+        entry.outputs = hashesFromJson(entryJson.value(QLatin1String("outputs")).toObject());
+
+        mEntries.insert(it.key(), entry);
+    }
+
+    return true;
+}
+
+bool ExportCache::save()
+{
+    QJsonObject exports;
+    for (auto it = mEntries.constBegin(); it != mEntries.constEnd(); ++it) {
+        const Entry &entry = it.value();
+
+        QJsonObject entryJson;
+        entryJson.insert(QLatin1String("format"), entry.format);
+        entryJson.insert(QLatin1String("tiledVersion"), entry.version);
+        entryJson.insert(QLatin1String("inputs"), hashesToJson(entry.inputs));
+        entryJson.insert(QLatin1String("outputs"), hashesToJson(entry.outputs));
+
+        exports.insert(it.key(), entryJson);
+    }
+
+    QJsonObject json;
+    json.insert(QLatin1String("version"), CacheVersion);
+    json.insert(QLatin1String("exports"), exports);
+
+    QSaveFile file(mFileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        mError = tr("Could not write export cache: %1").arg(file.errorString());
+        return false;
+    }
+
+    file.write(QJsonDocument(json).toJson(QJsonDocument::Compact));
+
+    if (!file.commit()) {
+        mError = tr("Could not write export cache: %1").arg(file.errorString());
+        return false;
+    }
+
+    return true;
+}
+
+bool ExportCache::isUpToDate(const QString &targetFile,
+                             const MapFormat *format) const
+{
+    Entry entry;
+    {
+        QMutexLocker locker(&mMutex);
+        auto it = mEntries.constFind(targetFile);
+        if (it == mEntries.constEnd())
+            return false;
+        entry = it.value();
+    }
+
+    if (entry.format != format->nameFilter())
+        return false;
+    if (entry.version != QCoreApplication::applicationVersion())
+        return false;
+
+    // The files are hashed without holding the lock
+    for (auto it = entry.inputs.constBegin(); it != entry.inputs.constEnd(); ++it) {
+        const QByteArray hash = inputHash(it.key());
+        if (hash.isEmpty() || hash != it.value())
+            return false;
+    }
+
+    for (auto it = entry.outputs.constBegin(); it != entry.outputs.constEnd(); ++it) {
+        const QByteArray hash = fileHash(it.key());
+        if (hash.isEmpty() || hash != it.value())
+            return false;
+    }
+
+    return true;
+}
+
+ExportCache::Hashes ExportCache::inputHashes(const QStringList &inputFiles) const
+{
+    Hashes hashes;
+    for (const QString &fileName : inputFiles)
+        hashes.insert(fileName, inputHash(fileName));
+    return hashes;
+}
+
+void ExportCache::update(const QString &targetFile, const MapFormat *format,
+                         const Hashes &inputs,
+                         const QStringList &outputFiles)
+{
+    Entry entry;
+    entry.format = format->nameFilter();
+    entry.version = QCoreApplication::applicationVersion();
+    entry.inputs = inputs;
+
+    for (const QString &fileName : outputFiles)
+        entry.outputs.insert(fileName, fileHash(fileName));
+
+    QMutexLocker locker(&mMutex);
+    mEntries.insert(targetFile, entry);
+}
+
+void ExportCache::remove(const QString &targetFile)
+{
+    QMutexLocker locker(&mMutex);
+    mEntries.remove(targetFile);
+}
+
+/**
+ * Returns the hexadecimal SHA-1 hash of the contents of \a fileName, or an
+ * empty byte array when the file can't be read.
+ */
+QByteArray ExportCache::fileHash(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file))
+        return QByteArray();
+
+    return hash.result().toHex();
+}
+
+/**
+ * Returns the hash of the input file \a fileName, hashing it only the first
+ * time it is asked for.
+ */
+QByteArray ExportCache::inputHash(const QString &fileName) const
+{
+    const QString canonicalPath = QFileInfo(fileName).canonicalFilePath();
+    if (canonicalPath.isEmpty())
+        return QByteArray();
+
+    {
+        QMutexLocker locker(&mMutex);
+        auto it = mInputHashes.constFind(canonicalPath);
+        if (it != mInputHashes.constEnd())
+            return it.value();
+    }
+
+    // Hashed without holding the lock. Rarely, two threads hash the same
+    // file, which gives the same result.
+    const QByteArray hash = fileHash(canonicalPath);
+
+    QMutexLocker locker(&mMutex);
+    mInputHashes.insert(canonicalPath, hash);
+    return hash;
+}
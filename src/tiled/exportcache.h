@@ -0,0 +1,110 @@
+/*
+ * exportcache.h
+ * Copyright 2026, agent <agent@local>
+ *
+ *
+ * This file is part of Tiled.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXPORTCACHE_H
+#define EXPORTCACHE_H
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+namespace Tiled {
+
+class MapFormat;
+
+namespace Internal {
+
+/**
+ * Remembers the content hashes of the inputs and outputs of each export, so
+ * that exports can be skipped when nothing changed. The inputs of an export
+ * are the map file and the external tilesets and images it uses. The format
+ * and the version of Tiled are also taken into account.
+ *
+ * Inputs are assumed not to change while exporting, so each of them is hashed
+ * only once after load(), however many maps use it. Outputs are hashed every
+ * time they are checked.
+ *
+ * All functions except load() and save() are safe to call from multiple
+ * threads.
+ */
+class ExportCache
+{
+    Q_DECLARE_TR_FUNCTIONS(ExportCache)
+
+public:
+    typedef QHash<QString, QByteArray> Hashes;
+
+    /**
+     * Loads the cache from \a fileName. A missing file is not an error,
+     * since the cache is created by the first export.
+     */
+    bool load(const QString &fileName);
+    bool save();
+
+    QString errorString() const { return mError; }
+
+    /**
+     * Returns whether the export to \a targetFile with \a format is up to
+     * date, meaning its inputs did not change and its outputs still exist
+     * unmodified.
+     */
+    bool isUpToDate(const QString &targetFile, const MapFormat *format) const;
+
+    /**
+     * Returns the hashes of the given input files. Call this before
+     * exporting, so that changes made to the inputs during the export are
+     * picked up by the next run.
+     */
+    Hashes inputHashes(const QStringList &inputFiles) const;
+
+    void update(const QString &targetFile, const MapFormat *format,
+                const Hashes &inputs, const QStringList &outputFiles);
+
+    void remove(const QString &targetFile);
+
+    static QByteArray fileHash(const QString &fileName);
+
+private:
+    struct Entry
+    {
+        QString format;
+        QString version;
+        Hashes inputs;
+        Hashes outputs;
+    };
+
+    QByteArray inputHash(const QString &fileName) const;
+
+    QString mFileName;
+    QString mError;
+
+    mutable QMutex mMutex;
+    QHash<QString, Entry> mEntries;
+    mutable Hashes mInputHashes;    // by canonical file path
+};
+
+} // namespace Internal
+} // namespace Tiled
+
+#endif // EXPORTCACHE_H
@@ -100,11 +100,14 @@
 #include <QCloseEvent>
 #include <QComboBox>
 #include <QDesktopServices>
+#include <QEventLoop>
 #include <QFileDialog>
+#include <QFutureWatcher>
 #include <QIdentityProxyModel>
 #include <QLabel>
 #include <QMessageBox>
 #include <QMimeData>
+#include <QProgressDialog>
 #include <QRegExp>
 #include <QScrollBar>
 #include <QSessionManager>
@@ -112,6 +115,7 @@
 #include <QSignalMapper>
 #include <QTextStream>
 #include <QToolButton>
+#include <QtConcurrentRun>
 #include <QUndoGroup>
 #include <QUndoStack>
 #include <QUndoView>
@@ -247,13 +251,13 @@ MainWindow::MainWindow(QWidget *parent, Qt::WindowFlags flags)
     undoAction->setIconText(tr("Undo"));
     connect(undoGroup, SIGNAL(cleanChanged(bool)), SLOT(updateWindowTitle()));
 
-    UndoDock *undoDock = new UndoDock(undoGroup, this);
+    mUndoDock = new UndoDock(undoGroup, this);
     mPropertiesDock = new PropertiesDock(this);
     TileStampsDock *tileStampsDock = new TileStampsDock(mTileStampManager, this);
 
     addDockWidget(Qt::RightDockWidgetArea, mLayerDock);
     addDockWidget(Qt::LeftDockWidgetArea, mPropertiesDock);
-    addDockWidget(Qt::LeftDockWidgetArea, undoDock);
+    addDockWidget(Qt::LeftDockWidgetArea, mUndoDock);
     addDockWidget(Qt::LeftDockWidgetArea, mMapsDock);
     addDockWidget(Qt::RightDockWidgetArea, mObjectsDock);
     addDockWidget(Qt::RightDockWidgetArea, mMiniMapDock);
@@ -265,12 +269,12 @@ MainWindow::MainWindow(QWidget *parent, Qt::WindowFlags flags)
     tabifyDockWidget(mMiniMapDock, mObjectsDock);
     tabifyDockWidget(mObjectsDock, mLayerDock);
     tabifyDockWidget(mTerrainDock, mTilesetDock);
-    tabifyDockWidget(undoDock, mMapsDock);
-    tabifyDockWidget(tileStampsDock, undoDock);
+    tabifyDockWidget(mUndoDock, mMapsDock);
+    tabifyDockWidget(tileStampsDock, mUndoDock);
 
     // These dock widgets may not be immediately useful to many people, so
     // they are hidden by default.
-    undoDock->setVisible(false);
+    mUndoDock->setVisible(false);
     mMapsDock->setVisible(false);
     mConsoleDock->setVisible(false);
     tileStampsDock->setVisible(false);
@@ -873,6 +877,21 @@ bool MainWindow::saveFile(const QString &fileName)
     if (fileName.isEmpty())
         return false;
 
+    // The XML layer data format is very slow to load and save. The format
+    // is changed outside of the undo stack, since saving is not an edit.
+    Map *map = mMapDocument->map();
+    if (map->layerDataFormat() == Map::XML &&
+            Preferences::instance()->upgradeXmlLayerData()) {
+        map->setLayerDataFormat(Map::CSV);
+        mMapDocument->emitMapChanged();
+
+        QMessageBox::warning(this, tr("Layer Format Changed"),
+                             tr("The tile layer data of this map was stored "
+                                "as XML, which is very slow to load. It will "
+                                "be saved as CSV instead.\n\n"
+                                "This can be disabled in the preferences."));
+    }
+
     QString error;
     if (!mMapDocument->save(fileName, &error)) {
         QMessageBox::critical(this, tr("Error Saving Map"), error);
@@ -1016,7 +1035,7 @@ void MainWindow::export_()
         if (!exportFormat)
             exportFormat = &tmxFormat;
 
-        if (exportFormat->write(mMapDocument->map(), exportFileName)) {
+        if (exportMap(exportFormat, exportFileName)) {
             statusBar()->showMessage(tr("Exported to %1").arg(exportFileName),
                                      3000);
             return;
@@ -1138,7 +1157,7 @@ void MainWindow::exportAs()
     pref->setLastPath(Preferences::ExportedFile, QFileInfo(fileName).path());
     mSettings.setValue(QLatin1String("lastUsedExportFilter"), selectedFilter);
 
-    if (!chosenFormat->write(mMapDocument->map(), fileName)) {
+    if (!exportMap(chosenFormat, fileName)) {
         QMessageBox::critical(this, tr("Error Exporting Map"),
                               chosenFormat->errorString());
     } else {
@@ -1149,6 +1168,44 @@ void MainWindow::exportAs()
     }
 }
 
+bool MainWindow::exportMap(MapFormat *format, const QString &fileName)
+{
+    const Map *map = mMapDocument->map();
+
+    if (!format->hasCapabilities(FileFormat::Threaded))
+        return format->write(map, fileName);
+
+    // The dialog is shown right away, since it being window modal is what
+    // keeps the map from being changed while it is written
+    QProgressDialog progress(tr("Exporting to %1...").arg(fileName),
+                             tr("Cancel"), 0, 0, this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(0);
+    progress.setAutoClose(false);
+    progress.setAutoReset(false);
+    progress.setValue(0);
+
+    connect(format, &FileFormat::progressChanged,
+            &progress, [&progress] (int value, int maximum) {
+        progress.setMaximum(maximum);
+        progress.setValue(value);
+    });
+    connect(&progress, &QProgressDialog::canceled,
+            format, &FileFormat::cancel);
+
+    QEventLoop loop;
+    QFutureWatcher<bool> watcher;
+    connect(&watcher, &QFutureWatcher<bool>::finished,
+            &loop, &QEventLoop::quit);
+
+    format->aboutToRunInThread();
+    watcher.setFuture(QtConcurrent::run(format, &MapFormat::write,
+                                        map, fileName));
+    loop.exec();
+
+    return watcher.result();
+}
+
 void MainWindow::exportAsImage()
 {
     if (!mMapDocument)
@@ -1459,6 +1516,13 @@ void MainWindow::autoMappingWarning(bool automatic)
     }
 }
 
+void MainWindow::paintCommandsDiscarded(int count)
+{
+    statusBar()->showMessage(tr("The undo history exceeded its memory limit. "
+                                "The oldest %n paint step(s) can no longer be undone.",
+                                "", count), 5000);
+}
+
 void MainWindow::onObjectTypesEditorClosed()
 {
     mShowObjectTypesEditor->setChecked(false);
@@ -1805,6 +1869,7 @@ void MainWindow::mapDocumentChanged(MapDocument *mapDocument)
     mActionHandler->setMapDocument(mapDocument);
     mLayerDock->setMapDocument(mapDocument);
     mPropertiesDock->setMapDocument(mapDocument);
+    mUndoDock->setMapDocument(mapDocument);
     mObjectsDock->setMapDocument(mapDocument);
     mTilesetDock->setMapDocument(mapDocument);
     mTerrainDock->setMapDocument(mapDocument);
@@ -1823,6 +1888,8 @@ void MainWindow::mapDocumentChanged(MapDocument *mapDocument)
                 SLOT(updateActions()));
         connect(mapDocument, SIGNAL(selectedObjectsChanged()),
                 SLOT(updateActions()));
+        connect(mapDocument, SIGNAL(paintCommandsDiscarded(int)),
+                SLOT(paintCommandsDiscarded(int)));
 
         if (MapView *mapView = mDocumentManager->currentMapView()) {
             mZoomable = mapView->zoomable();
@@ -43,6 +43,7 @@ class MainWindow;
 
 namespace Tiled {
 
+class MapFormat;
 class TileLayer;
 class Terrain;
 
@@ -70,6 +71,7 @@ class TilesetDock;
 class TileStamp;
 class TileStampManager;
 class ToolManager;
+class UndoDock;
 class Zoomable;
 
 /**
@@ -176,6 +178,7 @@ private slots:
     void reloadError(const QString &error);
     void autoMappingError(bool automatic);
     void autoMappingWarning(bool automatic);
+    void paintCommandsDiscarded(int count);
 
     void onObjectTypesEditorClosed();
     void onAnimationEditorClosed();
@@ -211,6 +214,14 @@ private:
      */
     bool saveFile(const QString &fileName);
 
+    /**
+     * Exports the current map to the given file name using \a format.
+     * Formats with the Threaded capability are run in a worker thread while
+     * a progress dialog allows cancelling the export.
+     * @return <code>true</code> on success, <code>false</code> on failure
+     */
+    bool exportMap(MapFormat *format, const QString &fileName);
+
     void writeSettings();
     void readSettings();
 
@@ -227,6 +238,7 @@ private:
     MapDocumentActionHandler *mActionHandler;
     LayerDock *mLayerDock;
     PropertiesDock *mPropertiesDock;
+    UndoDock *mUndoDock;
     MapsDock *mMapsDock;
     ObjectsDock *mObjectsDock;
     TilesetDock *mTilesetDock;
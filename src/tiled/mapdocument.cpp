@@ -43,6 +43,7 @@
 #include "orthogonalrenderer.h"
 #include "painttilelayer.h"
 #include "pluginmanager.h"
+#include "preferences.h"
 #include "resizemap.h"
 #include "resizetilelayer.h"
 #include "rotatemapobject.h"
@@ -56,6 +57,7 @@
 
 #include <QFileInfo>
 #include <QRect>
+#include <QSet>
 #include <QUndoStack>
 
 using namespace Tiled;
@@ -69,7 +71,10 @@ MapDocument::MapDocument(Map *map, const QString &fileName):
     mRenderer(nullptr),
     mMapObjectModel(new MapObjectModel(this)),
     mTerrainModel(new TerrainModel(this, this)),
-    mUndoStack(new QUndoStack(this))
+    mUndoStack(new QUndoStack(this)),
+    mUndoMemoryUsage(0),
+    mUndoMemoryCheckPending(false),
+    mObjectsChangedPending(false)
 {
     createRenderer();
 
@@ -90,8 +95,8 @@ MapDocument::MapDocument(Map *map, const QString &fileName):
     mMapObjectModel->setMapDocument(this);
     connect(mMapObjectModel, SIGNAL(objectsAdded(QList<MapObject*>)),
             SIGNAL(objectsAdded(QList<MapObject*>)));
-    connect(mMapObjectModel, SIGNAL(objectsChanged(QList<MapObject*>)),
-            SIGNAL(objectsChanged(QList<MapObject*>)));
+    connect(mMapObjectModel, &MapObjectModel::objectsChanged,
+            this, &MapDocument::objectsChanged);
     connect(mMapObjectModel, SIGNAL(objectsTypeChanged(QList<MapObject*>)),
             SIGNAL(objectsTypeChanged(QList<MapObject*>)));
     connect(mMapObjectModel, SIGNAL(objectsRemoved(QList<MapObject*>)),
@@ -103,12 +108,17 @@ MapDocument::MapDocument(Map *map, const QString &fileName):
             SLOT(onMapObjectModelRowsInsertedOrRemoved(QModelIndex,int,int)));
     connect(mMapObjectModel, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
             SLOT(onObjectsMoved(QModelIndex,int,int,QModelIndex,int)));
+    connect(mMapObjectModel, &MapObjectModel::layoutChanged,
+            this, &MapDocument::onMapObjectModelLayoutChanged);
 
     connect(mTerrainModel, SIGNAL(terrainRemoved(Terrain*)),
             SLOT(onTerrainRemoved(Terrain*)));
 
     connect(mUndoStack, SIGNAL(cleanChanged(bool)), SIGNAL(modifiedChanged()));
 
+    connect(Preferences::instance(), &Preferences::undoMemoryBudgetChanged,
+            this, &MapDocument::enforceUndoMemoryBudget);
+
     // Register tileset references
     TilesetManager *tilesetManager = TilesetManager::instance();
     tilesetManager->addReferences(mMap->tilesets());
@@ -116,6 +126,9 @@ MapDocument::MapDocument(Map *map, const QString &fileName):
 
 MapDocument::~MapDocument()
 {
+    // Delete the undo commands while the map and this document still exist
+    delete mUndoStack;
+
     // Unregister tileset references
     TilesetManager *tilesetManager = TilesetManager::instance();
     tilesetManager->removeReferences(mMap->tilesets());
@@ -254,6 +267,62 @@ bool MapDocument::isModified() const
     return !mUndoStack->isClean();
 }
 
+void MapDocument::adjustUndoMemoryUsage(qint64 delta)
+{
+    if (delta == 0)
+        return;
+
+    mUndoMemoryUsage += delta;
+    emit undoMemoryUsageChanged(mUndoMemoryUsage);
+
+    // The undo stack can't be changed while a command is being pushed
+    if (delta > 0 && !mUndoMemoryCheckPending) {
+        mUndoMemoryCheckPending = true;
+        QMetaObject::invokeMethod(this, "enforceUndoMemoryBudget",
+                                  Qt::QueuedConnection);
+    }
+}
+
+void MapDocument::addPaintCommand(PaintTileLayer *command)
+{
+    mPaintCommands.append(command);
+}
+
+void MapDocument::removePaintCommand(PaintTileLayer *command)
+{
+    if (!mPaintCommands.removeOne(command))
+        mCompactedPaintCommands.removeOne(command);
+}
+
+void MapDocument::enforceUndoMemoryBudget()
+{
+    mUndoMemoryCheckPending = false;
+
+    const qint64 budget = qint64(Preferences::instance()->undoMemoryBudget()) * 1024 * 1024;
+    if (budget <= 0)
+        return;
+
+    // First compress the tile data of the oldest paint commands. The most
+    // recent command is skipped, since it may still get merged with.
+    while (mUndoMemoryUsage > budget && mPaintCommands.size() > 1) {
+        PaintTileLayer *command = mPaintCommands.takeFirst();
+        command->compact();
+        mCompactedPaintCommands.append(command);
+    }
+
+    // QUndoStack provides no way to remove its oldest commands, so when
+    // compressing is not enough, the tile data of the oldest commands is
+    // discarded instead, which turns them into no-ops.
+    int discarded = 0;
+    while (mUndoMemoryUsage > budget && !mCompactedPaintCommands.isEmpty()) {
+        mCompactedPaintCommands.takeFirst()->discard();
+        ++discarded;
+    }
+
+    if (discarded > 0)
+        emit paintCommandsDiscarded(discarded);
+}
+
 void MapDocument::setCurrentLayerIndex(int index)
 {
     Q_ASSERT(index >= -1 && index < mMap->layerCount());
@@ -743,7 +812,8 @@ void MapDocument::unifyTilesets(Map *map)
 
         // Merge the tile properties
         for (Tile *replacementTile : replacement->tiles()) {
-            if (Tile *originalTile = tileset->findTile(replacementTile->id())) {
+            Tile *originalTile = tileset->findTile(replacementTile->id());
+            if (originalTile && originalTile->hasProperties()) {
                 Properties properties = replacementTile->properties();
                 properties.merge(originalTile->properties());
                 undoCommands.append(new ChangeProperties(this,
@@ -814,6 +884,54 @@ void MapDocument::emitTilesetChanged(Tileset *tileset)
     emit tilesetChanged(tileset);
 }
 
+/**
+ * Schedules the objectsChanged signal for the given \a objects, to be
+ * emitted once control returns to the event loop. Use this while objects are
+ * changed continuously, for example while dragging them, so that the
+ * listeners update only once for all the changes made in between.
+ *
+ * The \a properties of all pending changes are combined.
+ */
+void MapDocument::scheduleObjectsChanged(const QList<MapObject *> &objects,
+                                         MapObject::ChangedProperties properties)
+{
+    for (MapObject *object : objects) {
+        if (!mChangedObjectSet.contains(object)) {
+            mChangedObjectSet.insert(object);
+            mChangedObjects.append(object);
+        }
+    }
+
+    mChangedProperties |= properties;
+
+    if (!mObjectsChangedPending && !mChangedObjects.isEmpty()) {
+        mObjectsChangedPending = true;
+        QMetaObject::invokeMethod(this, "flushObjectsChanged",
+                                  Qt::QueuedConnection);
+    }
+}
+
+/**
+ * Emits the objectsChanged signal for any changes scheduled with
+ * scheduleObjectsChanged(). Does nothing when there are none.
+ */
+void MapDocument::flushObjectsChanged()
+{
+    mObjectsChangedPending = false;
+
+    if (mChangedObjects.isEmpty())
+        return;
+
+    const QList<MapObject*> objects = mChangedObjects;
+    const MapObject::ChangedProperties properties = mChangedProperties;
+
+    mChangedObjects.clear();
+    mChangedObjectSet.clear();
+    mChangedProperties = 0;
+
+    emit objectsChanged(objects, properties);
+}
+
 /**
  * Before forwarding the signal, the objects are removed from the list of
  * selected objects, triggering a selectedObjectsChanged signal when
@@ -821,6 +939,7 @@ void MapDocument::emitTilesetChanged(Tileset *tileset)
  */
 void MapDocument::onObjectsRemoved(const QList<MapObject*> &objects)
 {
+    forgetChangedObjects(objects);
     deselectObjects(objects);
     emit objectsRemoved(objects);
 }
@@ -866,6 +985,20 @@ void MapDocument::onObjectsMoved(const QModelIndex &parent, int start, int end,
     emit objectsIndexChanged(objectGroup, first, last);
 }
 
+/**
+ * The map object model reorders the objects of a group when inserting or
+ * removing many objects at once. Any object in the group may have changed
+ * its index.
+ */
+void MapDocument::onMapObjectModelLayoutChanged(const QList<QPersistentModelIndex> &parents)
+{
+    for (const QPersistentModelIndex &parent : parents) {
+        ObjectGroup *objectGroup = mMapObjectModel->toObjectGroup(parent);
+        if (objectGroup && !objectGroup->isEmpty())
+            emit objectsIndexChanged(objectGroup, 0, objectGroup->objectCount() - 1);
+    }
+}
+
 void MapDocument::onLayerAdded(int index)
 {
     emit layerAdded(index);
@@ -882,8 +1015,10 @@ void MapDocument::onLayerAboutToBeRemoved(int index)
         setCurrentObject(nullptr);
 
     // Deselect any objects on this layer when necessary
-    if (ObjectGroup *og = dynamic_cast<ObjectGroup*>(layer))
+    if (ObjectGroup *og = dynamic_cast<ObjectGroup*>(layer)) {
+        forgetChangedObjects(og->objects());
         deselectObjects(og->objects());
+    }
     emit layerAboutToBeRemoved(index);
 }
 
@@ -915,18 +1050,49 @@ void MapDocument::deselectObjects(const QList<MapObject *> &objects)
         if (objects.contains(static_cast<MapObject*>(mCurrentObject)))
             setCurrentObject(nullptr);
 
-    int removedCount = 0;
-    foreach (MapObject *object, objects)
-        removedCount += mSelectedObjects.removeAll(object);
+    // Filter the selection in one pass, since a large number of selected
+    // objects may be removed at once
+    const QSet<MapObject*> removedObjects = objects.toSet();
+    const int selectedCount = mSelectedObjects.size();
+
+    QList<MapObject*> selectedObjects;
+    selectedObjects.reserve(selectedCount);
+    for (MapObject *object : mSelectedObjects)
+        if (!removedObjects.contains(object))
+            selectedObjects.append(object);
 
-    if (removedCount > 0)
+    if (selectedObjects.size() != selectedCount) {
+        mSelectedObjects.swap(selectedObjects);
         emit selectedObjectsChanged();
+    }
+}
+
+/**
+ * Drops the given objects from any pending objectsChanged signal, since they
+ * are going away.
+ */
+void MapDocument::forgetChangedObjects(const QList<MapObject *> &objects)
+{
+    if (mChangedObjects.isEmpty())
+        return;
+
+    for (MapObject *object : objects)
+        mChangedObjectSet.remove(object);
+
+    QList<MapObject*> changedObjects;
+    for (MapObject *object : mChangedObjects)
+        if (mChangedObjectSet.contains(object))
+            changedObjects.append(object);
+
+    mChangedObjects.swap(changedObjects);
 }
 
 void MapDocument::setTilesetFileName(Tileset *tileset,
                                      const QString &fileName)
 {
+    const QString oldFileName = tileset->fileName();
     tileset->setFileName(fileName);
+    TilesetManager::instance()->tilesetFileNameChanged(*tileset, oldFileName);
     emit tilesetFileNameChanged(tileset);
 }
 
@@ -970,30 +1136,23 @@ void MapDocument::removeObjects(const QList<MapObject *> &objects)
     if (objects.isEmpty())
         return;
 
-    mUndoStack->beginMacro(tr("Remove %n Object(s)", "", objects.size()));
-    foreach (MapObject *mapObject, objects)
-        mUndoStack->push(new RemoveMapObject(this, mapObject));
-    mUndoStack->endMacro();
+    mUndoStack->push(new RemoveMapObjects(this, objects));
 }
 
 void MapDocument::moveObjectsToGroup(const QList<MapObject *> &objects,
                                      ObjectGroup *objectGroup)
 {
-    if (objects.isEmpty())
-        return;
-
-    mUndoStack->beginMacro(tr("Move %n Object(s) to Layer", "",
-                              objects.size()));
+    QList<MapObject*> objectsToMove;
+    for (MapObject *mapObject : objects)
+        if (mapObject->objectGroup() != objectGroup)
+            objectsToMove.append(mapObject);
 
-    foreach (MapObject *mapObject, objects) {
-        if (mapObject->objectGroup() == objectGroup)
-            continue;
+    if (objectsToMove.isEmpty())
+        return;
 
-        mUndoStack->push(new MoveMapObjectToGroup(this,
-                                                  mapObject,
-                                                  objectGroup));
-    }
-    mUndoStack->endMacro();
+    mUndoStack->push(new MoveMapObjectToGroup(this,
+                                              objectsToMove,
+                                              objectGroup));
 }
 
 void MapDocument::setProperty(Object *object,
@@ -24,14 +24,17 @@
 #define MAPDOCUMENT_H
 
 #include "layer.h"
+#include "mapobject.h"
 #include "tiled.h"
 #include "tileset.h"
 
 #include <QDateTime>
 #include <QList>
 #include <QObject>
+#include <QPersistentModelIndex>
 #include <QPointer>
 #include <QRegion>
+#include <QSet>
 #include <QString>
 
 class QModelIndex;
@@ -43,7 +46,6 @@ class QUndoStack;
 namespace Tiled {
 
 class Map;
-class MapObject;
 class MapRenderer;
 class MapFormat;
 class Terrain;
@@ -53,6 +55,7 @@ namespace Internal {
 
 class LayerModel;
 class MapObjectModel;
+class PaintTileLayer;
 class TerrainModel;
 class TileSelectionModel;
 
@@ -222,6 +225,26 @@ public:
      */
     QUndoStack *undoStack() const { return mUndoStack; }
 
+    /**
+     * Returns an estimate of the memory used by the undo history, in bytes.
+     * Only undo commands that store tile data are taken into account.
+     */
+    qint64 undoMemoryUsage() const { return mUndoMemoryUsage; }
+
+    /**
+     * Called by undo commands when the memory they use changes. When the
+     * undo memory budget is exceeded, the tile data stored by the oldest
+     * commands is compressed, and when that is not enough, discarded.
+     */
+    void adjustUndoMemoryUsage(qint64 delta);
+
+    /**
+     * Called by paint commands when they are created and destroyed, so that
+     * the oldest ones can be found when the undo memory budget is exceeded.
+     */
+    void addPaintCommand(PaintTileLayer *command);
+    void removePaintCommand(PaintTileLayer *command);
+
     /**
      * Returns the selected area of tiles.
      */
@@ -279,6 +302,12 @@ public:
     void emitEditLayerNameRequested();
     void emitEditCurrentObject();
 
+    void scheduleObjectsChanged(const QList<MapObject*> &objects,
+                                MapObject::ChangedProperties properties);
+
+public slots:
+    void flushObjectsChanged();
+
 signals:
     void fileNameChanged(const QString &fileName,
                          const QString &oldFileName);
@@ -368,7 +397,8 @@ signals:
     void objectsAdded(const QList<MapObject*> &objects);
     void objectsInserted(ObjectGroup *objectGroup, int first, int last);
     void objectsRemoved(const QList<MapObject*> &objects);
-    void objectsChanged(const QList<MapObject*> &objects);
+    void objectsChanged(const QList<MapObject*> &objects,
+                        MapObject::ChangedProperties properties = MapObject::AllProperties);
     void objectsTypeChanged(const QList<MapObject*> &objects);
     void objectsIndexChanged(ObjectGroup *objectGroup, int first, int last);
 
@@ -377,13 +407,28 @@ signals:
     void propertyChanged(Object *object, const QString &name);
     void propertiesChanged(Object *object);
 
+    /**
+     * Emitted when the estimated memory use of the undo history changes.
+     */
+    void undoMemoryUsageChanged(qint64 bytes);
+
+    /**
+     * Emitted when the tile data of the \a count oldest paint commands was
+     * discarded to stay within the undo memory budget. Undoing these commands
+     * no longer changes the map.
+     */
+    void paintCommandsDiscarded(int count);
+
 private slots:
+    void enforceUndoMemoryBudget();
+
     void onObjectsRemoved(const QList<MapObject*> &objects);
 
     void onMapObjectModelRowsInserted(const QModelIndex &parent, int first, int last);
     void onMapObjectModelRowsInsertedOrRemoved(const QModelIndex &parent, int first, int last);
     void onObjectsMoved(const QModelIndex &parent, int start, int end,
                         const QModelIndex &destination, int row);
+    void onMapObjectModelLayoutChanged(const QList<QPersistentModelIndex> &parents);
 
     void onLayerAdded(int index);
     void onLayerAboutToBeRemoved(int index);
@@ -394,6 +439,7 @@ private slots:
 private:
     void setFileName(const QString &fileName);
     void deselectObjects(const QList<MapObject*> &objects);
+    void forgetChangedObjects(const QList<MapObject*> &objects);
 
     QString mFileName;
     QString mLastExportFileName;
@@ -416,6 +462,14 @@ private:
     MapObjectModel *mMapObjectModel;
     TerrainModel *mTerrainModel;
     QUndoStack *mUndoStack;
+    qint64 mUndoMemoryUsage;
+    bool mUndoMemoryCheckPending;
+    QList<PaintTileLayer*> mPaintCommands;      /**< Oldest first. */
+    QList<PaintTileLayer*> mCompactedPaintCommands;
+    QList<MapObject*> mChangedObjects;  /**< Pending objectsChanged. */
+    QSet<MapObject*> mChangedObjectSet;
+    MapObject::ChangedProperties mChangedProperties;
+    bool mObjectsChangedPending;
     QDateTime mLastSaved;
 };
 
@@ -234,8 +234,7 @@ void MapDocumentActionHandler::cut()
     if (tileLayer && !selectedArea.isEmpty()) {
         stack->push(new EraseTiles(mMapDocument, tileLayer, selectedArea));
     } else if (!selectedObjects.isEmpty()) {
-        foreach (MapObject *mapObject, selectedObjects)
-            stack->push(new RemoveMapObject(mMapDocument, mapObject));
+        stack->push(new RemoveMapObjects(mMapDocument, selectedObjects));
     }
 
     selectNone();
@@ -268,8 +267,7 @@ void MapDocumentActionHandler::delete_()
     if (tileLayer && !selectedArea.isEmpty()) {
         undoStack->push(new EraseTiles(mMapDocument, tileLayer, selectedArea));
     } else if (!selectedObjects.isEmpty()) {
-        foreach (MapObject *mapObject, selectedObjects)
-            undoStack->push(new RemoveMapObject(mMapDocument, mapObject));
+        undoStack->push(new RemoveMapObjects(mMapDocument, selectedObjects));
     }
 
     selectNone();
@@ -56,24 +56,28 @@ MapObjectItem::MapObjectItem(MapObject *object, MapDocument *mapDocument,
     syncWithMapObject();
 }
 
-void MapObjectItem::syncWithMapObject()
+void MapObjectItem::syncWithMapObject(MapObject::ChangedProperties changed)
 {
-    const QColor color = objectColor(mObject);
-
-    // Update the whole object when the name, polygon or color has changed
-    if (mName != mObject->name() || mPolygon != mObject->polygon() || mColor != color) {
-        mName = mObject->name();
-        mPolygon = mObject->polygon();
-        mColor = color;
-        update();
+    // Dragging objects around only changes their position, in which case
+    // the name, polygon, color and tool tip are left alone
+    if (changed & ~MapObject::PositionProperty) {
+        const QColor color = objectColor(mObject);
+
+        // Update the whole object when the name, polygon or color has changed
+        if (mName != mObject->name() || mPolygon != mObject->polygon() || mColor != color) {
+            mName = mObject->name();
+            mPolygon = mObject->polygon();
+            mColor = color;
+            update();
+        }
+
+        QString toolTip = mName;
+        const QString &type = mObject->type();
+        if (!type.isEmpty())
+            toolTip += QLatin1String(" (") + type + QLatin1String(")");
+        setToolTip(toolTip);
     }
 
-    QString toolTip = mName;
-    const QString &type = mObject->type();
-    if (!type.isEmpty())
-        toolTip += QLatin1String(" (") + type + QLatin1String(")");
-    setToolTip(toolTip);
-
     MapRenderer *renderer = mMapDocument->renderer();
     const QPointF pixelPos = renderer->pixelToScreenCoords(mObject->position());
     QRectF bounds = renderer->boundingRect(mObject);
@@ -124,6 +128,10 @@ void MapObjectItem::resizeObject(const QRectF &bounds)
     // when the object is not actually part of the map yet.
     mObject->setBounds(bounds);
     syncWithMapObject();
+
+    // A batched object group draws the object itself
+    if (ObjectGroupItem *ogItem = static_cast<ObjectGroupItem*>(parentItem()))
+        ogItem->syncWithMapObject(mObject);
 }
 
 void MapObjectItem::setPolygon(const QPolygonF &polygon)
@@ -132,6 +140,9 @@ void MapObjectItem::setPolygon(const QPolygonF &polygon)
     // when the object is not actually part of the map yet.
     mObject->setPolygon(polygon);
     syncWithMapObject();
+
+    if (ObjectGroupItem *ogItem = static_cast<ObjectGroupItem*>(parentItem()))
+        ogItem->syncWithMapObject(mObject);
 }
 
 QColor MapObjectItem::objectColor(const MapObject *object)
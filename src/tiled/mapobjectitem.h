@@ -22,13 +22,12 @@
 #ifndef MAPOBJECTITEM_H
 #define MAPOBJECTITEM_H
 
+#include "mapobject.h"
+
 #include <QCoreApplication>
 #include <QGraphicsItem>
 
 namespace Tiled {
-
-class MapObject;
-
 namespace Internal {
 
 class Handle;
@@ -62,8 +61,9 @@ public:
 
     /**
      * Should be called when the map object this item refers to was changed.
+     * The \a changed properties allow skipping work that isn't needed.
      */
-    void syncWithMapObject();
+    void syncWithMapObject(MapObject::ChangedProperties changed = MapObject::AllProperties);
 
     // QGraphicsItem
     QRectF boundingRect() const override;
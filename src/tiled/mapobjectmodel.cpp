@@ -29,6 +29,7 @@
 #include "renamelayer.h"
 
 #include <QCoreApplication>
+#include <QSet>
 
 #define GROUPS_IN_DISPLAY_ORDER 1
 
@@ -222,7 +223,7 @@ QModelIndex MapObjectModel::index(ObjectGroup *og) const
 
 QModelIndex MapObjectModel::index(MapObject *o, int column) const
 {
-    const int row = o->objectGroup()->objects().indexOf(o);
+    const int row = o->objectGroup()->indexOf(o);
     Q_ASSERT(mObjects[o]);
     return createIndex(row, column, mObjects[o]);
 }
@@ -358,12 +359,57 @@ void MapObjectModel::insertObject(ObjectGroup *og, int index, MapObject *o)
     emit objectsAdded(QList<MapObject*>() << o);
 }
 
+/**
+ * Inserts the given \a objects into \a og at the given \a indexes, which
+ * need to be in ascending order. When no indexes are given, the objects are
+ * appended.
+ *
+ * The objects are appended as a single range of rows and then moved into
+ * place, so that inserting many objects is not more expensive than
+ * reordering the group once.
+ */
+void MapObjectModel::insertObjects(ObjectGroup *og,
+                                   const QList<int> &indexes,
+                                   const QList<MapObject*> &objects)
+{
+    Q_ASSERT(indexes.isEmpty() || indexes.size() == objects.size());
+    if (objects.isEmpty())
+        return;
+
+    const int count = og->objectCount();
+    beginInsertRows(index(og), count, count + objects.size() - 1);
+    for (MapObject *o : objects) {
+        og->addObject(o);
+        mObjects.insert(o, new ObjectOrGroup(o));
+    }
+    endInsertRows();
+
+    if (!indexes.isEmpty() && indexes.first() < count) {
+        const QList<MapObject*> &appended = og->objects();
+        QList<MapObject*> order;
+        order.reserve(appended.size());
+
+        int inserted = 0;
+        int kept = 0;
+        for (int i = 0; i < appended.size(); ++i) {
+            if (inserted < indexes.size() && indexes.at(inserted) == i)
+                order.append(objects.at(inserted++));
+            else
+                order.append(appended.at(kept++));
+        }
+
+        reorderObjects(og, order);
+    }
+
+    emit objectsAdded(objects);
+}
+
 int MapObjectModel::removeObject(ObjectGroup *og, MapObject *o)
 {
     QList<MapObject*> objects;
     objects << o;
 
-    const int row = og->objects().indexOf(o);
+    const int row = og->indexOf(o);
     beginRemoveRows(index(og), row, row);
     og->removeObjectAt(row);
     delete mObjects.take(o);
@@ -372,6 +418,64 @@ int MapObjectModel::removeObject(ObjectGroup *og, MapObject *o)
     return row;
 }
 
+/**
+ * Removes the given \a objects, which may be spread over several object
+ * groups. When the objects within a group are not adjacent, they are first
+ * moved to the end of the group, so that their removal can be announced as
+ * a single range of rows instead of one range for each gap.
+ */
+void MapObjectModel::removeObjects(const QList<MapObject*> &objects)
+{
+    QHash<ObjectGroup*, QSet<MapObject*> > objectsPerGroup;
+    for (MapObject *o : objects)
+        if (ObjectGroup *og = o->objectGroup())
+            objectsPerGroup[og].insert(o);
+
+    QList<MapObject*> removedObjects;
+
+    QHashIterator<ObjectGroup*, QSet<MapObject*> > it(objectsPerGroup);
+    while (it.hasNext()) {
+        it.next();
+        ObjectGroup *og = it.key();
+        const QSet<MapObject*> &toRemove = it.value();
+
+        QList<MapObject*> kept;
+        QList<MapObject*> removed;
+        int first = -1;
+        int last = -1;
+
+        const QList<MapObject*> &groupObjects = og->objects();
+        for (int i = 0; i < groupObjects.size(); ++i) {
+            MapObject *o = groupObjects.at(i);
+            if (toRemove.contains(o)) {
+                removed.append(o);
+                if (first == -1)
+                    first = i;
+                last = i;
+            } else {
+                kept.append(o);
+            }
+        }
+
+        if (last - first + 1 != removed.size()) {
+            first = kept.size();
+            last = groupObjects.size() - 1;
+            reorderObjects(og, kept + removed);
+        }
+
+        beginRemoveRows(index(og), first, last);
+        og->removeObjects(removed);
+        for (MapObject *o : removed)
+            delete mObjects.take(o);
+        endRemoveRows();
+
+        removedObjects.append(removed);
+    }
+
+    if (!removedObjects.isEmpty())
+        emit objectsRemoved(removedObjects);
+}
+
 void MapObjectModel::moveObjects(ObjectGroup *og, int from, int to, int count)
 {
     const QModelIndex parent = index(og);
@@ -384,14 +488,45 @@ void MapObjectModel::moveObjects(ObjectGroup *og, int from, int to, int count)
     endMoveRows();
 }
 
+/**
+ * Changes the order of the objects in \a og to the given list, updating the
+ * persistent model indexes of the moved objects.
+ */
+void MapObjectModel::reorderObjects(ObjectGroup *og,
+                                    const QList<MapObject*> &objects)
+{
+    const QList<QPersistentModelIndex> parents {
+        QPersistentModelIndex(index(og))
+    };
+
+    emit layoutAboutToBeChanged(parents);
+
+    og->reorderObjects(objects);
+
+    QModelIndexList from;
+    QModelIndexList to;
+    for (const QModelIndex &persistentIndex : persistentIndexList()) {
+        if (toObjectGroup(persistentIndex.parent()) != og)
+            continue;
+
+        MapObject *o = toMapObject(persistentIndex);
+        from.append(persistentIndex);
+        to.append(index(o, persistentIndex.column()));
+    }
+    changePersistentIndexList(from, to);
+
+    emit layoutChanged(parents);
+}
+
 // ObjectGroup color changed
 // FIXME: layerChanged should let the scene know that objects need redrawing
-void MapObjectModel::emitObjectsChanged(const QList<MapObject *> &objects)
+void MapObjectModel::emitObjectsChanged(const QList<MapObject *> &objects,
+                                        MapObject::ChangedProperties properties)
 {
     if (objects.isEmpty())
         return;
 
-    emit objectsChanged(objects);
+    emit objectsChanged(objects, properties);
 }
 
 void MapObjectModel::setObjectName(MapObject *o, const QString &name)
@@ -402,7 +537,7 @@ void MapObjectModel::setObjectName(MapObject *o, const QString &name)
     o->setName(name);
     QModelIndex index = this->index(o);
     emit dataChanged(index, index);
-    emit objectsChanged(QList<MapObject*>() << o);
+    emit objectsChanged(QList<MapObject*>() << o, MapObject::NameProperty);
 }
 
 void MapObjectModel::setObjectType(MapObject *o, const QString &type)
@@ -415,7 +550,7 @@ void MapObjectModel::setObjectType(MapObject *o, const QString &type)
     emit dataChanged(index, index);
 
     QList<MapObject*> objects = QList<MapObject*>() << o;
-    emit objectsChanged(objects);
+    emit objectsChanged(objects, MapObject::TypeProperty);
     emit objectsTypeChanged(objects);
 }
 
@@ -425,7 +560,7 @@ void MapObjectModel::setObjectPolygon(MapObject *o, const QPolygonF &polygon)
         return;
 
     o->setPolygon(polygon);
-    emit objectsChanged(QList<MapObject*>() << o);
+    emit objectsChanged(QList<MapObject*>() << o, MapObject::ShapeProperty);
 }
 
 void MapObjectModel::setObjectPosition(MapObject *o, const QPointF &pos)
@@ -434,7 +569,7 @@ void MapObjectModel::setObjectPosition(MapObject *o, const QPointF &pos)
         return;
 
     o->setPosition(pos);
-    emit objectsChanged(QList<MapObject*>() << o);
+    emit objectsChanged(QList<MapObject*>() << o, MapObject::PositionProperty);
 }
 
 void MapObjectModel::setObjectSize(MapObject *o, const QSizeF &size)
@@ -443,7 +578,7 @@ void MapObjectModel::setObjectSize(MapObject *o, const QSizeF &size)
         return;
 
     o->setSize(size);
-    emit objectsChanged(QList<MapObject*>() << o);
+    emit objectsChanged(QList<MapObject*>() << o, MapObject::SizeProperty);
 }
 
 void MapObjectModel::setObjectRotation(MapObject *o, qreal rotation)
@@ -452,7 +587,7 @@ void MapObjectModel::setObjectRotation(MapObject *o, qreal rotation)
         return;
 
     o->setRotation(rotation);
-    emit objectsChanged(QList<MapObject*>() << o);
+    emit objectsChanged(QList<MapObject*>() << o, MapObject::RotationProperty);
 }
 
 void MapObjectModel::setObjectVisible(MapObject *o, bool visible)
@@ -463,5 +598,5 @@ void MapObjectModel::setObjectVisible(MapObject *o, bool visible)
     o->setVisible(visible);
     QModelIndex index = this->index(o);
     emit dataChanged(index, index);
-    emit objectsChanged(QList<MapObject*>() << o);
+    emit objectsChanged(QList<MapObject*>() << o, MapObject::VisibleProperty);
 }
@@ -21,12 +21,14 @@
 #ifndef MAPOBJECTMODEL_H
 #define MAPOBJECTMODEL_H
 
+#include "mapobject.h"
+
 #include <QAbstractItemModel>
+#include <QHash>
 #include <QIcon>
 
 namespace Tiled {
 
-class MapObject;
 class Map;
 class ObjectGroup;
 
@@ -90,9 +92,14 @@ public:
     MapDocument *mapDocument() const { return mMapDocument; }
 
     void insertObject(ObjectGroup *og, int index, MapObject *o);
+    void insertObjects(ObjectGroup *og,
+                       const QList<int> &indexes,
+                       const QList<MapObject*> &objects);
     int removeObject(ObjectGroup *og, MapObject *o);
+    void removeObjects(const QList<MapObject*> &objects);
     void moveObjects(ObjectGroup *og, int from, int to, int count);
-    void emitObjectsChanged(const QList<MapObject *> &objects);
+    void emitObjectsChanged(const QList<MapObject *> &objects,
+                            MapObject::ChangedProperties properties = MapObject::AllProperties);
 
     void setObjectName(MapObject *o, const QString &name);
     void setObjectType(MapObject *o, const QString &type);
@@ -104,7 +111,8 @@ public:
 
 signals:
     void objectsAdded(const QList<MapObject *> &objects);
-    void objectsChanged(const QList<MapObject *> &objects);
+    void objectsChanged(const QList<MapObject *> &objects,
+                        MapObject::ChangedProperties properties = MapObject::AllProperties);
     void objectsTypeChanged(const QList<MapObject *> &objects);
     void objectsRemoved(const QList<MapObject *> &objects);
 
@@ -114,11 +122,13 @@ private slots:
     void layerAboutToBeRemoved(int index);
 
 private:
+    void reorderObjects(ObjectGroup *og, const QList<MapObject*> &objects);
+
     MapDocument *mMapDocument;
     Map *mMap;
     QList<ObjectGroup*> mObjectGroups;
-    QMap<MapObject*, ObjectOrGroup*> mObjects;
-    QMap<ObjectGroup*, ObjectOrGroup*> mGroups;
+    QHash<MapObject*, ObjectOrGroup*> mObjects;
+    QHash<ObjectGroup*, ObjectOrGroup*> mGroups;
 
     QIcon mObjectGroupIcon;
 };
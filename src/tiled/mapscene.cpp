@@ -50,6 +50,7 @@
 #include <QKeyEvent>
 #include <QPalette>
 
+#include <algorithm>
 #include <cmath>
 
 using namespace Tiled;
@@ -58,6 +59,9 @@ using namespace Tiled::Internal;
 static const qreal darkeningFactor = 0.6;
 static const qreal opacityFactor = 0.4;
 
+// Object groups with at least this many objects are drawn in one batch
+static const int batchedObjectGroupThreshold = 1000;
+
 MapScene::MapScene(QObject *parent):
     QGraphicsScene(parent),
     mMapDocument(nullptr),
@@ -156,8 +160,8 @@ void MapScene::setMapDocument(MapDocument *mapDocument)
                 this, SLOT(objectsInserted(ObjectGroup*,int,int)));
         connect(mMapDocument, SIGNAL(objectsRemoved(QList<MapObject*>)),
                 this, SLOT(objectsRemoved(QList<MapObject*>)));
-        connect(mMapDocument, SIGNAL(objectsChanged(QList<MapObject*>)),
-                this, SLOT(objectsChanged(QList<MapObject*>)));
+        connect(mMapDocument, &MapDocument::objectsChanged,
+                this, &MapScene::objectsChanged);
         connect(mMapDocument, SIGNAL(objectsIndexChanged(ObjectGroup*,int,int)),
                 this, SLOT(objectsIndexChanged(ObjectGroup*,int,int)));
         connect(mMapDocument, SIGNAL(selectedObjectsChanged()),
@@ -188,6 +192,7 @@ void MapScene::refreshScene()
 {
     mLayerItems.clear();
     mObjectItems.clear();
+    mOnDemandObjects.clear();
 
     removeItem(mDarkRectangle);
     clear();
@@ -235,19 +240,14 @@ QGraphicsItem *MapScene::createLayerItem(Layer *layer)
     if (TileLayer *tl = layer->asTileLayer()) {
         layerItem = new TileLayerItem(tl, mMapDocument);
     } else if (ObjectGroup *og = layer->asObjectGroup()) {
-        const ObjectGroup::DrawOrder drawOrder = og->drawOrder();
-        ObjectGroupItem *ogItem = new ObjectGroupItem(og);
-        int objectIndex = 0;
-        for (MapObject *object : og->objects()) {
-            MapObjectItem *item = new MapObjectItem(object, mMapDocument,
-                                                    ogItem);
-            if (drawOrder == ObjectGroup::TopDownOrder)
-                item->setZValue(item->y());
-            else
-                item->setZValue(objectIndex);
-
-            mObjectItems.insert(object, item);
-            ++objectIndex;
+        ObjectGroupItem *ogItem;
+        if (og->objectCount() >= batchedObjectGroupThreshold) {
+            ogItem = new ObjectGroupItem(og, mMapDocument);
+        } else {
+            ogItem = new ObjectGroupItem(og);
+            int objectIndex = 0;
+            for (MapObject *object : og->objects())
+                createObjectItem(object, ogItem, objectIndex++);
         }
         layerItem = ogItem;
     } else if (ImageLayer *il = layer->asImageLayer()) {
@@ -260,6 +260,182 @@ QGraphicsItem *MapScene::createLayerItem(Layer *layer)
     return layerItem;
 }
 
+ObjectGroupItem *MapScene::objectGroupItem(ObjectGroup *objectGroup) const
+{
+    for (QGraphicsItem *item : mLayerItems) {
+        if (ObjectGroupItem *ogi = dynamic_cast<ObjectGroupItem*>(item)) {
+            if (ogi->objectGroup() == objectGroup)
+                return ogi;
+        }
+    }
+    return nullptr;
+}
+
+MapObjectItem *MapScene::createObjectItem(MapObject *object,
+                                          ObjectGroupItem *ogItem,
+                                          int index)
+{
+    MapObjectItem *item = new MapObjectItem(object, mMapDocument, ogItem);
+    if (object->objectGroup()->drawOrder() == ObjectGroup::TopDownOrder)
+        item->setZValue(item->y());
+    else
+        item->setZValue(index);
+
+    // The batch keeps drawing the object, so it stays at the right depth
+    if (ogItem->isBatched()) {
+        item->setFlag(QGraphicsItem::ItemHasNoContents);
+        mOnDemandObjects.insert(object);
+    }
+
+    mObjectItems.insert(object, item);
+    return item;
+}
+
+/**
+ * Deletes the items that were created on demand for objects in batched
+ * object groups, except for the selected objects and the objects at the
+ * given \a pos, in scene coordinates.
+ */
+void MapScene::releaseObjectItems(const QPointF &pos)
+{
+    if (mOnDemandObjects.isEmpty())
+        return;
+
+    const MapRenderer *renderer = mMapDocument->renderer();
+    QSet<MapObject*> hoveredObjects;
+
+    for (QGraphicsItem *item : mLayerItems) {
+        ObjectGroupItem *ogItem = dynamic_cast<ObjectGroupItem*>(item);
+        if (!ogItem || !ogItem->isBatched() || !ogItem->isVisible())
+            continue;
+
+        for (MapObject *object : renderer->objectsAt(ogItem->objectGroup(),
+                                                     ogItem->mapFromScene(pos)))
+            hoveredObjects.insert(object);
+    }
+
+    QSet<MapObject*>::iterator it = mOnDemandObjects.begin();
+    while (it != mOnDemandObjects.end()) {
+        MapObject *object = *it;
+        MapObjectItem *item = mObjectItems.value(object);
+
+        if (hoveredObjects.contains(object) || mSelectedObjectItems.contains(item)) {
+            ++it;
+            continue;
+        }
+
+        mObjectItems.remove(object);
+        delete item;
+        it = mOnDemandObjects.erase(it);
+    }
+}
+
+/**
+ * Returns the item for the given \a object, creating it when the object is
+ * part of a batched object group.
+ */
+MapObjectItem *MapScene::ensureObjectItem(MapObject *object)
+{
+    if (MapObjectItem *item = mObjectItems.value(object))
+        return item;
+
+    ObjectGroupItem *ogItem = objectGroupItem(object->objectGroup());
+    if (!ogItem || !ogItem->isBatched())
+        return nullptr;
+
+    return createObjectItem(object, ogItem, ogItem->objectIndex(object));
+}
+
+/**
+ * Returns whether \a a is drawn below \a b, when both are objects in the
+ * given object group.
+ */
+static bool drawnBelow(const MapObject *a, int indexA,
+                       const MapObject *b, int indexB,
+                       const MapRenderer *renderer)
+{
+    if (a->objectGroup()->drawOrder() == ObjectGroup::TopDownOrder) {
+        const qreal ya = renderer->pixelToScreenCoords(a->position()).y();
+        const qreal yb = renderer->pixelToScreenCoords(b->position()).y();
+        if (ya != yb)
+            return ya < yb;
+    }
+    return indexA < indexB;
+}
+
+MapObjectItem *MapScene::topMostObjectItemAt(const QPointF &pos)
+{
+    const MapRenderer *renderer = mMapDocument->renderer();
+
+    for (int i = mLayerItems.size() - 1; i >= 0; --i) {
+        ObjectGroupItem *ogItem = dynamic_cast<ObjectGroupItem*>(mLayerItems.at(i));
+        if (!ogItem || !ogItem->isVisible())
+            continue;
+
+        const QVector<MapObject*> objects =
+                renderer->objectsAt(ogItem->objectGroup(),
+                                    ogItem->mapFromScene(pos));
+
+        MapObject *topMost = nullptr;
+        int topMostIndex = -1;
+
+        for (MapObject *object : objects) {
+            const int index = ogItem->objectIndex(object);
+            if (!topMost || drawnBelow(topMost, topMostIndex, object, index, renderer)) {
+                topMost = object;
+                topMostIndex = index;
+            }
+        }
+
+        if (topMost)
+            return ensureObjectItem(topMost);
+    }
+
+    return nullptr;
+}
+
+QList<MapObjectItem*> MapScene::objectItemsIntersecting(const QPainterPath &path,
+                                                        ObjectGroup *objectGroup)
+{
+    const MapRenderer *renderer = mMapDocument->renderer();
+    QList<MapObjectItem*> items;
+
+    for (QGraphicsItem *item : mLayerItems) {
+        ObjectGroupItem *ogItem = dynamic_cast<ObjectGroupItem*>(item);
+        if (!ogItem || !ogItem->isVisible())
+            continue;
+        if (objectGroup && ogItem->objectGroup() != objectGroup)
+            continue;
+
+        QVector<MapObject*> objects =
+                renderer->objectsIntersecting(ogItem->objectGroup(),
+                                              ogItem->mapFromScene(path));
+
+        std::sort(objects.begin(), objects.end(),
+                  [&] (const MapObject *a, const MapObject *b) {
+            return drawnBelow(a, ogItem->objectIndex(a),
+                              b, ogItem->objectIndex(b),
+                              renderer);
+        });
+
+        for (MapObject *object : objects)
+            items.append(ensureObjectItem(object));
+    }
+
+    return items;
+}
+
+void MapScene::syncObjectGroupItems()
+{
+    for (QGraphicsItem *item : mLayerItems) {
+        if (ObjectGroupItem *ogItem = dynamic_cast<ObjectGroupItem*>(item)) {
+            // The bounds of the objects may have changed
+            ogItem->objectGroup()->invalidateObjectIndex();
+            ogItem->syncWithMapObjects();
+        }
+    }
+}
+
 void MapScene::updateDefaultBackgroundColor()
 {
     mDefaultBackgroundColor = QGuiApplication::palette().dark().color();
@@ -387,6 +563,8 @@ void MapScene::mapChanged()
     for (MapObjectItem *item : mObjectItems)
         item->syncWithMapObject();
 
+    syncObjectGroupItems();
+
     const Map *map = mMapDocument->map();
     if (map->backgroundColor().isValid())
         setBackgroundBrush(map->backgroundColor());
@@ -492,6 +670,8 @@ void MapScene::adaptToTilesetTileSizeChanges(Tileset *tileset)
         if (!cell.isEmpty() && cell.tile->tileset() == tileset)
             item->syncWithMapObject();
     }
+
+    syncObjectGroupItems();
 }
 
 void MapScene::adaptToTileSizeChanges(Tile *tile)
@@ -507,6 +687,8 @@ void MapScene::adaptToTileSizeChanges(Tile *tile)
         if (cell.tile == tile)
             item->syncWithMapObject();
     }
+
+    syncObjectGroupItems();
 }
 
 void MapScene::tilesetReplaced(int index, Tileset *tileset)
@@ -520,33 +702,15 @@ void MapScene::tilesetReplaced(int index, Tileset *tileset)
  */
 void MapScene::objectsInserted(ObjectGroup *objectGroup, int first, int last)
 {
-    ObjectGroupItem *ogItem = nullptr;
-
-    // Find the object group item for the object group
-    for (QGraphicsItem *item : mLayerItems) {
-        if (ObjectGroupItem *ogi = dynamic_cast<ObjectGroupItem*>(item)) {
-            if (ogi->objectGroup() == objectGroup) {
-                ogItem = ogi;
-                break;
-            }
-        }
-    }
-
+    ObjectGroupItem *ogItem = objectGroupItem(objectGroup);
     Q_ASSERT(ogItem);
 
-    const ObjectGroup::DrawOrder drawOrder = objectGroup->drawOrder();
-
-    for (int i = first; i <= last; ++i) {
-        MapObject *object = objectGroup->objectAt(i);
-
-        MapObjectItem *item = new MapObjectItem(object, mMapDocument, ogItem);
-        if (drawOrder == ObjectGroup::TopDownOrder)
-            item->setZValue(item->y());
-        else
-            item->setZValue(i);
+    ogItem->objectsInserted(first, last);
+    if (ogItem->isBatched())
+        return;
 
-        mObjectItems.insert(object, item);
-    }
+    for (int i = first; i <= last; ++i)
+        createObjectItem(objectGroup->objectAt(i), ogItem, i);
 }
 
 /**
@@ -554,11 +718,21 @@ void MapScene::objectsInserted(ObjectGroup *objectGroup, int first, int last)
  */
 void MapScene::objectsRemoved(const QList<MapObject*> &objects)
 {
+    QVector<ObjectGroupItem*> ogItems;
+    for (QGraphicsItem *item : mLayerItems)
+        if (ObjectGroupItem *ogItem = dynamic_cast<ObjectGroupItem*>(item))
+            ogItems.append(ogItem);
+
     for (MapObject *o : objects) {
+        for (ObjectGroupItem *ogItem : ogItems)
+            ogItem->objectRemoved(o);
+
         ObjectItems::iterator i = mObjectItems.find(o);
-        Q_ASSERT(i != mObjectItems.end());
+        if (i == mObjectItems.end())
+            continue;   // Part of a batched object group
 
         mSelectedObjectItems.remove(i.value());
+        mOnDemandObjects.remove(o);
         delete i.value();
         mObjectItems.erase(i);
     }
@@ -567,13 +741,26 @@ void MapScene::objectsRemoved(const QList<MapObject*> &objects)
 /**
  * Updates the map object items related to the given objects.
  */
-void MapScene::objectsChanged(const QList<MapObject*> &objects)
+void MapScene::objectsChanged(const QList<MapObject*> &objects,
+                              MapObject::ChangedProperties properties)
 {
+    ObjectGroup *objectGroup = nullptr;
+    ObjectGroupItem *ogItem = nullptr;
+
     for (MapObject *object : objects) {
+        if (object->objectGroup() != objectGroup) {
+            objectGroup = object->objectGroup();
+            ogItem = objectGroupItem(objectGroup);
+        }
+
+        if (ogItem && ogItem->isBatched())
+            ogItem->syncWithMapObject(object);
+
         MapObjectItem *item = itemForObject(object);
-        Q_ASSERT(item);
+        Q_ASSERT(item || (ogItem && ogItem->isBatched()));
 
-        item->syncWithMapObject();
+        if (item)
+            item->syncWithMapObject(properties);
     }
 }
 
@@ -583,14 +770,21 @@ void MapScene::objectsChanged(const QList<MapObject*> &objects)
 void MapScene::objectsIndexChanged(ObjectGroup *objectGroup,
                                    int first, int last)
 {
+    ObjectGroupItem *ogItem = objectGroupItem(objectGroup);
+    if (ogItem)
+        ogItem->objectsIndexChanged();
+
     if (objectGroup->drawOrder() != ObjectGroup::IndexOrder)
         return;
 
+    const bool batched = ogItem && ogItem->isBatched();
+
     for (int i = first; i <= last; ++i) {
         MapObjectItem *item = itemForObject(objectGroup->objectAt(i));
-        Q_ASSERT(item);
+        Q_ASSERT(item || batched);
 
-        item->setZValue(i);
+        if (item)
+            item->setZValue(i);
     }
 }
 
@@ -600,7 +794,7 @@ void MapScene::updateSelectedObjectItems()
 
     QSet<MapObjectItem*> items;
     for (MapObject *object : objects) {
-        MapObjectItem *item = itemForObject(object);
+        MapObjectItem *item = ensureObjectItem(object);
         Q_ASSERT(item);
 
         items.insert(item);
@@ -614,6 +808,8 @@ void MapScene::syncAllObjectItems()
 {
     for (MapObjectItem *item : mObjectItems)
         item->syncWithMapObject();
+
+    syncObjectGroupItems();
 }
 
 /**
@@ -639,12 +835,11 @@ void MapScene::setObjectLineWidth(qreal lineWidth)
         mMapDocument->renderer()->setObjectLineWidth(lineWidth);
 
         // Changing the line width can change the size of the object items
-        if (!mObjectItems.isEmpty()) {
-            for (MapObjectItem *item : mObjectItems)
-                item->syncWithMapObject();
+        for (MapObjectItem *item : mObjectItems)
+            item->syncWithMapObject();
 
-            update();
-        }
+        syncObjectGroupItems();
+        update();
     }
 }
 
@@ -657,8 +852,7 @@ void MapScene::setShowTileObjectOutlines(bool enabled)
 
     if (mMapDocument) {
         mMapDocument->renderer()->setFlag(ShowTileObjectOutlines, enabled);
-        if (!mObjectItems.isEmpty())
-            update();
+        update();
     }
 }
 
@@ -703,6 +897,10 @@ bool MapScene::event(QEvent *event)
         if (mActiveTool)
             mActiveTool->mouseLeft();
         break;
+    case QEvent::ApplicationFontChange:
+        if (mObjectSelectionItem)
+            mObjectSelectionItem->applicationFontChanged();
+        break;
     default:
         break;
     }
@@ -735,6 +933,10 @@ void MapScene::mouseMoveEvent(QGraphicsSceneMouseEvent *mouseEvent)
                                 mouseEvent->modifiers());
         mouseEvent->accept();
     }
+
+    // Tools only hold on to object items while a mouse button is pressed
+    if (mouseEvent->buttons() == Qt::NoButton)
+        releaseObjectItems(mouseEvent->scenePos());
 }
 
 void MapScene::mousePressEvent(QGraphicsSceneMouseEvent *mouseEvent)
@@ -24,16 +24,17 @@
 #ifndef MAPSCENE_H
 #define MAPSCENE_H
 
+#include "mapobject.h"
+
 #include <QColor>
 #include <QGraphicsScene>
-#include <QMap>
+#include <QHash>
 #include <QSet>
 
 namespace Tiled {
 
 class ImageLayer;
 class Layer;
-class MapObject;
 class ObjectGroup;
 class Tile;
 class TileLayer;
@@ -99,6 +100,26 @@ public:
     MapObjectItem *itemForObject(MapObject *object) const
     { return mObjectItems.value(object); }
 
+    /**
+     * Returns the topmost map object item at the given \a pos, given in
+     * scene coordinates, or nullptr when there is no object.
+     *
+     * The object groups are queried through their spatial index, rather
+     * than looking for items in the scene, since object groups with many
+     * objects only create items for objects on demand.
+     */
+    MapObjectItem *topMostObjectItemAt(const QPointF &pos);
+
+    /**
+     * Returns the map object items of the objects whose shapes intersect the
+     * given \a path, given in scene coordinates. The items are sorted from
+     * bottom to top.
+     *
+     * When \a objectGroup is given, only its objects are considered.
+     */
+    QList<MapObjectItem*> objectItemsIntersecting(const QPainterPath &path,
+                                                  ObjectGroup *objectGroup = nullptr);
+
     /**
      * Enables the selected tool at this map scene.
      * Therefore it tells that tool, that this is the active map scene.
@@ -172,7 +193,8 @@ private slots:
 
     void objectsInserted(ObjectGroup *objectGroup, int first, int last);
     void objectsRemoved(const QList<MapObject*> &objects);
-    void objectsChanged(const QList<MapObject*> &objects);
+    void objectsChanged(const QList<MapObject*> &objects,
+                        MapObject::ChangedProperties properties = MapObject::AllProperties);
     void objectsIndexChanged(ObjectGroup *objectGroup, int first, int last);
 
     void updateSelectedObjectItems();
@@ -180,6 +202,13 @@ private slots:
 
 private:
     QGraphicsItem *createLayerItem(Layer *layer);
+    ObjectGroupItem *objectGroupItem(ObjectGroup *objectGroup) const;
+    MapObjectItem *createObjectItem(MapObject *object,
+                                    ObjectGroupItem *ogItem,
+                                    int index);
+    MapObjectItem *ensureObjectItem(MapObject *object);
+    void releaseObjectItems(const QPointF &pos);
+    void syncObjectGroupItems();
 
     void updateDefaultBackgroundColor();
     void updateSceneRect();
@@ -202,8 +231,9 @@ private:
     QColor mDefaultBackgroundColor;
     ObjectSelectionItem *mObjectSelectionItem;
 
-    typedef QMap<MapObject*, MapObjectItem*> ObjectItems;
+    typedef QHash<MapObject*, MapObjectItem*> ObjectItems;
     ObjectItems mObjectItems;
+    QSet<MapObject*> mOnDemandObjects;  /**< Have items in a batched group. */
     QSet<MapObjectItem*> mSelectedObjectItems;
 };
 
@@ -26,30 +26,50 @@
 #include "mapobjectmodel.h"
 
 #include <QCoreApplication>
+#include <QHash>
 
 using namespace Tiled;
 using namespace Tiled::Internal;
 
 MoveMapObjectToGroup::MoveMapObjectToGroup(MapDocument *mapDocument,
-                                           MapObject *mapObject,
+                                           const QList<MapObject*> &mapObjects,
                                            ObjectGroup *objectGroup)
     : mMapDocument(mapDocument)
-    , mMapObject(mapObject)
-    , mOldObjectGroup(mapObject->objectGroup())
+    , mMapObjects(mapObjects)
     , mNewObjectGroup(objectGroup)
 {
+    for (MapObject *mapObject : mapObjects)
+        mOldObjectGroups.append(mapObject->objectGroup());
+
     setText(QCoreApplication::translate("Undo Commands",
-                                        "Move Object to Layer"));
+                                        "Move %n Object(s) to Layer",
+                                        nullptr, mapObjects.size()));
 }
 
 void MoveMapObjectToGroup::undo()
 {
-    mMapDocument->mapObjectModel()->removeObject(mNewObjectGroup, mMapObject);
-    mMapDocument->mapObjectModel()->insertObject(mOldObjectGroup, -1, mMapObject);
+    MapObjectModel *mapObjectModel = mMapDocument->mapObjectModel();
+    mapObjectModel->removeObjects(mMapObjects);
+
+    // Append the objects to their old groups, preserving their order
+    QList<ObjectGroup*> objectGroups;
+    QHash<ObjectGroup*, QList<MapObject*> > objectsPerGroup;
+
+    for (int i = 0; i < mMapObjects.size(); ++i) {
+        ObjectGroup *objectGroup = mOldObjectGroups.at(i);
+        if (!objectsPerGroup.contains(objectGroup))
+            objectGroups.append(objectGroup);
+        objectsPerGroup[objectGroup].append(mMapObjects.at(i));
+    }
+
+    for (ObjectGroup *objectGroup : objectGroups)
+        mapObjectModel->insertObjects(objectGroup, QList<int>(),
+                                      objectsPerGroup.value(objectGroup));
 }
 
 void MoveMapObjectToGroup::redo()
 {
-    mMapDocument->mapObjectModel()->removeObject(mOldObjectGroup, mMapObject);
-    mMapDocument->mapObjectModel()->insertObject(mNewObjectGroup, -1, mMapObject);
+    MapObjectModel *mapObjectModel = mMapDocument->mapObjectModel();
+    mapObjectModel->removeObjects(mMapObjects);
+    mapObjectModel->insertObjects(mNewObjectGroup, QList<int>(), mMapObjects);
 }
@@ -21,6 +21,7 @@
 #ifndef MOVEMAPOBJECTTOGROUP_H
 #define MOVEMAPOBJECTTOGROUP_H
 
+#include <QList>
 #include <QUndoCommand>
 
 namespace Tiled {
@@ -32,11 +33,16 @@ namespace Internal {
 
 class MapDocument;
 
+/**
+ * Undo command that moves a number of objects to another object group. The
+ * objects are appended to the new group, and back to their old groups on
+ * undo.
+ */
 class MoveMapObjectToGroup : public QUndoCommand
 {
 public:
     MoveMapObjectToGroup(MapDocument *mapDocument,
-                         MapObject *mapObject,
+                         const QList<MapObject*> &mapObjects,
                          ObjectGroup *objectGroup);
 
     void undo() override;
@@ -44,8 +50,8 @@ public:
 
 private:
     MapDocument *mMapDocument;
-    MapObject *mMapObject;
-    ObjectGroup *mOldObjectGroup;
+    QList<MapObject*> mMapObjects;
+    QList<ObjectGroup*> mOldObjectGroups;
     ObjectGroup *mNewObjectGroup;
 };
 
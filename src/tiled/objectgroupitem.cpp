@@ -21,29 +21,279 @@
 #include "objectgroupitem.h"
 
 #include "map.h"
+#include "mapdocument.h"
+#include "mapobject.h"
 #include "mapobjectitem.h"
+#include "maprenderer.h"
 #include "objectgroup.h"
+#include "spatialindex.h"
+
+#include <QPainter>
+#include <QPainterPath>
+#include <QStyleOptionGraphicsItem>
+
+#include <algorithm>
 
 using namespace Tiled;
 using namespace Tiled::Internal;
 
-ObjectGroupItem::ObjectGroupItem(ObjectGroup *objectGroup):
-    mObjectGroup(objectGroup)
+ObjectGroupItem::ObjectGroupItem(ObjectGroup *objectGroup,
+                                 MapDocument *mapDocument):
+    mObjectGroup(objectGroup),
+    mMapDocument(mapDocument),
+    mObjectIndexesDirty(true)
 {
-    // Since we don't do any painting, we can spare us the call to paint()
-    setFlag(QGraphicsItem::ItemHasNoContents);
+    if (mMapDocument) {
+        // Needed for the exposed rect, which is used for culling
+        setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+        syncWithMapObjects();
+    } else {
+        // Since we don't do any painting, we can spare us the call to paint()
+        setFlag(QGraphicsItem::ItemHasNoContents);
+    }
 
     setOpacity(objectGroup->opacity());
     setPos(objectGroup->offset());
 }
 
+/**
+ * Adds the objects in the range \a first to \a last, which were just inserted
+ * into the object group.
+ */
+void ObjectGroupItem::objectsInserted(int first, int last)
+{
+    mObjectIndexesDirty = true;
+
+    if (!isBatched())
+        return;
+
+    for (int i = first; i <= last; ++i) {
+        MapObject *object = mObjectGroup->objectAt(i);
+        const Entry entry = createEntry(object);
+
+        mEntries.insert(object, entry);
+
+        if (!mBoundingRect.contains(entry.bounds)) {
+            prepareGeometryChange();
+            mBoundingRect |= entry.bounds;
+        }
+
+        update(entry.bounds);
+    }
+}
+
+void ObjectGroupItem::objectRemoved(MapObject *object)
+{
+    mObjectIndexesDirty = true;
+
+    auto it = mEntries.find(object);
+    if (it == mEntries.end())
+        return;
+
+    update(it.value().bounds);
+    mEntries.erase(it);
+}
+
+void ObjectGroupItem::objectsIndexChanged()
+{
+    mObjectIndexesDirty = true;
+
+    if (isBatched())
+        update();
+}
+
+/**
+ * Should be called when the given \a object was changed.
+ */
+void ObjectGroupItem::syncWithMapObject(MapObject *object)
+{
+    auto it = mEntries.find(object);
+    if (it == mEntries.end())
+        return;
+
+    const Entry entry = createEntry(object);
+    const QRectF oldBounds = it.value().bounds;
+    it.value() = entry;
+
+    if (!mBoundingRect.contains(entry.bounds)) {
+        prepareGeometryChange();
+        mBoundingRect |= entry.bounds;
+    }
+
+    update(oldBounds);
+    update(entry.bounds);
+}
+
+/**
+ * Updates all objects, for example after the renderer or the object types
+ * changed.
+ */
+void ObjectGroupItem::syncWithMapObjects()
+{
+    if (!isBatched())
+        return;
+
+    prepareGeometryChange();
+
+    QHash<MapObject*, Entry> entries;
+    entries.reserve(mObjectGroup->objectCount());
+
+    mBoundingRect = QRectF();
+
+    for (MapObject *object : mObjectGroup->objects()) {
+        const Entry entry = createEntry(object);
+        entries.insert(object, entry);
+        mBoundingRect |= entry.bounds;
+    }
+
+    mEntries.swap(entries);
+    mObjectIndexesDirty = true;
+
+    update();
+}
+
+/**
+ * Returns the visible objects whose bounds intersect the given \a rect, in
+ * item coordinates.
+ */
+QVector<MapObject*> ObjectGroupItem::objectsIntersecting(const QRectF &rect) const
+{
+    const SpatialIndex &index = mObjectGroup->objectIndex(mMapDocument->renderer());
+    QVector<MapObject*> objects = index.intersecting(rect);
+
+    auto isHidden = [] (MapObject *object) { return !object->isVisible(); };
+
+    objects.erase(std::remove_if(objects.begin(), objects.end(), isHidden),
+                  objects.end());
+
+    return objects;
+}
+
+/**
+ * Returns the index of the given \a object in its object group, or -1 when
+ * it isn't part of this group.
+ */
+int ObjectGroupItem::objectIndex(const MapObject *object) const
+{
+    if (mObjectIndexesDirty) {
+        mObjectIndexes.clear();
+        mObjectIndexes.reserve(mObjectGroup->objectCount());
+
+        int index = 0;
+        for (MapObject *o : mObjectGroup->objects())
+            mObjectIndexes.insert(o, index++);
+
+        mObjectIndexesDirty = false;
+    }
+
+    return mObjectIndexes.value(object, -1);
+}
+
 QRectF ObjectGroupItem::boundingRect() const
 {
-    return QRectF();
+    return mBoundingRect;
 }
 
-void ObjectGroupItem::paint(QPainter *,
-                            const QStyleOptionGraphicsItem *,
+void ObjectGroupItem::paint(QPainter *painter,
+                            const QStyleOptionGraphicsItem *option,
                             QWidget *)
 {
+    if (!isBatched())
+        return;
+
+    const QVector<MapObject*> objects = objectsIntersecting(option->exposedRect);
+    if (objects.isEmpty())
+        return;
+
+    // Determine the drawing order, matching the Z values that would be used
+    // for individual MapObjectItem instances.
+    struct DrawItem
+    {
+        qreal y;
+        int index;
+        MapObject *object;
+        const Entry *entry;
+
+        bool operator < (const DrawItem &other) const
+        {
+            if (y != other.y)
+                return y < other.y;
+            return index < other.index;
+        }
+    };
+
+    const bool topDown = mObjectGroup->drawOrder() == ObjectGroup::TopDownOrder;
+
+    QVector<DrawItem> drawItems;
+    drawItems.reserve(objects.size());
+
+    for (MapObject *object : objects) {
+        auto it = mEntries.constFind(object);
+        if (it == mEntries.constEnd())
+            continue;
+
+        const Entry &entry = it.value();
+        const DrawItem item = {
+            topDown ? entry.pixelPos.y() : 0,
+            objectIndex(object),
+            object,
+            &entry
+        };
+        drawItems.append(item);
+    }
+
+    std::sort(drawItems.begin(), drawItems.end());
+
+    MapRenderer *renderer = mMapDocument->renderer();
+    renderer->setPainterScale(option->levelOfDetailFromTransform(painter->worldTransform()));
+
+    const QTransform transform = painter->transform();
+
+    // Rather than stroking the outline of each tile object separately, the
+    // outlines are merged into one path per color and drawn on top
+    const bool tileObjectOutlines = renderer->testFlag(ShowTileObjectOutlines);
+    QHash<QRgb, QPainterPath> outlines;
+    renderer->setFlag(ShowTileObjectOutlines, false);
+
+    for (const DrawItem &item : drawItems) {
+        const qreal rotation = item.object->rotation();
+        QTransform objectTransform;
+
+        if (rotation != 0) {
+            const QPointF &pos = item.entry->pixelPos;
+            objectTransform.translate(pos.x(), pos.y());
+            objectTransform.rotate(rotation);
+            objectTransform.translate(-pos.x(), -pos.y());
+            painter->setTransform(objectTransform * transform);
+        }
+
+        renderer->drawMapObject(painter, item.object, item.entry->color);
+
+        if (rotation != 0)
+            painter->setTransform(transform);
+
+        if (tileObjectOutlines) {
+            const QRectF outline = renderer->tileObjectOutline(item.object);
+            if (!outline.isNull()) {
+                QPainterPath &path = outlines[item.entry->color.rgba()];
+                path.addPolygon(objectTransform.map(QPolygonF(outline)));
+            }
+        }
+    }
+
+    renderer->setFlag(ShowTileObjectOutlines, tileObjectOutlines);
+
+    for (auto it = outlines.constBegin(); it != outlines.constEnd(); ++it)
+        MapRenderer::drawTileObjectOutlines(painter, it.value(), QColor::fromRgba(it.key()));
+}
+
+ObjectGroupItem::Entry ObjectGroupItem::createEntry(MapObject *object) const
+{
+    const MapRenderer *renderer = mMapDocument->renderer();
+
+    Entry entry;
+    entry.pixelPos = renderer->pixelToScreenCoords(object->position());
+    entry.bounds = renderer->rotatedBoundingRect(object);
+    entry.color = MapObjectItem::objectColor(object);
+    return entry;
 }
@@ -21,27 +21,55 @@
 #ifndef OBJECTGROUPITEM_H
 #define OBJECTGROUPITEM_H
 
+#include <QColor>
 #include <QGraphicsItem>
+#include <QHash>
+#include <QVector>
 
 namespace Tiled {
 
+class MapObject;
 class ObjectGroup;
 
 namespace Internal {
 
+class MapDocument;
+
 /**
- * A graphics item representing an object group in a QGraphicsView. It only
- * serves to group together the objects belonging to the same object group.
+ * A graphics item representing an object group in a QGraphicsView.
+ *
+ * Normally it only serves to group together the items of the objects
+ * belonging to the same object group. When constructed with a map document,
+ * it instead draws all its objects itself, in one batch. The spatial index of
+ * the object group is used to only consider the exposed objects while
+ * painting. Individual MapObjectItem instances are only created on demand by
+ * the MapScene, for objects that are being interacted with. Those items don't
+ * paint anything, so that the objects stay in their place in the batch.
  *
  * @see MapObjectItem
  */
 class ObjectGroupItem : public QGraphicsItem
 {
 public:
-    ObjectGroupItem(ObjectGroup *objectGroup);
+    ObjectGroupItem(ObjectGroup *objectGroup,
+                    MapDocument *mapDocument = nullptr);
 
     ObjectGroup *objectGroup() const;
 
+    /**
+     * Returns whether this item draws the objects of its group itself.
+     */
+    bool isBatched() const { return mMapDocument != nullptr; }
+
+    void objectsInserted(int first, int last);
+    void objectRemoved(MapObject *object);
+    void objectsIndexChanged();
+    void syncWithMapObject(MapObject *object);
+    void syncWithMapObjects();
+
+    QVector<MapObject*> objectsIntersecting(const QRectF &rect) const;
+    int objectIndex(const MapObject *object) const;
+
     // QGraphicsItem
     QRectF boundingRect() const override;
     void paint(QPainter *painter,
@@ -49,7 +77,23 @@ public:
                QWidget *widget = nullptr) override;
 
 private:
+    struct Entry
+    {
+        QRectF bounds;
+        QPointF pixelPos;
+        QColor color;
+    };
+
+    Entry createEntry(MapObject *object) const;
+
     ObjectGroup *mObjectGroup;
+    MapDocument *mMapDocument;
+
+    QRectF mBoundingRect;
+    QHash<MapObject*, Entry> mEntries;
+
+    mutable QHash<const MapObject*, int> mObjectIndexes;
+    mutable bool mObjectIndexesDirty;
 };
 
 inline ObjectGroup *ObjectGroupItem::objectGroup() const
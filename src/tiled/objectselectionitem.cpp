@@ -29,7 +29,9 @@
 #include "preferences.h"
 #include "tile.h"
 
+#include <QGraphicsView>
 #include <QGuiApplication>
+#include <QStaticText>
 
 namespace Tiled {
 namespace Internal {
@@ -37,6 +39,13 @@ namespace Internal {
 static const qreal labelMargin = 3;
 static const qreal labelDistance = 12;
 
+/**
+ * Labels of unselected objects are not painted when their object is smaller
+ * than this many pixels at the current zoom level, since at that point they
+ * only clutter the view.
+ */
+static const qreal minimumObjectPixelSize = 8;
+
 // TODO: Unduplicate the following helper functions between this and
 // ObjectSelectionTool
 
@@ -194,14 +203,26 @@ public:
         : QGraphicsItem(parent)
         , mObject(object)
         , mColor(MapObjectItem::objectColor(mObject))
+        , mObjectExtent(0)
+        , mHideWhenZoomedOut(true)
     {
         setFlags(QGraphicsItem::ItemIgnoresTransformations |
                  QGraphicsItem::ItemIgnoresParentOpacity);
+
+        mStaticText.setTextFormat(Qt::PlainText);
     }
 
     void syncWithMapObject(MapRenderer *renderer);
     void updateColor();
 
+    void setHideWhenZoomedOut(bool hide)
+    {
+        if (mHideWhenZoomedOut != hide) {
+            mHideWhenZoomedOut = hide;
+            update();
+        }
+    }
+
     QRectF boundingRect() const override;
     void paint(QPainter *painter,
                const QStyleOptionGraphicsItem *,
@@ -211,6 +232,11 @@ private:
     QRectF mBoundingRect;
     MapObject *mObject;
     QColor mColor;
+    QFont mFont;                // The font the text was laid out with
+    QStaticText mStaticText;
+    QPointF mTextPos;
+    qreal mObjectExtent;        // Largest dimension of the object bounds
+    bool mHideWhenZoomedOut;
 };
 
 void MapObjectLabel::syncWithMapObject(MapRenderer *renderer)
@@ -221,10 +247,24 @@ void MapObjectLabel::syncWithMapObject(MapRenderer *renderer)
     if (!nameVisible)
         return;
 
-    const QFontMetricsF metrics(QGuiApplication::font());
-    QRectF boundingRect = metrics.boundingRect(mObject->name());
-    boundingRect.translate(-boundingRect.width() / 2, -labelDistance);
-    boundingRect.adjust(-labelMargin*2, -labelMargin, labelMargin*2, labelMargin);
+    QRectF boundingRect = mBoundingRect;
+
+    // Only lay out the text again when the name or the font changed
+    const QFont font = QGuiApplication::font();
+    if (mStaticText.text() != mObject->name() || mFont != font) {
+        const QFontMetricsF metrics(font);
+
+        mFont = font;
+        mStaticText.setText(mObject->name());
+        mStaticText.prepare(QTransform(), font);
+
+        boundingRect = metrics.boundingRect(mObject->name());
+        mTextPos = QPointF(-boundingRect.width() / 2,
+                           -labelDistance - metrics.ascent());
+
+        boundingRect.translate(-boundingRect.width() / 2, -labelDistance);
+        boundingRect.adjust(-labelMargin*2, -labelMargin, labelMargin*2, labelMargin);
+    }
 
     QPointF pixelPos = renderer->pixelToScreenCoords(mObject->position());
     QRectF bounds = objectBounds(mObject, renderer);
@@ -236,6 +276,8 @@ void MapObjectLabel::syncWithMapObject(MapRenderer *renderer)
     transform.translate(-pixelPos.x(), -pixelPos.y());
     bounds = transform.mapRect(bounds);
 
+    mObjectExtent = qMax(bounds.width(), bounds.height());
+
     // Center the object name on the object bounding box
     QPointF pos((bounds.left() + bounds.right()) / 2, bounds.top());
 
@@ -263,10 +305,23 @@ QRectF MapObjectLabel::boundingRect() const
     return mBoundingRect.adjusted(0, 0, 1, 1);
 }
 
+static qreal viewScale(const QWidget *widget)
+{
+    if (widget)
+        if (auto view = qobject_cast<const QGraphicsView*>(widget->parentWidget()))
+            return view->transform().m11();
+    return 1;
+}
+
 void MapObjectLabel::paint(QPainter *painter,
                            const QStyleOptionGraphicsItem *,
-                           QWidget *)
+                           QWidget *widget)
 {
+    // Objects without size, like points, keep their label
+    if (mHideWhenZoomedOut && mObjectExtent > 0 &&
+            mObjectExtent * viewScale(widget) < minimumObjectPixelSize)
+        return;
+
     painter->setRenderHint(QPainter::Antialiasing);
     painter->setBrush(Qt::black);
     painter->setPen(Qt::NoPen);
@@ -274,13 +329,12 @@ void MapObjectLabel::paint(QPainter *painter,
     painter->setBrush(mColor);
     painter->drawRoundedRect(mBoundingRect, 4, 4);
 
-    QPointF textPos(-(mBoundingRect.width() - labelMargin*4) / 2, -labelDistance);
-
     painter->drawRoundedRect(mBoundingRect, 4, 4);
+    painter->setFont(mFont);
     painter->setPen(Qt::black);
-    painter->drawText(textPos + QPointF(1,1), mObject->name());
+    painter->drawStaticText(mTextPos + QPointF(1,1), mStaticText);
     painter->setPen(Qt::white);
-    painter->drawText(textPos, mObject->name());
+    painter->drawStaticText(mTextPos, mStaticText);
 }
 
 
@@ -325,6 +379,14 @@ ObjectSelectionItem::ObjectSelectionItem(MapDocument *mapDocument)
         addRemoveObjectLabels();
 }
 
+void ObjectSelectionItem::applicationFontChanged()
+{
+    // Lays out the cached label texts again with the new font
+    MapRenderer *renderer = mMapDocument->renderer();
+    for (MapObjectLabel *label : mObjectLabels)
+        label->syncWithMapObject(renderer);
+}
+
 void ObjectSelectionItem::selectedObjectsChanged()
 {
     addRemoveObjectLabels();
@@ -469,6 +531,13 @@ void ObjectSelectionItem::addRemoveObjectLabels()
 
     qDeleteAll(mObjectLabels); // delete remaining items
     mObjectLabels.swap(labelItems);
+
+    // Labels of selected objects stay visible at any zoom level
+    for (MapObjectLabel *labelItem : mObjectLabels)
+        labelItem->setHideWhenZoomedOut(true);
+    for (MapObject *object : mMapDocument->selectedObjects())
+        if (MapObjectLabel *labelItem = mObjectLabels.value(object))
+            labelItem->setHideWhenZoomedOut(false);
 }
 
 void ObjectSelectionItem::addRemoveObjectOutlines()
@@ -45,6 +45,11 @@ public:
     QRectF boundingRect() const override { return QRectF(); }
     void paint(QPainter *, const QStyleOptionGraphicsItem *, QWidget *) override {}
 
+    /**
+     * Called by the MapScene when the application font changed, since the
+     * object labels are painted with it.
+     */
+    void applicationFontChanged();
 
 private slots:
     void selectedObjectsChanged();
@@ -924,14 +924,12 @@ void ObjectSelectionTool::updateSelection(const QPointF &pos,
     rect.setWidth(qMax(qreal(1), rect.width()));
     rect.setHeight(qMax(qreal(1), rect.height()));
 
-    QSet<MapObjectItem*> selectedItems;
+    QPainterPath path;
+    path.addRect(rect);
 
-    const QList<QGraphicsItem *> &items = mapScene()->items(rect);
-    for (QGraphicsItem *item : items) {
-        MapObjectItem *mapObjectItem = dynamic_cast<MapObjectItem*>(item);
-        if (mapObjectItem)
-            selectedItems.insert(mapObjectItem);
-    }
+    QSet<MapObjectItem*> selectedItems;
+    for (MapObjectItem *item : mapScene()->objectItemsIntersecting(path))
+        selectedItems.insert(item);
 
     if (modifiers & (Qt::ControlModifier | Qt::ShiftModifier))
         selectedItems |= mapScene()->selectedObjectItems();
@@ -988,7 +986,8 @@ void ObjectSelectionTool::updateMovingItems(const QPointF &pos,
         mapObject->setPosition(newPos);
     }
 
-    mapDocument()->mapObjectModel()->emitObjectsChanged(changingObjects());
+    mapDocument()->scheduleObjectsChanged(changingObjects(),
+                                          MapObject::PositionProperty);
 
     mOriginIndicator->setPos(mOldOriginPosition + diff);
 }
@@ -1077,7 +1076,9 @@ void ObjectSelectionTool::updateRotatingItems(const QPointF &pos,
         mapObject->setRotation(newRotation);
     }
 
-    mapDocument()->mapObjectModel()->emitObjectsChanged(changingObjects());
+    mapDocument()->scheduleObjectsChanged(changingObjects(),
+                                          MapObject::PositionProperty |
+                                          MapObject::RotationProperty);
 }
 
 void ObjectSelectionTool::finishRotating(const QPointF &pos)
@@ -1203,7 +1204,10 @@ void ObjectSelectionTool::updateResizingItems(const QPointF &pos,
         mapObject->setPosition(newPos);
     }
 
-    mapDocument()->mapObjectModel()->emitObjectsChanged(changingObjects());
+    mapDocument()->scheduleObjectsChanged(changingObjects(),
+                                          MapObject::PositionProperty |
+                                          MapObject::SizeProperty |
+                                          MapObject::ShapeProperty);
 }
 
 void ObjectSelectionTool::updateResizingSingleItem(const QPointF &resizingOrigin,
@@ -1343,7 +1347,10 @@ void ObjectSelectionTool::updateResizingSingleItem(const QPointF &resizingOrigin
     mapObject->setSize(newSize);
     mapObject->setPosition(newPos);
 
-    mapDocument()->mapObjectModel()->emitObjectsChanged(changingObjects());
+    mapDocument()->scheduleObjectsChanged(changingObjects(),
+                                          MapObject::PositionProperty |
+                                          MapObject::SizeProperty |
+                                          MapObject::ShapeProperty);
 }
 
 void ObjectSelectionTool::finishResizing(const QPointF &pos)
@@ -20,7 +20,6 @@
 
 #include "painttilelayer.h"
 
-#include "map.h"
 #include "mapdocument.h"
 #include "tilelayer.h"
 #include "tilepainter.h"
@@ -36,19 +35,10 @@ PaintTileLayer::PaintTileLayer(MapDocument *mapDocument,
                                int y,
                                const TileLayer *source,
                                QUndoCommand *parent)
-    : QUndoCommand(parent)
-    , mMapDocument(mapDocument)
-    , mTarget(target)
-    , mSource(static_cast<TileLayer*>(source->clone()))
-    , mX(x)
-    , mY(y)
-    , mPaintedRegion(source->region().translated(QPoint(x, y) - source->position()))
-    , mMergeable(false)
+    : PaintTileLayer(mapDocument, target, x, y, source,
+                     source->region().translated(QPoint(x, y) - source->position()),
+                     parent)
 {
-    mErased = mTarget->copy(mX - mTarget->x(),
-                            mY - mTarget->y(),
-                            mSource->width(), mSource->height());
-    setText(QCoreApplication::translate("Undo Commands", "Paint"));
 }
 
 PaintTileLayer::PaintTileLayer(MapDocument *mapDocument,
@@ -61,28 +51,44 @@ PaintTileLayer::PaintTileLayer(MapDocument *mapDocument,
     : QUndoCommand(parent)
     , mMapDocument(mapDocument)
     , mTarget(target)
-    , mSource(static_cast<TileLayer*>(source->clone()))
-    , mX(x)
-    , mY(y)
-    , mPaintedRegion(paintRegion)
+    , mMemoryUsage(0)
     , mMergeable(false)
+    , mDiscarded(false)
 {
-    mErased = mTarget->copy(mX - mTarget->x(),
-                            mY - mTarget->y(),
-                            mSource->width(), mSource->height());
+    mMapDocument->addPaintCommand(this);
+
+    TilePainter painter(mMapDocument, mTarget);
+    mDelta.record(mTarget, source, x, y, painter.paintableRegion(paintRegion));
+    updateMemoryUsage();
+
     setText(QCoreApplication::translate("Undo Commands", "Paint"));
 }
 
 PaintTileLayer::~PaintTileLayer()
 {
-    delete mSource;
-    delete mErased;
+    mMapDocument->removePaintCommand(this);
+    mMapDocument->adjustUndoMemoryUsage(-mMemoryUsage);
+}
+
+void PaintTileLayer::compact()
+{
+    mDelta.compact();
+    updateMemoryUsage();
+}
+
+void PaintTileLayer::discard()
+{
+    mDelta = TileLayerDelta();
+    mDiscarded = true;
+    updateMemoryUsage();
+
+    setText(QCoreApplication::translate("Undo Commands", "Paint (discarded)"));
 }
 
 void PaintTileLayer::undo()
 {
     TilePainter painter(mMapDocument, mTarget);
-    painter.setCells(mX, mY, mErased, mPaintedRegion);
+    painter.setCells(mDelta, TileLayerDelta::OldCells);
 
     QUndoCommand::undo(); // undo child commands
 }
@@ -92,7 +98,7 @@ void PaintTileLayer::redo()
     QUndoCommand::redo(); // redo child commands
 
     TilePainter painter(mMapDocument, mTarget);
-    painter.setCells(mX, mY, mSource, mPaintedRegion);
+    painter.setCells(mDelta, TileLayerDelta::NewCells);
 }
 
 bool PaintTileLayer::mergeWith(const QUndoCommand *other)
@@ -100,36 +106,19 @@ bool PaintTileLayer::mergeWith(const QUndoCommand *other)
     const PaintTileLayer *o = static_cast<const PaintTileLayer*>(other);
     if (!(mMapDocument == o->mMapDocument &&
           mTarget == o->mTarget &&
-          o->mMergeable))
+          o->mMergeable &&
+          !mDiscarded))
         return false;
 
-    const QRegion newRegion = o->mPaintedRegion.subtracted(mPaintedRegion);
-    const QRegion combinedRegion = mPaintedRegion.united(o->mPaintedRegion);
-    const QRect bounds = QRect(mX, mY, mSource->width(), mSource->height());
-    const QRect combinedBounds = combinedRegion.boundingRect();
-
-    // Resize the erased tiles and source layers when necessary
-    if (bounds != combinedBounds) {
-        const QPoint shift = bounds.topLeft() - combinedBounds.topLeft();
-        mErased->resize(combinedBounds.size(), shift);
-        mSource->resize(combinedBounds.size(), shift);
-    }
-
-    mX = combinedBounds.left();
-    mY = combinedBounds.top();
-    mPaintedRegion = combinedRegion;
-
-    // Copy the painted tiles from the other command over
-    const QPoint pos = QPoint(o->mX, o->mY) - combinedBounds.topLeft();
-    mSource->merge(pos, o->mSource);
-
-    // Copy the newly erased tiles from the other command over
-    foreach (const QRect &rect, newRegion.rects())
-        for (int y = rect.top(); y <= rect.bottom(); ++y)
-            for (int x = rect.left(); x <= rect.right(); ++x)
-                mErased->setCell(x - mX,
-                                 y - mY,
-                                 o->mErased->cellAt(x - o->mX, y - o->mY));
+    mDelta.merge(o->mDelta);
+    updateMemoryUsage();
 
     return true;
 }
+
+void PaintTileLayer::updateMemoryUsage()
+{
+    const qint64 memoryUsage = mDelta.memoryUsage();
+    mMapDocument->adjustUndoMemoryUsage(memoryUsage - mMemoryUsage);
+    mMemoryUsage = memoryUsage;
+}
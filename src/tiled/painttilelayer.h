@@ -21,6 +21,7 @@
 #ifndef PAINTTILELAYER_H
 #define PAINTTILELAYER_H
 
+#include "tilelayerdelta.h"
 #include "undocommands.h"
 
 #include <QRegion>
@@ -36,6 +37,9 @@ class MapDocument;
 
 /**
  * A command that paints one tile layer on top of another tile layer.
+ *
+ * Only the cells that are actually changed are stored, which keeps the
+ * memory use of long merged brush strokes low.
  */
 class PaintTileLayer : public QUndoCommand
 {
@@ -79,6 +83,18 @@ public:
      */
     void setMergeable(bool mergeable);
 
+    /**
+     * Compresses the cells stored by this command, to reduce its memory use.
+     */
+    void compact();
+
+    /**
+     * Discards the cells stored by this command, after which undoing or
+     * redoing it no longer changes the map. Used when the undo history grows
+     * beyond its memory budget.
+     */
+    void discard();
+
     void undo() override;
     void redo() override;
 
@@ -86,13 +102,14 @@ public:
     bool mergeWith(const QUndoCommand *other) override;
 
 private:
+    void updateMemoryUsage();
+
     MapDocument *mMapDocument;
     TileLayer *mTarget;
-    TileLayer *mSource;
-    TileLayer *mErased;
-    int mX, mY;
-    QRegion mPaintedRegion;
+    TileLayerDelta mDelta;
+    qint64 mMemoryUsage;
     bool mMergeable;
+    bool mDiscarded;
 };
 
 inline void PaintTileLayer::setMergeable(bool mergeable)
@@ -24,6 +24,7 @@
 #include "documentmanager.h"
 #include "languagemanager.h"
 #include "mapdocument.h"
+#include "mapobject.h"
 #include "pluginmanager.h"
 #include "tilesetmanager.h"
 
@@ -37,6 +38,29 @@ using namespace Tiled::Internal;
 
 Preferences *Preferences::mInstance;
 
+/**
+ * Makes the default properties of the object types available to
+ * MapObject::resolvedProperty() and related functions. When several types
+ * share a name, their properties are combined, with the first type defining
+ * a property providing its value.
+ */
+static void updateTypeDefaultProperties(const ObjectTypes &objectTypes)
+{
+    QHash<QString, Properties> defaults;
+    for (const ObjectType &type : objectTypes) {
+        Properties &properties = defaults[type.name];
+
+        QMapIterator<QString,QVariant> it(type.defaultProperties);
+        while (it.hasNext()) {
+            it.next();
+            if (!properties.contains(it.key()))
+                properties.insert(it.key(), it.value());
+        }
+    }
+
+    MapObject::setTypeDefaultProperties(defaults);
+}
+
 Preferences *Preferences::instance()
 {
     if (!mInstance)
@@ -60,7 +84,10 @@ Preferences::Preferences()
     mMapRenderOrder = static_cast<Map::RenderOrder>
             (intValue("MapRenderOrder", Map::RightDown));
     mDtdEnabled = boolValue("DtdEnabled");
+    mUpgradeXmlLayerData = boolValue("UpgradeXmlLayerData");
+    mJsonTileRowsOnSeparateLines = boolValue("JsonTileRowsOnSeparateLines");
     mReloadTilesetsOnChange = boolValue("ReloadTilesets", true);
+    mUndoMemoryBudget = intValue("UndoMemoryBudget", 0);
     mStampsDirectory = stringValue("StampsDirectory");
     mObjectTypesFile = stringValue("ObjectTypesFile");
     mSettings->endGroup();
@@ -113,6 +140,7 @@ Preferences::Preferences()
         mSettings->remove(QLatin1String("ObjectTypes"));
     }
 
+    updateTypeDefaultProperties(mObjectTypes);
 
     mSettings->beginGroup(QLatin1String("Automapping"));
     mAutoMapDrawing = boolValue("WhileDrawing");
@@ -357,6 +385,36 @@ void Preferences::setDtdEnabled(bool enabled)
     mSettings->setValue(QLatin1String("Storage/DtdEnabled"), enabled);
 }
 
+/**
+ * Returns whether maps using the slow XML layer data format should be
+ * switched to CSV when they are saved.
+ */
+bool Preferences::upgradeXmlLayerData() const
+{
+    return mUpgradeXmlLayerData;
+}
+
+void Preferences::setUpgradeXmlLayerData(bool enabled)
+{
+    mUpgradeXmlLayerData = enabled;
+    mSettings->setValue(QLatin1String("Storage/UpgradeXmlLayerData"), enabled);
+}
+
+/**
+ * Returns whether the JSON map format writes the tiles of each row of a tile
+ * layer on their own line. The JSON plugin reads this setting directly.
+ */
+bool Preferences::jsonTileRowsOnSeparateLines() const
+{
+    return mJsonTileRowsOnSeparateLines;
+}
+
+void Preferences::setJsonTileRowsOnSeparateLines(bool enabled)
+{
+    mJsonTileRowsOnSeparateLines = enabled;
+    mSettings->setValue(QLatin1String("Storage/JsonTileRowsOnSeparateLines"), enabled);
+}
+
 QString Preferences::language() const
 {
     return mLanguage;
@@ -392,6 +450,17 @@ void Preferences::setReloadTilesetsOnChanged(bool value)
     tilesetManager->setReloadTilesetsOnChange(mReloadTilesetsOnChange);
 }
 
+void Preferences::setUndoMemoryBudget(int megabytes)
+{
+    if (mUndoMemoryBudget == megabytes)
+        return;
+
+    mUndoMemoryBudget = megabytes;
+    mSettings->setValue(QLatin1String("Storage/UndoMemoryBudget"),
+                        mUndoMemoryBudget);
+    emit undoMemoryBudgetChanged(mUndoMemoryBudget);
+}
+
 void Preferences::setUseOpenGL(bool useOpenGL)
 {
     if (mUseOpenGL == useOpenGL)
@@ -406,6 +475,7 @@ void Preferences::setUseOpenGL(bool useOpenGL)
 void Preferences::setObjectTypes(const ObjectTypes &objectTypes)
 {
     mObjectTypes = objectTypes;
+    updateTypeDefaultProperties(mObjectTypes);
     emit objectTypesChanged();
 }
 
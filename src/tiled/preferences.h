@@ -92,12 +92,26 @@ public:
     bool dtdEnabled() const;
     void setDtdEnabled(bool enabled);
 
+    bool upgradeXmlLayerData() const;
+    void setUpgradeXmlLayerData(bool enabled);
+
+    bool jsonTileRowsOnSeparateLines() const;
+    void setJsonTileRowsOnSeparateLines(bool enabled);
+
     QString language() const;
     void setLanguage(const QString &language);
 
     bool reloadTilesetsOnChange() const;
     void setReloadTilesetsOnChanged(bool value);
 
+    /**
+     * The amount of memory in megabytes the undo history of a map may use
+     * before the tile data of its oldest changes gets compressed, and then
+     * discarded. 0 means there is no limit.
+     */
+    int undoMemoryBudget() const { return mUndoMemoryBudget; }
+    void setUndoMemoryBudget(int megabytes);
+
     bool useOpenGL() const { return mUseOpenGL; }
     void setUseOpenGL(bool useOpenGL);
 
@@ -177,6 +191,7 @@ signals:
     void selectionColorChanged(const QColor &selectionColor);
 
     void useOpenGLChanged(bool useOpenGL);
+    void undoMemoryBudgetChanged(int megabytes);
 
     void objectTypesChanged();
 
@@ -218,8 +233,11 @@ private:
     Map::LayerDataFormat mLayerDataFormat;
     Map::RenderOrder mMapRenderOrder;
     bool mDtdEnabled;
+    bool mUpgradeXmlLayerData;
+    bool mJsonTileRowsOnSeparateLines;
     QString mLanguage;
     bool mReloadTilesetsOnChange;
+    int mUndoMemoryBudget;
     bool mUseOpenGL;
     ObjectTypes mObjectTypes;
 
@@ -81,10 +81,16 @@ PreferencesDialog::PreferencesDialog(QWidget *parent)
 
     connect(mUi->enableDtd, &QCheckBox::toggled,
             preferences, &Preferences::setDtdEnabled);
+    connect(mUi->upgradeXmlLayerData, &QCheckBox::toggled,
+            preferences, &Preferences::setUpgradeXmlLayerData);
+    connect(mUi->jsonTileRowsOnSeparateLines, &QCheckBox::toggled,
+            preferences, &Preferences::setJsonTileRowsOnSeparateLines);
     connect(mUi->reloadTilesetImages, &QCheckBox::toggled,
             preferences, &Preferences::setReloadTilesetsOnChanged);
     connect(mUi->openLastFiles, &QCheckBox::toggled,
             preferences, &Preferences::setOpenLastFilesOnStartup);
+    connect(mUi->undoMemoryBudget, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+            preferences, &Preferences::setUndoMemoryBudget);
 
     connect(mUi->languageCombo, SIGNAL(currentIndexChanged(int)),
             SLOT(languageSelected(int)));
@@ -145,7 +151,10 @@ void PreferencesDialog::fromPreferences()
 
     mUi->reloadTilesetImages->setChecked(prefs->reloadTilesetsOnChange());
     mUi->enableDtd->setChecked(prefs->dtdEnabled());
+    mUi->upgradeXmlLayerData->setChecked(prefs->upgradeXmlLayerData());
+    mUi->jsonTileRowsOnSeparateLines->setChecked(prefs->jsonTileRowsOnSeparateLines());
     mUi->openLastFiles->setChecked(prefs->openLastFilesOnStartup());
+    mUi->undoMemoryBudget->setValue(prefs->undoMemoryBudget());
     if (mUi->openGL->isEnabled())
         mUi->openGL->setChecked(prefs->useOpenGL());
 
@@ -25,7 +25,6 @@
 #include "documentmanager.h"
 #include "mapdocument.h"
 #include "mapobject.h"
-#include "preferences.h"
 #include "propertybrowser.h"
 #include "terrain.h"
 #include "tile.h"
@@ -153,14 +152,8 @@ static bool isAddedByType(Object *object, const QString &name)
     if (!object || object->typeId() != Object::MapObjectType)
         return false;
 
-    const QString objectType = static_cast<MapObject*>(object)->type();
-    const ObjectTypes objectTypes = Preferences::instance()->objectTypes();
-    for (const ObjectType &type : objectTypes) {
-        if (type.name == objectType)
-            return type.defaultProperties.contains(name);
-    }
-
-    return false;
+    const QString &objectType = static_cast<MapObject*>(object)->type();
+    return MapObject::typeDefaultProperties(objectType).contains(name);
 }
 
 void PropertiesDock::currentObjectChanged(Object *object)
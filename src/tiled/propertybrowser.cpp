@@ -58,10 +58,27 @@
 #include <QCoreApplication>
 #include <QDebug>
 #include <QMessageBox>
+#include <QtConcurrentRun>
+
+#include <algorithm>
 
 namespace Tiled {
 namespace Internal {
 
+/**
+ * Selections with at least this many objects have their custom properties
+ * aggregated on a worker thread, to keep the UI responsive.
+ */
+static const int AsyncAggregationThreshold = 500;
+
+static AggregatedProperties aggregateProperties(const QVector<PropertyList> &propertyLists)
+{
+    AggregatedProperties aggregated;
+    for (const PropertyList &properties : propertyLists)
+        aggregated.aggregate(properties);
+    return aggregated;
+}
+
 PropertyBrowser::PropertyBrowser(QWidget *parent)
     : QtTreePropertyBrowser(parent)
     , mUpdating(false)
@@ -70,6 +87,10 @@ PropertyBrowser::PropertyBrowser(QWidget *parent)
     , mVariantManager(new VariantPropertyManager(this))
     , mGroupManager(new QtGroupPropertyManager(this))
     , mCustomPropertiesGroup(nullptr)
+    , mAggregationWatcher(new QFutureWatcher<AggregatedProperties>(this))
+    , mAggregationPending(false)
+    , mCustomPropertiesPopulated(false)
+    , mCustomPropertyUpdatePending(false)
 {
     VariantEditorFactory *variantEditorFactory = new VariantEditorFactory(this);
 
@@ -111,6 +132,11 @@ PropertyBrowser::PropertyBrowser(QWidget *parent)
 
     connect(variantEditorFactory, &VariantEditorFactory::resetProperty,
             this, &PropertyBrowser::resetProperty);
+
+    connect(mAggregationWatcher, &QFutureWatcher<AggregatedProperties>::finished,
+            this, &PropertyBrowser::aggregationFinished);
+    connect(this, &QtTreePropertyBrowser::expanded,
+            this, &PropertyBrowser::customPropertiesGroupExpanded);
 }
 
 void PropertyBrowser::setObject(Object *object)
@@ -194,6 +220,19 @@ bool PropertyBrowser::isCustomPropertyItem(QtBrowserItem *item) const
 
 void PropertyBrowser::editCustomProperty(const QString &name)
 {
+    // The property may have just been added, make sure it is displayed
+    if (mAggregationPending) {
+        mAggregationWatcher->waitForFinished();
+        aggregationFinished();
+    }
+    flushCustomPropertyUpdates();
+
+    if (!mCustomPropertiesPopulated && mCustomPropertiesGroup) {
+        setExpanded(items(mCustomPropertiesGroup).first(), true);
+        if (!mCustomPropertiesPopulated)
+            populateCustomProperties();
+    }
+
     QtVariantProperty *property = mNameToProperty.value(name);
     if (!property)
         return;
@@ -279,83 +318,36 @@ void PropertyBrowser::terrainChanged(Tileset *tileset, int index)
 
 void PropertyBrowser::propertyAdded(Object *object, const QString &name)
 {
-    if (!mMapDocument->currentObjects().contains(object))
-        return;
-    if (mNameToProperty.keys().contains(name)) {
-        if (mObject == object) {
-            mUpdating = true;
-            mNameToProperty[name]->setValue(mObject->property(name));
-            mUpdating = false;
-        }
-    } else {
-        // Determine the property preceding the new property, if any
-        const int index = mObject->properties().keys().indexOf(name);
-        const QList<QtProperty *> properties = mCustomPropertiesGroup->subProperties();
-        QtProperty *precedingProperty = (index > 0) ? properties.at(index - 1) : nullptr;
-
-        mUpdating = true;
-        QVariant value = object->property(name);
-        QtVariantProperty *property = createProperty(CustomProperty, value.userType(), name);
-        property->setValue(value);
-        mCustomPropertiesGroup->insertSubProperty(property, precedingProperty);
-
-        // Collapse custom color properties, to save space
-        if (value.type() == QVariant::Color)
-            setExpanded(items(property).first(), false);
-
-        mUpdating = false;
-    }
-    updatePropertyColor(name);
+    if (object == mObject || mCurrentObjects.contains(object))
+        scheduleCustomPropertyUpdate(name);
 }
 
 void PropertyBrowser::propertyRemoved(Object *object, const QString &name)
 {
-    if (!mMapDocument->currentObjects().contains(object))
-        return;
-    if (mObject == object) {
-        bool deleteProperty = true;
-        for (Object *obj : mMapDocument->currentObjects()) {
-            if (mObject == obj)
-                continue;
-            if (obj->properties().contains(name)) {
-                deleteProperty = false;
-                break;
-            }
-        }
-        if (deleteProperty) {
-            // No other selected objects have this property so delete it.
-            delete mNameToProperty.take(name);
-        } else {
-            // Another selected object still has this property, so just clear the value.
-            mUpdating = true;
-            mNameToProperty[name]->setValue(QString());
-            mUpdating = false;
-        }
-    }
-    updatePropertyColor(name);
+    if (object == mObject || mCurrentObjects.contains(object))
+        scheduleCustomPropertyUpdate(name);
 }
 
 void PropertyBrowser::propertyChanged(Object *object, const QString &name)
 {
-    if (mObject == object) {
-        QVariant previousValue = mNameToProperty[name]->value();
-        QVariant newValue = object->property(name);
-        if (newValue.userType() != previousValue.userType()) {
-            updateCustomProperties();
-        } else {
-            mUpdating = true;
-            mNameToProperty[name]->setValue(newValue);
-            mUpdating = false;
-        }
-    }
-    if (mMapDocument->currentObjects().contains(object))
-        updatePropertyColor(name);
+    if (object == mObject || mCurrentObjects.contains(object))
+        scheduleCustomPropertyUpdate(name);
 }
 
 void PropertyBrowser::propertiesChanged(Object *object)
 {
-    if (mMapDocument->currentObjects().contains(object))
-        updateCustomProperties();
+    if (object != mObject && !mCurrentObjects.contains(object))
+        return;
+
+    // Both the previous and the new names of the object need updating
+    for (auto it = mAggregatedProperties.constBegin(),
+         it_end = mAggregatedProperties.constEnd(); it != it_end; ++it) {
+        scheduleCustomPropertyUpdate(it.key());
+    }
+
+    const PropertyList &properties = object->propertyList();
+    for (int i = 0; i < properties.size(); ++i)
+        scheduleCustomPropertyUpdate(properties.nameAt(i));
 }
 
 void PropertyBrowser::selectedObjectsChanged()
@@ -1069,6 +1061,11 @@ void PropertyBrowser::removeProperties()
     mIdToProperty.clear();
     mNameToProperty.clear();
     mCustomPropertiesGroup = nullptr;
+    mCustomPropertiesPopulated = false;
+    mAggregationPending = false;
+    mAggregatedProperties = AggregatedProperties();
+    mCurrentObjects.clear();
+    mPendingPropertyNames.clear();
 }
 
 void PropertyBrowser::updateProperties()
@@ -1198,56 +1195,200 @@ void PropertyBrowser::updateCustomProperties()
     if (!mObject)
         return;
 
-    bool wasUpdating = mUpdating;
-    mUpdating = true;
+    const QList<Object*> objects = mMapDocument->currentObjects();
+
+    mCurrentObjects = objects.toSet();
+    mPendingPropertyNames.clear();
+
+    // Take shallow copies of the property lists, so that they can be safely
+    // aggregated while the objects are being modified
+    QVector<PropertyList> propertyLists;
+    propertyLists.reserve(objects.size());
+    for (Object *object : objects)
+        propertyLists.append(object->propertyList());
+
+    if (objects.size() < AsyncAggregationThreshold) {
+        mAggregationPending = false;
+        applyAggregatedProperties(aggregateProperties(propertyLists));
+    } else {
+        removeCustomProperties();
+        mAggregatedProperties = AggregatedProperties();
+        mAggregationPending = true;
+        mAggregationWatcher->setFuture(QtConcurrent::run(aggregateProperties,
+                                                         propertyLists));
+    }
+}
+
+void PropertyBrowser::aggregationFinished()
+{
+    // Results of outdated aggregations are ignored
+    if (!mAggregationPending)
+        return;
+
+    mAggregationPending = false;
+    applyAggregatedProperties(mAggregationWatcher->result());
+
+    // Apply any changes made while the aggregation was running
+    flushCustomPropertyUpdates();
+}
+
+void PropertyBrowser::applyAggregatedProperties(const AggregatedProperties &aggregated)
+{
+    mAggregatedProperties = aggregated;
+
+    removeCustomProperties();
+
+    // Rows are only created once the custom properties are visible
+    QtBrowserItem *groupItem = items(mCustomPropertiesGroup).first();
+    if (isExpanded(groupItem))
+        populateCustomProperties();
+}
+
+void PropertyBrowser::customPropertiesGroupExpanded(QtBrowserItem *item)
+{
+    if (mCustomPropertiesGroup && item->property() == mCustomPropertiesGroup)
+        if (!mCustomPropertiesPopulated && !mAggregationPending)
+            populateCustomProperties();
+}
+
+void PropertyBrowser::populateCustomProperties()
+{
+    mCustomPropertiesPopulated = true;
 
-    qDeleteAll(mNameToProperty);
+    QStringList names = mAggregatedProperties.keys();
+
+    // Add properties based on object type, if defined
+    if (mObject->typeId() == Object::MapObjectType) {
+        const QString &currentType = static_cast<MapObject*>(mObject)->type();
+        const PropertyList defaults = MapObject::typeDefaultProperties(currentType);
+        for (int i = 0; i < defaults.size(); ++i)
+            if (!mAggregatedProperties.contains(defaults.nameAt(i)))
+                names.append(defaults.nameAt(i));
+        std::sort(names.begin(), names.end());
+    }
+
+    for (const QString &name : names)
+        updateCustomProperty(name);
+}
+
+void PropertyBrowser::removeCustomProperties()
+{
+    for (QtVariantProperty *property : mNameToProperty) {
+        mPropertyToId.remove(property);
+        delete property;
+    }
     mNameToProperty.clear();
+    mCustomPropertiesPopulated = false;
+}
+
+/**
+ * Schedules the row of the custom property with the given \a name to be
+ * updated. Updates are collected, so that setting a property on many
+ * selected objects only updates its row once.
+ */
+void PropertyBrowser::scheduleCustomPropertyUpdate(const QString &name)
+{
+    mPendingPropertyNames.insert(name);
+
+    if (!mCustomPropertyUpdatePending) {
+        mCustomPropertyUpdatePending = true;
+        QMetaObject::invokeMethod(this, "flushCustomPropertyUpdates",
+                                  Qt::QueuedConnection);
+    }
+}
+
+void PropertyBrowser::flushCustomPropertyUpdates()
+{
+    mCustomPropertyUpdatePending = false;
+
+    // Pending names are handled once the aggregation has finished
+    if (!mObject || mAggregationPending || mPendingPropertyNames.isEmpty())
+        return;
+
+    QSet<QString> names;
+    names.swap(mPendingPropertyNames);
 
-    mCombinedProperties = mObject->properties();
-    // Add properties from selected objects which mObject does not contain to mCombinedProperties.
-    for (Object *obj : mMapDocument->currentObjects()) {
-        if (obj == mObject)
-            continue;
+    const QList<Object*> objects = mMapDocument->currentObjects();
 
-        QMapIterator<QString,QVariant> it(obj->properties());
+    for (const QString &name : names) {
+        AggregatedPropertyData data;
+
+        for (Object *object : objects) {
+            const PropertyList &properties = object->propertyList();
+            if (!properties.contains(name))
+                continue;
 
-        while (it.hasNext()) {
-            it.next();
-            if (!mCombinedProperties.contains(it.key()))
-                mCombinedProperties.insert(it.key(), QString());
+            if (data.presenceCount() == 0)
+                data = AggregatedPropertyData(properties.value(name));
+            else
+                data.aggregate(properties.value(name));
         }
+
+        if (data.presenceCount() > 0)
+            mAggregatedProperties.insert(name, data);
+        else
+            mAggregatedProperties.remove(name);
+
+        updateCustomProperty(name);
     }
+}
 
-    // Add properties based on object type, if defined
-    if (mObject->typeId() == Object::MapObjectType) {
-        const QString currentType = static_cast<MapObject*>(mObject)->type();
-        const ObjectTypes objectTypes = Preferences::instance()->objectTypes();
-        for (const ObjectType &type : objectTypes) {
-            if (type.name == currentType) {
-                QMapIterator<QString,QVariant> it(type.defaultProperties);
-                while (it.hasNext()) {
-                    it.next();
-                    if (!mCombinedProperties.contains(it.key()))
-                        mCombinedProperties.insert(it.key(), it.value());
-                }
-            }
+/**
+ * Creates, updates or removes the row displaying the custom property with
+ * the given \a name, based on the aggregated properties.
+ */
+void PropertyBrowser::updateCustomProperty(const QString &name)
+{
+    if (!mCustomPropertiesPopulated)
+        return;
+
+    QVariant value;
+    if (mObject->hasProperty(name))
+        value = mObject->property(name);
+    else if (mAggregatedProperties.contains(name))
+        value = QString();
+    else if (mObject->typeId() == Object::MapObjectType)
+        value = static_cast<MapObject*>(mObject)->resolvedProperty(name);
+
+    QtVariantProperty *property = mNameToProperty.value(name);
+
+    if (!value.isValid()) {
+        if (property) {
+            mNameToProperty.remove(name);
+            mPropertyToId.remove(property);
+            delete property;
         }
+        return;
     }
 
-    QMapIterator<QString,QVariant> it(mCombinedProperties);
+    bool wasUpdating = mUpdating;
+    mUpdating = true;
+
+    if (property && property->value().userType() != value.userType()) {
+        mNameToProperty.remove(name);
+        mPropertyToId.remove(property);
+        delete property;
+        property = nullptr;
+    }
 
-    while (it.hasNext()) {
-        it.next();
-        QtVariantProperty *property = addProperty(CustomProperty,
-                                                  it.value().userType(),
-                                                  it.key(),
-                                                  mCustomPropertiesGroup);
+    if (!property) {
+        // Determine the property preceding the new property, if any
+        QtProperty *precedingProperty = nullptr;
+        auto it = mNameToProperty.lowerBound(name);
+        if (it != mNameToProperty.begin())
+            precedingProperty = (--it).value();
+
+        property = createProperty(CustomProperty, value.userType(), name);
+        mCustomPropertiesGroup->insertSubProperty(property, precedingProperty);
 
-        property->setValue(it.value());
-        updatePropertyColor(it.key());
+        // Collapse custom color properties, to save space
+        if (value.type() == QVariant::Color)
+            setExpanded(items(property).first(), false);
     }
 
+    property->setValue(value);
+    updatePropertyColor(name);
+
     mUpdating = wasUpdating;
 }
 
@@ -1258,35 +1399,21 @@ void PropertyBrowser::updatePropertyColor(const QString &name)
     if (!property)
         return;
 
-    QString propertyName = property->propertyName();
-    QString propertyValue = property->valueText();
-
-    const auto &objects = mMapDocument->currentObjects();
-
     QColor textColor = palette().color(QPalette::Active, QPalette::WindowText);
     QColor disabledTextColor = palette().color(QPalette::Disabled, QPalette::WindowText);
 
+    const AggregatedPropertyData data = mAggregatedProperties.value(name);
+
     // If one of the objects doesn't have this property then gray out the name and value.
-    for (Object *obj : objects) {
-        if (!obj->hasProperty(propertyName)) {
-            property->setNameColor(disabledTextColor);
-            property->setValueColor(disabledTextColor);
-            return;
-        }
+    if (data.presenceCount() < mAggregatedProperties.aggregatedCount()) {
+        property->setNameColor(disabledTextColor);
+        property->setValueColor(disabledTextColor);
+        return;
     }
 
     // If one of the objects doesn't have the same property value then gray out the value.
-    for (Object *obj : objects) {
-        if (obj == mObject)
-            continue;
-        if (obj->property(propertyName) != propertyValue) {
-            property->setValueColor(disabledTextColor);
-            return;
-        }
-    }
-
     property->setNameColor(textColor);
-    property->setValueColor(textColor);
+    property->setValueColor(data.valueConsistent() ? textColor : disabledTextColor);
 }
 
 } // namespace Internal
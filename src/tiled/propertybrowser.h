@@ -21,7 +21,10 @@
 #ifndef PROPERTYBROWSER_H
 #define PROPERTYBROWSER_H
 
+#include <QFutureWatcher>
 #include <QHash>
+#include <QMap>
+#include <QSet>
 #include <QUndoCommand>
 
 #include <QtTreePropertyBrowser>
@@ -103,6 +106,10 @@ private slots:
 
     void objectTypesChanged();
 
+    void aggregationFinished();
+    void customPropertiesGroupExpanded(QtBrowserItem *item);
+    void flushCustomPropertyUpdates();
+
     void valueChanged(QtProperty *property, const QVariant &val);
 
     void resetProperty(QtProperty *property);
@@ -178,6 +185,11 @@ private:
     void removeProperties();
     void updateProperties();
     void updateCustomProperties();
+    void applyAggregatedProperties(const AggregatedProperties &aggregated);
+    void populateCustomProperties();
+    void removeCustomProperties();
+    void scheduleCustomPropertyUpdate(const QString &name);
+    void updateCustomProperty(const QString &name);
     void retranslateUi();
     bool mUpdating;
 
@@ -192,9 +204,20 @@ private:
 
     QHash<QtProperty *, PropertyId> mPropertyToId;
     QHash<PropertyId, QtVariantProperty *> mIdToProperty;
-    QHash<QString, QtVariantProperty *> mNameToProperty;
+    QMap<QString, QtVariantProperty *> mNameToProperty;
 
-    Properties mCombinedProperties;
+    /*
+     * The custom properties of the current objects are aggregated once when
+     * the selection changes (on a worker thread for large selections) and are
+     * then kept up to date one property name at a time.
+     */
+    QSet<Object*> mCurrentObjects;
+    AggregatedProperties mAggregatedProperties;
+    QFutureWatcher<AggregatedProperties> *mAggregationWatcher;
+    bool mAggregationPending;
+    bool mCustomPropertiesPopulated;
+    QSet<QString> mPendingPropertyNames;
+    bool mCustomPropertyUpdatePending;
 
     QStringList mStaggerAxisNames;
     QStringList mStaggerIndexNames;
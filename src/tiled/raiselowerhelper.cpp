@@ -224,16 +224,7 @@ bool RaiseLowerHelper::initContext()
 
     // The list of related items are all items from the same object group
     // that share space with the selected items.
-    QList<QGraphicsItem*> items = mMapScene->items(shape,
-                                                   Qt::IntersectsItemShape,
-                                                   Qt::AscendingOrder);
-
-    foreach (QGraphicsItem *item, items) {
-        if (MapObjectItem *mapObjectItem = dynamic_cast<MapObjectItem*>(item)) {
-            if (mapObjectItem->mapObject()->objectGroup() == mObjectGroup)
-                mRelatedObjects.append(mapObjectItem);
-        }
-    }
+    mRelatedObjects = mMapScene->objectItemsIntersecting(shape, mObjectGroup);
 
     foreach (MapObjectItem *item, selectedItems) {
         int index = mRelatedObjects.indexOf(item);
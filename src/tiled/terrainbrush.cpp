@@ -27,7 +27,7 @@
 #include "mapdocument.h"
 #include "mapscene.h"
 #include "painttilelayer.h"
-#include "randompicker.h"
+#include "regionbuilder.h"
 #include "tilelayer.h"
 #include "tileset.h"
 #include "tile.h"
@@ -232,7 +232,7 @@ void TerrainBrush::doPaint(bool mergeable)
     mapDocument()->emitRegionEdited(brushItem()->tileRegion(), tileLayer);
 }
 
-static Tile *findBestTile(const Tileset &tileset, unsigned terrain, unsigned considerationMask)
+static RandomPicker<Tile*> findBestTiles(const Tileset &tileset, unsigned terrain, unsigned considerationMask)
 {
     // we should have hooked 0xFFFFFFFF terrains outside this function
     Q_ASSERT(terrain != 0xFFFFFFFF);
@@ -240,11 +240,8 @@ static Tile *findBestTile(const Tileset &tileset, unsigned terrain, unsigned con
     RandomPicker<Tile*> matches;
     int penalty = INT_MAX;
 
-    // TODO: this is a slow linear search, perhaps we could use a better find algorithm...
-    for (Tile *t : tileset.tiles()) {
-        if ((t->terrain() & considerationMask) != (terrain & considerationMask))
-            continue;
-
+    // only the tiles that match on the considered corners need to be checked
+    for (Tile *t : tileset.tilesWithTerrain(terrain, considerationMask)) {
         // calculate the tile transition penalty based on shortest distance to target terrain type
         int tr = tileset.terrainTransitionPenalty(t->terrain() >> 24, terrain >> 24);
         int tl = tileset.terrainTransitionPenalty((t->terrain() >> 16) & 0xFF, (terrain >> 16) & 0xFF);
@@ -266,9 +263,22 @@ static Tile *findBestTile(const Tileset &tileset, unsigned terrain, unsigned con
         }
     }
 
+    return matches;
+}
+
+Tile *TerrainBrush::findBestTile(const Tileset &tileset, unsigned terrain, unsigned considerationMask)
+{
+    // The candidates only depend on the query, so they are remembered for
+    // the duration of a brush update
+    const CandidateKey key(&tileset, (quint64(terrain) << 32) | considerationMask);
+
+    auto it = mCandidates.find(key);
+    if (it == mCandidates.end())
+        it = mCandidates.insert(key, findBestTiles(tileset, terrain, considerationMask));
+
     // choose a candidate at random, with consideration for probability
-    if (!matches.isEmpty())
-        return matches.pick();
+    if (!it.value().isEmpty())
+        return it.value().pick();
 
     // TODO: conveniently, the null tile doesn't currently work, but when it does, we need to signal a failure to find any matches some other way
     return nullptr;
@@ -340,23 +350,27 @@ void TerrainBrush::updateBrush(QPoint cursorPos, const QVector<QPoint> *list)
         terrainId = mTerrain->id();
     }
 
-    // allocate a buffer to build the terrain tilemap (TODO: this could be retained per layer to save regular allocation)
-    Tile **newTerrain = new Tile*[numTiles];
+    // the scratch buffers are retained between updates and only reallocated
+    // when the layer size changes
+    if (mChecked.size() != numTiles) {
+        mNewTerrain.fill(nullptr, numTiles);
+        mChecked.fill(0, numTiles);
+    }
+
+    Tile **newTerrain = mNewTerrain.data();
+    quint8 *checked = mChecked.data();
 
-    // allocate a buffer of flags for each tile that may be considered (TODO: this could be retained per layer to save regular allocation)
-    char *checked = new char[numTiles];
-    memset(checked, 0, numTiles);
+    mCandidates.clear();
 
     // create a consideration list, and push the start points
-    QList<QPoint> transitionList;
+    QVector<QPoint> &transitionList = mTransitionList;
+    transitionList.clear();
     int initialTiles = 0;
 
     if (list) {
         // if we were supplied a list of start points
-        foreach (const QPoint &p, *list) {
-            transitionList.append(p);
-            ++initialTiles;
-        }
+        transitionList = *list;
+        initialTiles = list->size();
     } else {
         transitionList.append(cursorPos);
         initialTiles = 1;
@@ -365,9 +379,9 @@ void TerrainBrush::updateBrush(QPoint cursorPos, const QVector<QPoint> *list)
     QRect brushRect(cursorPos, cursorPos);
 
     // produce terrain with transitions using a simple, relative naive approach (considers each tile once, and doesn't allow re-consideration if selection was bad)
-    while (!transitionList.isEmpty()) {
+    for (int next = 0; next < transitionList.size(); ++next) {
         // get the next point in the consideration list
-        QPoint p = transitionList.takeFirst();
+        const QPoint p = transitionList.at(next);
         int x = p.x(), y = p.y();
         int i = y*layerWidth + x;
 
@@ -459,6 +473,7 @@ void TerrainBrush::updateBrush(QPoint cursorPos, const QVector<QPoint> *list)
         // add tile to the brush
         newTerrain[i] = paste;
         checked[i] = true;
+        mCheckedIndexes.append(i);
 
         // expand the brush rect to fit the edit set
         brushRect |= QRect(p, p);
@@ -487,7 +502,7 @@ void TerrainBrush::updateBrush(QPoint cursorPos, const QVector<QPoint> *list)
     }
 
     // create a stamp for the terrain block
-    QRegion brushRegion;
+    RegionBuilder brushRegion;
     SharedTileLayer stamp = SharedTileLayer(new TileLayer(QString(),
                                                           brushRect.left(),
                                                           brushRect.top(),
@@ -510,9 +525,7 @@ void TerrainBrush::updateBrush(QPoint cursorPos, const QVector<QPoint> *list)
             for (++x; x <= brushRect.right() + 1; ++x) {
                 i = y * layerWidth + x;
                 if (x == brushRect.right() + 1 || !checked[i]) {
-                    const int rangeEnd = x;
-                    brushRegion += QRect(rangeStart, y,
-                                         rangeEnd - rangeStart, 1);
+                    brushRegion.addSpan(rangeStart, x - 1, y);
                     break;
                 } else {
                     stamp->setCell(x - brushRect.left(),
@@ -524,8 +537,13 @@ void TerrainBrush::updateBrush(QPoint cursorPos, const QVector<QPoint> *list)
     }
 
     // set the new tile layer as the brush
-    brushItem()->setTileLayer(stamp, brushRegion);
+    brushItem()->setTileLayer(stamp, brushRegion.region());
 
-    delete[] checked;
-    delete[] newTerrain;
+    // reset only the parts of the scratch buffers that were used
+    for (int i : mCheckedIndexes) {
+        checked[i] = 0;
+        newTerrain[i] = nullptr;
+    }
+    mCheckedIndexes.clear();
+    mCandidates.clear();
 }
@@ -24,12 +24,18 @@
 #define TERRAINBRUSH_H
 
 #include "abstracttiletool.h"
+#include "randompicker.h"
 #include "tilelayer.h"
 
+#include <QHash>
+#include <QPair>
+#include <QVector>
+
 namespace Tiled {
 
 class Tile;
 class Terrain;
+class Tileset;
 
 namespace Internal {
 
@@ -107,6 +113,8 @@ private:
      */
     void updateBrush(QPoint cursorPos, const QVector<QPoint> *list = nullptr);
 
+    Tile *findBestTile(const Tileset &tileset, unsigned terrain, unsigned considerationMask);
+
     /**
      * The terrain we are currently painting.
      */
@@ -140,6 +148,23 @@ private:
      * When drawing circles this will be the midpoint.
      */
     int mLineReferenceX, mLineReferenceY;
+
+    /**
+     * Scratch buffers used by updateBrush(), retained to avoid allocating
+     * them on each mouse move. Only the entries listed in mCheckedIndexes
+     * are in use, so only those need to be reset after an update.
+     */
+    QVector<Tile*> mNewTerrain;
+    QVector<quint8> mChecked;
+    QVector<int> mCheckedIndexes;
+    QVector<QPoint> mTransitionList;
+
+    /**
+     * The best matching tiles for each (tileset, terrain and mask) query
+     * made during the current brush update.
+     */
+    typedef QPair<const Tileset*, quint64> CandidateKey;
+    QHash<CandidateKey, RandomPicker<Tile*>> mCandidates;
 };
 
 } // namespace Internal
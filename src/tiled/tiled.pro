@@ -13,7 +13,7 @@ win32 {
     DESTDIR = ../../bin
 }
 
-QT += widgets
+QT += widgets concurrent
 
 contains(QT_CONFIG, opengl):!macx: QT += opengl
 
@@ -82,6 +82,7 @@ SOURCES += aboutdialog.cpp \
     automappingmanager.cpp \
     automappingutils.cpp  \
     autoupdater.cpp \
+    batchexporter.cpp \
     brokenlinks.cpp \
     brushitem.cpp \
     bucketfilltool.cpp \
@@ -122,6 +123,7 @@ SOURCES += aboutdialog.cpp \
     eraser.cpp \
     erasetiles.cpp \
     exportasimagedialog.cpp \
+    exportcache.cpp \
     fileedit.cpp \
     filesystemwatcher.cpp \
     flexiblescrollbar.cpp \
@@ -194,6 +196,7 @@ SOURCES += aboutdialog.cpp \
     tilecollisioneditor.cpp \
     tiledapplication.cpp \
     tiledproxystyle.cpp \
+    tilelayerdelta.cpp \
     tilelayeritem.cpp \
     tilepainter.cpp \
     tileselectionitem.cpp \
@@ -234,6 +237,7 @@ HEADERS += aboutdialog.h \
     automappingmanager.h \
     automappingutils.h \
     autoupdater.h \
+    batchexporter.h \
     brokenlinks.h \
     brushitem.h \
     bucketfilltool.h \
@@ -275,6 +279,7 @@ HEADERS += aboutdialog.h \
     eraser.h \
     erasetiles.h \
     exportasimagedialog.h \
+    exportcache.h \
     fileedit.h \
     filesystemwatcher.h \
     flexiblescrollbar.h \
@@ -350,6 +355,7 @@ HEADERS += aboutdialog.h \
     tilecollisioneditor.h \
     tiledapplication.h \
     tiledproxystyle.h \
+    tilelayerdelta.h \
     tilelayeritem.h \
     tilepainter.h \
     tileselectionitem.h \
@@ -0,0 +1,195 @@
+/*
+ * tilelayerdelta.cpp
+ * Copyright 2026, agent <agent@local>
+ *
+ * This file is part of Tiled.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tilelayerdelta.h"
+
+#include "compression.h"
+
+#include <cstring>
+
+using namespace Tiled;
+using namespace Tiled::Internal;
+
+quint64 TileLayerDelta::chunkKey(int chunkX, int chunkY)
+{
+    return (quint64(quint32(chunkY)) << 32) | quint32(chunkX);
+}
+
+static inline int chunkX(quint64 key) { return qint32(quint32(key)); }
+static inline int chunkY(quint64 key) { return qint32(quint32(key >> 32)); }
+
+void TileLayerDelta::record(const TileLayer *target,
+                            const TileLayer *source, int x, int y,
+                            const QRegion &region)
+{
+    expand();
+
+    const QRegion changed = region
+            .intersected(target->bounds())
+            .intersected(QRect(x, y, source->width(), source->height()));
+
+    for (const QRect &rect : changed.rects()) {
+        for (int _y = rect.top(); _y <= rect.bottom(); ++_y) {
+            for (int _x = rect.left(); _x <= rect.right(); ++_x) {
+                // Arithmetic shift makes this round down for negative values
+                Chunk &chunk = mChunks[chunkKey(_x >> ChunkBits, _y >> ChunkBits)];
+                const int index = (_x & ChunkMask) + (_y & ChunkMask) * ChunkSize;
+                const quint64 bit = Q_UINT64_C(1) << index;
+
+                if (!(chunk.used & bit)) {
+                    chunk.oldCells[index] = target->cellAt(_x - target->x(),
+                                                           _y - target->y());
+                    chunk.used |= bit;
+                }
+
+                chunk.newCells[index] = source->cellAt(_x - x, _y - y);
+            }
+        }
+    }
+
+    mRegion |= changed;
+}
+
+void TileLayerDelta::merge(const TileLayerDelta &later)
+{
+    expand();
+
+    QHashIterator<quint64, Chunk> it(later.chunks());
+    while (it.hasNext()) {
+        it.next();
+
+        const Chunk &laterChunk = it.value();
+        Chunk &chunk = mChunks[it.key()];
+
+        for (int index = 0; index < ChunkSize * ChunkSize; ++index) {
+            const quint64 bit = Q_UINT64_C(1) << index;
+            if (!(laterChunk.used & bit))
+                continue;
+
+            // Keep the oldest value for cells that were already changed
+            if (!(chunk.used & bit))
+                chunk.oldCells[index] = laterChunk.oldCells[index];
+
+            chunk.newCells[index] = laterChunk.newCells[index];
+        }
+
+        chunk.used |= laterChunk.used;
+    }
+
+    mRegion |= later.mRegion;
+}
+
+void TileLayerDelta::apply(TileLayer *layer, Cells cells) const
+{
+    QHashIterator<quint64, Chunk> it(chunks());
+    while (it.hasNext()) {
+        it.next();
+
+        const Chunk &chunk = it.value();
+        const Cell *values = cells == OldCells ? chunk.oldCells
+                                               : chunk.newCells;
+        const int left = chunkX(it.key()) * ChunkSize - layer->x();
+        const int top = chunkY(it.key()) * ChunkSize - layer->y();
+
+        for (int index = 0; index < ChunkSize * ChunkSize; ++index) {
+            if (!(chunk.used & (Q_UINT64_C(1) << index)))
+                continue;
+
+            const int x = left + (index & ChunkMask);
+            const int y = top + (index >> ChunkBits);
+
+            if (layer->contains(x, y))
+                layer->setCell(x, y, values[index]);
+        }
+    }
+}
+
+void TileLayerDelta::compact()
+{
+    if (isCompact() || mChunks.isEmpty())
+        return;
+
+    // The chunks only hold plain values, so they can be copied as raw bytes
+    const int entrySize = sizeof(quint64) + sizeof(Chunk);
+    QByteArray data(mChunks.size() * entrySize, Qt::Uninitialized);
+    char *out = data.data();
+
+    QHashIterator<quint64, Chunk> it(mChunks);
+    while (it.hasNext()) {
+        it.next();
+
+        const quint64 key = it.key();
+        std::memcpy(out, &key, sizeof(quint64));
+        std::memcpy(out + sizeof(quint64), &it.value(), sizeof(Chunk));
+        out += entrySize;
+    }
+
+    const QByteArray compressed = compress(data);
+    if (compressed.isEmpty())
+        return;
+
+    mCompactChunks = compressed;
+    mCompactSize = data.size();
+    mChunks = Chunks();
+}
+
+TileLayerDelta::Chunks TileLayerDelta::chunks() const
+{
+    if (!isCompact())
+        return mChunks;
+
+    const QByteArray data = decompress(mCompactChunks, mCompactSize);
+    const int entrySize = sizeof(quint64) + sizeof(Chunk);
+    const int count = data.size() / entrySize;
+    const char *in = data.constData();
+
+    Chunks chunks;
+    chunks.reserve(count);
+
+    for (int i = 0; i < count; ++i, in += entrySize) {
+        quint64 key;
+        std::memcpy(&key, in, sizeof(quint64));
+        std::memcpy(&chunks[key], in + sizeof(quint64), sizeof(Chunk));
+    }
+
+    return chunks;
+}
+
+void TileLayerDelta::expand()
+{
+    if (!isCompact())
+        return;
+
+    mChunks = chunks();
+    mCompactChunks.clear();
+    mCompactSize = 0;
+}
+
+qint64 TileLayerDelta::memoryUsage() const
+{
+    // Each hash node holds the key, the chunk and a pointer to the next node
+    const qint64 nodeSize = sizeof(void*) + sizeof(quint64) + sizeof(Chunk);
+
+    return sizeof(TileLayerDelta) +
+            mChunks.size() * nodeSize +
+            mChunks.capacity() * sizeof(void*) +
+            mCompactChunks.capacity() +
+            mRegion.rectCount() * sizeof(QRect);
+}
@@ -0,0 +1,127 @@
+/*
+ * tilelayerdelta.h
+ * Copyright 2026, agent <agent@local>
+ *
+ * This file is part of Tiled.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILELAYERDELTA_H
+#define TILELAYERDELTA_H
+
+#include "tilelayer.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QRegion>
+
+namespace Tiled {
+namespace Internal {
+
+/**
+ * Stores the old and new value of each changed cell of a tile layer, for
+ * use by undo commands.
+ *
+ * Only the changed cells are stored, grouped in small chunks. This keeps the
+ * memory use proportional to the number of changed cells, rather than to the
+ * bounding rectangle of the change.
+ *
+ * Positions are in map coordinates.
+ */
+class TileLayerDelta
+{
+public:
+    enum Cells {
+        OldCells,
+        NewCells
+    };
+
+    TileLayerDelta() : mCompactSize(0) {}
+
+    /**
+     * Records that the cells of \a target within \a region are going to be
+     * replaced with the cells of \a source placed at \a x, \a y. Parts of the
+     * region that fall outside of either layer are ignored.
+     */
+    void record(const TileLayer *target,
+                const TileLayer *source, int x, int y,
+                const QRegion &region);
+
+    /**
+     * Merges the changes recorded in \a later, which happened after the
+     * changes in this delta, into this delta.
+     */
+    void merge(const TileLayerDelta &later);
+
+    /**
+     * Compresses the stored cells, to reduce the memory used by a delta that
+     * is unlikely to be needed soon. The cells are decompressed temporarily
+     * when the delta is applied, and permanently when it is changed.
+     */
+    void compact();
+
+    /**
+     * Returns whether the stored cells are compressed.
+     */
+    bool isCompact() const { return !mCompactChunks.isEmpty(); }
+
+    /**
+     * Sets either the old or the new cells on the given \a layer.
+     */
+    void apply(TileLayer *layer, Cells cells) const;
+
+    /**
+     * Returns the region of changed cells.
+     */
+    const QRegion &region() const { return mRegion; }
+
+    /**
+     * Returns an estimate of the memory used by this delta, in bytes.
+     */
+    qint64 memoryUsage() const;
+
+private:
+    enum {
+        ChunkBits = 3,
+        ChunkSize = 1 << ChunkBits,
+        ChunkMask = ChunkSize - 1
+    };
+
+    struct Chunk
+    {
+        Chunk() : used(0) {}
+
+        quint64 used;   // one bit for each cell that has changed
+        Cell oldCells[ChunkSize * ChunkSize];
+        Cell newCells[ChunkSize * ChunkSize];
+    };
+
+    typedef QHash<quint64, Chunk> Chunks;
+
+    static quint64 chunkKey(int chunkX, int chunkY);
+
+    Chunks chunks() const;
+    void expand();
+
+    Chunks mChunks;
+    QByteArray mCompactChunks;  // compressed chunks, when compact
+    int mCompactSize;           // uncompressed size of mCompactChunks
+    QRegion mRegion;
+};
+
+} // namespace Internal
+} // namespace Tiled
+
+#endif // TILELAYERDELTA_H
@@ -23,6 +23,9 @@
 
 #include "mapdocument.h"
 #include "map.h"
+#include "regionbuilder.h"
+
+#include <cstring>
 
 using namespace Tiled;
 using namespace Tiled::Internal;
@@ -110,6 +113,17 @@ void TilePainter::setCells(int x, int y,
     mMapDocument->emitRegionChanged(region, mTileLayer);
 }
 
+void TilePainter::setCells(const TileLayerDelta &delta,
+                           TileLayerDelta::Cells cells)
+{
+    if (delta.region().isEmpty())
+        return;
+
+    DrawMarginsWatcher watcher(mMapDocument, mTileLayer);
+    delta.apply(mTileLayer, cells);
+    mMapDocument->emitRegionChanged(delta.region(), mTileLayer);
+}
+
 void TilePainter::drawCells(int x, int y, TileLayer *tileLayer)
 {
     const QRegion region = paintableRegion(x, y,
@@ -183,14 +197,36 @@ void TilePainter::erase(const QRegion &region)
     mMapDocument->emitRegionChanged(paintable, mTileLayer);
 }
 
-static QRegion fillRegion(const TileLayer *layer, QPoint fillOrigin)
+/**
+ * Pushes a seed for each run of cells on row \a y between \a left and
+ * \a right (inclusive) that still needs to be filled.
+ */
+static void queueFillSeeds(const Cell *row,
+                           const quint8 *processedRow,
+                           const Cell &matchCell,
+                           int left, int right, int y,
+                           QVector<QPoint> &seeds)
 {
-    // Create that region that will hold the fill
-    QRegion fillRegion;
+    bool inRun = false;
+
+    for (int x = left; x <= right; ++x) {
+        if (!processedRow[x] && row[x] == matchCell) {
+            // Adjacent cells in the same run are found when the seed is
+            // expanded, so only the first one needs to be queued
+            if (!inRun)
+                seeds.append(QPoint(x, y));
+            inRun = true;
+        } else {
+            inRun = false;
+        }
+    }
+}
 
+static QRegion fillRegion(const TileLayer *layer, QPoint fillOrigin)
+{
     // Silently quit if parameters are unsatisfactory
     if (!layer->contains(fillOrigin))
-        return fillRegion;
+        return QRegion();
 
     // Cache cell that we will match other cells against
     const Cell matchCell = layer->cellAt(fillOrigin);
@@ -198,93 +234,56 @@ static QRegion fillRegion(const TileLayer *layer, QPoint fillOrigin)
     // Grab map dimensions for later use.
     const int layerWidth = layer->width();
     const int layerHeight = layer->height();
-    const int layerSize = layerWidth * layerHeight;
-
-    // Create a queue to hold cells that need filling
-    QList<QPoint> fillPositions;
-    fillPositions.append(fillOrigin);
+    const Cell *cells = layer->begin();
 
     // Create an array that will store which cells have been processed
     // This is faster than checking if a given cell is in the region/list
-    QVector<quint8> processedCellsVec(layerSize);
+    QVector<quint8> processedCellsVec(layerWidth * layerHeight);
     quint8 *processedCells = processedCellsVec.data();
 
-    // Loop through queued positions and fill them, while at the same time
-    // checking adjacent positions to see if they should be added
-    while (!fillPositions.empty()) {
-        const QPoint currentPoint = fillPositions.takeFirst();
-        const int startOfLine = currentPoint.y() * layerWidth;
+    // The filled spans are collected and turned into a region at the end,
+    // since uniting a QRegion with each span is very slow for large fills
+    RegionBuilder builder;
+
+    // Stack of positions from which to start filling a span
+    QVector<QPoint> seeds;
+    seeds.append(fillOrigin);
+
+    while (!seeds.isEmpty()) {
+        const QPoint seed = seeds.takeLast();
+        const int y = seed.y();
+        const Cell *row = cells + y * layerWidth;
+        quint8 *processedRow = processedCells + y * layerWidth;
+
+        // The seed may have been filled as part of another span already
+        if (processedRow[seed.x()])
+            continue;
 
         // Seek as far left as we can
-        int left = currentPoint.x();
-        while (left > 0 && layer->cellAt(left - 1, currentPoint.y()) == matchCell)
+        int left = seed.x();
+        while (left > 0 && !processedRow[left - 1] && row[left - 1] == matchCell)
             --left;
 
         // Seek as far right as we can
-        int right = currentPoint.x();
-        while (right + 1 < layerWidth && layer->cellAt(right + 1, currentPoint.y()) == matchCell)
+        int right = seed.x();
+        while (right + 1 < layerWidth && !processedRow[right + 1] && row[right + 1] == matchCell)
             ++right;
 
-        // Add cells between left and right to the region
-        fillRegion += QRegion(left, currentPoint.y(), right - left + 1, 1);
-
-        // Add cell strip to processed cells
-        memset(&processedCells[startOfLine + left],
-               1,
-               right - left);
-
-        // These variables cache whether the last cell was added to the queue
-        // or not as an optimization, since adjacent cells on the x axis
-        // do not need to be added to the queue.
-        bool lastAboveCell = false;
-        bool lastBelowCell = false;
-
-        // Loop between left and right and check if cells above or
-        // below need to be added to the queue
-        for (int x = left; x <= right; ++x) {
-            const QPoint fillPoint(x, currentPoint.y());
-
-            // Check cell above
-            if (fillPoint.y() > 0) {
-                QPoint aboveCell(fillPoint.x(), fillPoint.y() - 1);
-                if (!processedCells[aboveCell.y() * layerWidth + aboveCell.x()] &&
-                    layer->cellAt(aboveCell) == matchCell)
-                {
-                    // Do not add the above cell to the queue if its
-                    // x-adjacent cell was added.
-                    if (!lastAboveCell)
-                        fillPositions.append(aboveCell);
-
-                    lastAboveCell = true;
-                } else {
-                    lastAboveCell = false;
-                }
-
-                processedCells[aboveCell.y() * layerWidth + aboveCell.x()] = 1;
-            }
+        memset(processedRow + left, 1, right - left + 1);
+        builder.addSpan(left, right, y);
 
-            // Check cell below
-            if (fillPoint.y() + 1 < layerHeight) {
-                QPoint belowCell(fillPoint.x(), fillPoint.y() + 1);
-                if (!processedCells[belowCell.y() * layerWidth + belowCell.x()] &&
-                    layer->cellAt(belowCell) == matchCell)
-                {
-                    // Do not add the below cell to the queue if its
-                    // x-adjacent cell was added.
-                    if (!lastBelowCell)
-                        fillPositions.append(belowCell);
-
-                    lastBelowCell = true;
-                } else {
-                    lastBelowCell = false;
-                }
-
-                processedCells[belowCell.y() * layerWidth + belowCell.x()] = 1;
-            }
+        // Look for cells that need filling above and below this span
+        if (y > 0) {
+            queueFillSeeds(row - layerWidth, processedRow - layerWidth,
+                           matchCell, left, right, y - 1, seeds);
+        }
+        if (y + 1 < layerHeight) {
+            queueFillSeeds(row + layerWidth, processedRow + layerWidth,
+                           matchCell, left, right, y + 1, seeds);
         }
     }
 
-    return fillRegion;
+    return builder.region();
 }
 
 QRegion TilePainter::computePaintableFillRegion(const QPoint &fillOrigin) const
@@ -23,6 +23,7 @@
 #define TILEPAINTER_H
 
 #include "tilelayer.h"
+#include "tilelayerdelta.h"
 
 #include <QRegion>
 
@@ -73,6 +74,13 @@ public:
      */
     void setCells(int x, int y, TileLayer *tileLayer, const QRegion &mask);
 
+    /**
+     * Sets the cells changed by the given \a delta to either their old or
+     * their new values. The current selection is not taken into account,
+     * since it was already applied when the delta was recorded.
+     */
+    void setCells(const TileLayerDelta &delta, TileLayerDelta::Cells cells);
+
     /**
      * Draws the cells in the given tile layer at the given coordinates. The
      * coordinates \a x and \a y are relative to the map origin.
@@ -110,11 +118,15 @@ public:
      */
     bool isDrawable(int x, int y) const;
 
-private:
+    /**
+     * Returns the part of the given \a region that falls within the layer
+     * and the current selection.
+     */
     QRegion paintableRegion(const QRegion &region) const;
     QRegion paintableRegion(int x, int y, int width, int height) const
     { return paintableRegion(QRect(x, y, width, height)); }
 
+private:
     MapDocument *mMapDocument;
     TileLayer *mTileLayer;
 };
@@ -73,13 +73,7 @@ void TilesetManager::deleteInstance()
 
 SharedTileset TilesetManager::findTileset(const QString &fileName) const
 {
-    const QList<SharedTileset> &_tilesets = tilesets();
-
-    for (const SharedTileset &tileset : _tilesets)
-        if (tileset->fileName() == fileName)
-            return tileset;
-
-    return SharedTileset();
+    return mTilesetsByFileName.value(fileName);
 }
 
 void TilesetManager::addReference(const SharedTileset &tileset)
@@ -90,6 +84,8 @@ void TilesetManager::addReference(const SharedTileset &tileset)
         mTilesets.insert(tileset, 1);
         if (!tileset->imageSource().isEmpty())
             mWatcher->addPath(tileset->imageSource());
+        if (!tileset->fileName().isEmpty())
+            mTilesetsByFileName.insert(tileset->fileName(), tileset);
     }
 }
 
@@ -102,6 +98,8 @@ void TilesetManager::removeReference(const SharedTileset &tileset)
         mTilesets.remove(tileset);
         if (!tileset->imageSource().isEmpty())
             mWatcher->removePath(tileset->imageSource());
+        if (mTilesetsByFileName.value(tileset->fileName()) == tileset)
+            mTilesetsByFileName.remove(tileset->fileName());
     }
 }
 
@@ -165,6 +163,19 @@ void TilesetManager::tilesetImageSourceChanged(const Tileset &tileset,
     mWatcher->addPath(tileset.imageSource());
 }
 
+void TilesetManager::tilesetFileNameChanged(const Tileset &tileset,
+                                            const QString &oldFileName)
+{
+    const SharedTileset sharedTileset = tileset.sharedPointer();
+    if (!mTilesets.contains(sharedTileset))
+        return;
+
+    if (mTilesetsByFileName.value(oldFileName) == sharedTileset)
+        mTilesetsByFileName.remove(oldFileName);
+    if (!tileset.fileName().isEmpty())
+        mTilesetsByFileName.insert(tileset.fileName(), sharedTileset);
+}
+
 void TilesetManager::fileChanged(const QString &path)
 {
     if (!mReloadTilesetsOnChange)
@@ -25,6 +25,7 @@
 #include "tileset.h"
 
 #include <QObject>
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QString>
@@ -112,6 +113,9 @@ public:
     void tilesetImageSourceChanged(const Tileset &tileset,
                                    const QString &oldImageSource);
 
+    void tilesetFileNameChanged(const Tileset &tileset,
+                                const QString &oldFileName);
+
 signals:
     /**
      * Emitted when a tileset's images have changed and views need updating.
@@ -150,6 +154,11 @@ private:
      * Stores the tilesets and maps them to the number of references.
      */
     QMap<SharedTileset, int> mTilesets;
+
+    /**
+     * Indexes the tilesets by their file name, for findTileset().
+     */
+    QHash<QString, SharedTileset> mTilesetsByFileName;
     FileSystemWatcher *mWatcher;
     TileAnimationDriver *mAnimationDriver;
     QSet<QString> mChangedFiles;
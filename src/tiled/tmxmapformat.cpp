@@ -26,8 +26,7 @@
 #include "preferences.h"
 #include "tilesetmanager.h"
 
-#include <QBuffer>
-#include <QDir>
+#include <QFileInfo>
 
 using namespace Tiled;
 using namespace Tiled::Internal;
@@ -55,6 +54,17 @@ protected:
     }
 };
 
+/**
+ * Returns the path relative to which references are resolved when reading
+ * or writing the given file. An empty path means references are absolute.
+ */
+QString directoryPath(const QString &fileName)
+{
+    if (fileName.isEmpty())
+        return QString();
+    return QFileInfo(fileName).absolutePath();
+}
+
 } // anonymous namespace
 
 
@@ -86,33 +96,34 @@ bool TmxMapFormat::write(const Map *map, const QString &fileName)
     return result;
 }
 
-QByteArray TmxMapFormat::toByteArray(const Map *map)
-{
-    QBuffer buffer;
-    buffer.open(QIODevice::WriteOnly);
-
-    MapWriter writer;
-    writer.writeMap(map, &buffer);
-
-    return buffer.data();
-}
-
-Map *TmxMapFormat::fromByteArray(const QByteArray &data)
+Map *TmxMapFormat::readFromDevice(QIODevice *device, const QString &fileName)
 {
     mError.clear();
 
-    QBuffer buffer;
-    buffer.setData(data);
-    buffer.open(QBuffer::ReadOnly);
-
     EditorMapReader reader;
-    Map *map = reader.readMap(&buffer);
+    Map *map = reader.readMap(device, directoryPath(fileName));
     if (!map)
         mError = reader.errorString();
 
     return map;
 }
 
+bool TmxMapFormat::writeToDevice(const Map *map, QIODevice *device,
+                                 const QString &fileName)
+{
+    Preferences *prefs = Preferences::instance();
+
+    MapWriter writer;
+    writer.setDtdEnabled(prefs->dtdEnabled());
+    if (!writer.writeMap(map, device, directoryPath(fileName))) {
+        mError = writer.errorString();
+        return false;
+    }
+
+    mError.clear();
+    return true;
+}
+
 
 SharedTileset TsxTilesetFormat::read(const QString &fileName)
 {
@@ -141,3 +152,34 @@ bool TsxTilesetFormat::write(const Tileset &tileset, const QString &fileName)
 
     return result;
 }
+
+SharedTileset TsxTilesetFormat::readFromDevice(QIODevice *device,
+                                               const QString &fileName)
+{
+    mError.clear();
+
+    EditorMapReader reader;
+    SharedTileset tileset = reader.readTileset(device, directoryPath(fileName));
+    if (!tileset)
+        mError = reader.errorString();
+    else if (!fileName.isEmpty())
+        tileset->setFileName(fileName);
+
+    return tileset;
+}
+
+bool TsxTilesetFormat::writeToDevice(const Tileset &tileset, QIODevice *device,
+                                     const QString &fileName)
+{
+    Preferences *prefs = Preferences::instance();
+
+    MapWriter writer;
+    writer.setDtdEnabled(prefs->dtdEnabled());
+    if (!writer.writeTileset(tileset, device, directoryPath(fileName))) {
+        mError = writer.errorString();
+        return false;
+    }
+
+    mError.clear();
+    return true;
+}
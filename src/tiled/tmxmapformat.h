@@ -38,26 +38,17 @@ class TmxMapFormat : public MapFormat
     Q_OBJECT
 
 public:
+    Capabilities capabilities() const override
+    { return ReadWrite | ReadFromDevice | WriteToDevice; }
+
     Map *read(const QString &fileName) override;
 
     bool write(const Map *map, const QString &fileName) override;
 
-    /**
-     * Converts the given map to a utf8 byte array (in .tmx format). This is
-     * for storing a map in the clipboard. References to other files (like
-     * tileset images) will be saved as absolute paths.
-     *
-     * @see fromByteArray
-     */
-    QByteArray toByteArray(const Map *map);
-
-    /**
-     * Reads the map given from \a data. This is for retrieving a map from the
-     * clipboard. Returns null on failure.
-     *
-     * @see toByteArray
-     */
-    Map *fromByteArray(const QByteArray &data);
+    Map *readFromDevice(QIODevice *device, const QString &fileName) override;
+
+    bool writeToDevice(const Map *map, QIODevice *device,
+                       const QString &fileName) override;
 
     QString nameFilter() const override { return tr("Tiled map files (*.tmx)"); }
 
@@ -79,10 +70,19 @@ class TsxTilesetFormat : public TilesetFormat
     Q_OBJECT
 
 public:
+    Capabilities capabilities() const override
+    { return ReadWrite | ReadFromDevice | WriteToDevice; }
+
     SharedTileset read(const QString &fileName) override;
 
     bool write(const Tileset &tileset, const QString &fileName) override;
 
+    SharedTileset readFromDevice(QIODevice *device,
+                                 const QString &fileName) override;
+
+    bool writeToDevice(const Tileset &tileset, QIODevice *device,
+                       const QString &fileName) override;
+
     QString nameFilter() const override { return tr("Tiled tileset files (*.tsx)"); }
 
     bool supportsFile(const QString &fileName) const override
@@ -21,7 +21,10 @@
 
 #include "undodock.h"
 
+#include "mapdocument.h"
+
 #include <QEvent>
+#include <QLabel>
 #include <QUndoView>
 #include <QVBoxLayout>
 
@@ -30,6 +33,7 @@ using namespace Tiled::Internal;
 
 UndoDock::UndoDock(QUndoGroup *undoGroup, QWidget *parent)
     : QDockWidget(parent)
+    , mMapDocument(nullptr)
 {
     setObjectName(QLatin1String("undoViewDock"));
 
@@ -43,10 +47,31 @@ UndoDock::UndoDock(QUndoGroup *undoGroup, QWidget *parent)
     layout->setMargin(5);
     layout->addWidget(mUndoView);
 
+    mMemoryUsageLabel = new QLabel(widget);
+    layout->addWidget(mMemoryUsageLabel);
+
     setWidget(widget);
     retranslateUi();
 }
 
+void UndoDock::setMapDocument(MapDocument *mapDocument)
+{
+    if (mMapDocument == mapDocument)
+        return;
+
+    if (mMapDocument)
+        mMapDocument->disconnect(this);
+
+    mMapDocument = mapDocument;
+
+    if (mMapDocument) {
+        connect(mMapDocument, SIGNAL(undoMemoryUsageChanged(qint64)),
+                SLOT(updateMemoryUsage()));
+    }
+
+    updateMemoryUsage();
+}
+
 void UndoDock::changeEvent(QEvent *e)
 {
     QDockWidget::changeEvent(e);
@@ -63,4 +88,15 @@ void UndoDock::retranslateUi()
 {
     setWindowTitle(tr("History"));
     mUndoView->setEmptyLabel(tr("<empty>"));
+    updateMemoryUsage();
+}
+
+void UndoDock::updateMemoryUsage()
+{
+    mMemoryUsageLabel->setVisible(mMapDocument != nullptr);
+    if (!mMapDocument)
+        return;
+
+    const double megabytes = mMapDocument->undoMemoryUsage() / (1024.0 * 1024.0);
+    mMemoryUsageLabel->setText(tr("Memory used: %1 MB").arg(megabytes, 0, 'f', 1));
 }
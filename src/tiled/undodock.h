@@ -24,12 +24,15 @@
 
 #include <QDockWidget>
 
+class QLabel;
 class QUndoGroup;
 class QUndoView;
 
 namespace Tiled {
 namespace Internal {
 
+class MapDocument;
+
 /**
  * A dock widget showing the undo stack. Mainly for debugging, but can also be
  * useful for the user.
@@ -41,12 +44,20 @@ class UndoDock : public QDockWidget
 public:
     UndoDock(QUndoGroup *undoGroup, QWidget *parent = nullptr);
 
+    void setMapDocument(MapDocument *mapDocument);
+
 protected:
     void changeEvent(QEvent *e) override;
 
+private slots:
+    void updateMemoryUsage();
+
 private:
     void retranslateUi();
+
+    MapDocument *mMapDocument;
     QUndoView *mUndoView;
+    QLabel *mMemoryUsageLabel;
 };
 
 } // namespace Internal
@@ -0,0 +1,322 @@
+#include "jsonpullreader.h"
+#include "map.h"
+#include "tilelayer.h"
+#include "tileset.h"
+#include "varianttomapconverter.h"
+
+#include <QBuffer>
+#include <QTemporaryFile>
+#include <QtTest/QtTest>
+
+using namespace Tiled;
+using namespace Json;
+
+class test_JsonPullReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void scalars_data();
+    void scalars();
+    void stringEscapes_data();
+    void stringEscapes();
+    void nestedContainers();
+    void gidArrays();
+    void errors_data();
+    void errors();
+    void readsAcrossChunks();
+    void jsonpPrefix();
+    void gidVectorToMap();
+};
+
+static QVariant readJson(const QByteArray &json, QString *error = nullptr)
+{
+    QBuffer buffer;
+    buffer.setData(json);
+    buffer.open(QIODevice::ReadOnly);
+
+    JsonPullReader reader(&buffer);
+    const QVariant result = reader.read();
+    if (error)
+        *error = reader.errorString();
+    return result;
+}
+
+void test_JsonPullReader::scalars_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QVariant>("expected");
+
+    QTest::newRow("true") << QByteArray("true") << QVariant(true);
+    QTest::newRow("false") << QByteArray(" false ") << QVariant(false);
+    QTest::newRow("zero") << QByteArray("0") << QVariant(0);
+    QTest::newRow("negative") << QByteArray("-42") << QVariant(-42);
+    QTest::newRow("int64") << QByteArray("12345678901") << QVariant(Q_INT64_C(12345678901));
+    QTest::newRow("too big for int64") << QByteArray("123456789012345678901") << QVariant(123456789012345678901.0);
+    QTest::newRow("fraction") << QByteArray("1.5") << QVariant(1.5);
+    QTest::newRow("exponent") << QByteArray("1e3") << QVariant(1000.0);
+    QTest::newRow("positive exponent") << QByteArray("2E+2") << QVariant(200.0);
+    QTest::newRow("negative exponent") << QByteArray("-2.5e-2") << QVariant(-0.025);
+    QTest::newRow("string") << QByteArray("\"tiled\"") << QVariant(QStringLiteral("tiled"));
+}
+
+void test_JsonPullReader::scalars()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QVariant, expected);
+
+    QString error;
+    const QVariant result = readJson(json, &error);
+
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    QCOMPARE(result.userType(), expected.userType());
+    QCOMPARE(result, expected);
+}
+
+void test_JsonPullReader::stringEscapes_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("simple escapes")
+            << QByteArray("\"\\\" \\\\ \\/ \\b \\f \\n \\r \\t\"")
+            << QStringLiteral("\" \\ / \b \f \n \r \t");
+    QTest::newRow("basic multilingual plane")
+            << QByteArray("\"\\u0041\\u00e9\\u20AC\"")
+            << QString::fromUtf8("A\xC3\xA9\xE2\x82\xAC");
+    QTest::newRow("surrogate pair")
+            << QByteArray("\"a\\ud83d\\ude00b\"")
+            << QString::fromUtf8("a\xF0\x9F\x98\x80" "b");
+    QTest::newRow("raw utf-8")
+            << QByteArray("\"\xC3\xA9t\xC3\xA9\"")
+            << QString::fromUtf8("\xC3\xA9t\xC3\xA9");
+    QTest::newRow("empty") << QByteArray("\"\"") << QString();
+}
+
+void test_JsonPullReader::stringEscapes()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+
+    QString error;
+    const QVariant result = readJson(json, &error);
+
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    QCOMPARE(result.toString(), expected);
+}
+
+void test_JsonPullReader::nestedContainers()
+{
+    const QVariant result = readJson("{ \"a\": [1, [2, [3]], {}], "
+                                     "\"b\": { \"c\": { \"d\": null } }, "
+                                     "\"e\": [] }");
+
+    const QVariantMap map = result.toMap();
+    QCOMPARE(map.size(), 3);
+
+    const QVariantList a = map.value(QLatin1String("a")).toList();
+    QCOMPARE(a.size(), 3);
+    QCOMPARE(a.at(0), QVariant(1));
+    QCOMPARE(a.at(1).toList().at(1).toList().at(0), QVariant(3));
+    QVERIFY(a.at(2).toMap().isEmpty());
+
+    const QVariantMap c = map.value(QLatin1String("b")).toMap().value(QLatin1String("c")).toMap();
+    QVERIFY(c.contains(QLatin1String("d")));
+    QVERIFY(c.value(QLatin1String("d")).isNull());
+
+    QCOMPARE(map.value(QLatin1String("e")).toList().size(), 0);
+}
+
+void test_JsonPullReader::gidArrays()
+{
+    const int gidVectorType = qMetaTypeId<QVector<unsigned> >();
+
+    // Only unsigned integers under a "data" key become a gid vector
+    QVariant data = readJson("{\"data\":[0, 1, 4294967295, 2147483650]}")
+            .toMap().value(QLatin1String("data"));
+    QCOMPARE(data.userType(), gidVectorType);
+    QCOMPARE(data.value<QVector<unsigned> >(),
+             QVector<unsigned>() << 0 << 1 << 4294967295u << 2147483650u);
+
+    data = readJson("{\"other\":[1, 2]}").toMap().value(QLatin1String("other"));
+    QCOMPARE(data.userType(), int(QMetaType::QVariantList));
+
+    // Arrays that turn out to contain other values keep all of them
+    data = readJson("{\"data\":[1, 2, \"x\"]}").toMap().value(QLatin1String("data"));
+    QCOMPARE(data.userType(), int(QMetaType::QVariantList));
+    QCOMPARE(data.toList(), QVariantList() << 1 << 2 << QStringLiteral("x"));
+
+    data = readJson("{\"data\":[1, 4294967296]}").toMap().value(QLatin1String("data"));
+    QCOMPARE(data.toList(), QVariantList() << 1 << Q_INT64_C(4294967296));
+
+    data = readJson("{\"data\":[1, -1, 2.5]}").toMap().value(QLatin1String("data"));
+    QCOMPARE(data.toList(), QVariantList() << 1 << -1 << 2.5);
+
+    // An empty array has nothing to tell it apart
+    data = readJson("{\"data\":[]}").toMap().value(QLatin1String("data"));
+    QVERIFY(data.toList().isEmpty());
+}
+
+void test_JsonPullReader::errors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<int>("line");
+
+    QTest::newRow("empty") << QByteArray("") << 1;
+    QTest::newRow("truncated object") << QByteArray("{\n\"a\": 1,\n\"b\"") << 3;
+    QTest::newRow("truncated array") << QByteArray("[1,\n2,\n") << 3;
+    QTest::newRow("truncated string") << QByteArray("\n\"abc") << 2;
+    QTest::newRow("truncated escape") << QByteArray("\"\\u00") << 1;
+    QTest::newRow("bad literal") << QByteArray("{\n\"a\": tru\n}") << 2;
+    QTest::newRow("missing colon") << QByteArray("{\"a\" 1}") << 1;
+    QTest::newRow("missing comma") << QByteArray("[\n1\n2]") << 3;
+    QTest::newRow("bad escape") << QByteArray("\"\\x\"") << 1;
+    QTest::newRow("lone surrogate") << QByteArray("\n\n\"\\ud83d\"") << 3;
+    QTest::newRow("control character") << QByteArray("\n\"a\tb\"") << 2;
+    QTest::newRow("trailing data") << QByteArray("{}\n{}") << 2;
+    QTest::newRow("top-level null") << QByteArray("null") << 1;
+    QTest::newRow("too deep") << QByteArray(1000, '[') << 1;
+}
+
+void test_JsonPullReader::errors()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(int, line);
+
+    QString error;
+    const QVariant result = readJson(json, &error);
+
+    QVERIFY(!result.isValid());
+    QVERIFY2(error.startsWith(QStringLiteral("Line %1:").arg(line)),
+             qPrintable(error));
+}
+
+void test_JsonPullReader::readsAcrossChunks()
+{
+    // Larger than the chunk size, with escapes and numbers at every offset
+    QByteArray json("{\"strings\":[");
+    for (int i = 0; i < 20000; ++i) {
+        if (i > 0)
+            json.append(',');
+        json.append("\"s\\u00e9\\n");
+        json.append(QByteArray::number(i));
+        json.append('"');
+    }
+    json.append("],\"data\":[");
+    for (int i = 0; i < 20000; ++i) {
+        if (i > 0)
+            json.append(',');
+        json.append(QByteArray::number(i * 7919u));
+    }
+    json.append("]}");
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(json), qint64(json.size()));
+    QVERIFY(file.seek(0));
+
+    JsonPullReader reader(&file);
+    const QVariant fromFile = reader.read();
+    QVERIFY2(reader.errorString().isEmpty(), qPrintable(reader.errorString()));
+
+    const QVariantMap map = fromFile.toMap();
+    const QVariantList strings = map.value(QLatin1String("strings")).toList();
+    QCOMPARE(strings.size(), 20000);
+    QCOMPARE(strings.at(12345).toString(), QString::fromUtf8("s\xC3\xA9\n12345"));
+
+    const QVector<unsigned> gids = map.value(QLatin1String("data")).value<QVector<unsigned> >();
+    QCOMPARE(gids.size(), 20000);
+    QCOMPARE(gids.at(19999), 19999 * 7919u);
+
+    const QVariantMap fromBuffer = readJson(json).toMap();
+    QCOMPARE(fromBuffer.value(QLatin1String("strings")).toList(), strings);
+    QCOMPARE(fromBuffer.value(QLatin1String("data")).value<QVector<unsigned> >(), gids);
+}
+
+void test_JsonPullReader::jsonpPrefix()
+{
+    QBuffer buffer;
+    buffer.setData("(function(name,data){})(\"map\",\n{\"a\": 1});\n");
+    buffer.open(QIODevice::ReadOnly);
+
+    JsonPullReader reader(&buffer);
+    reader.skipJsonpPrefix();
+
+    const QVariant result = reader.read(false);
+    QVERIFY2(reader.errorString().isEmpty(), qPrintable(reader.errorString()));
+    QCOMPARE(result.toMap().value(QLatin1String("a")), QVariant(1));
+}
+
+static QByteArray mapJson(const QByteArray &data, int width, int height)
+{
+    return "{ \"orientation\": \"orthogonal\","
+            " \"width\": " + QByteArray::number(width) + ","
+            " \"height\": " + QByteArray::number(height) + ","
+            " \"tilewidth\": 32, \"tileheight\": 32,"
+            " \"tilesets\": [ { \"firstgid\": 1, \"name\": \"tiles\","
+            "   \"tilewidth\": 32, \"tileheight\": 32,"
+            "   \"tiles\": { \"0\": {}, \"1\": {}, \"2\": {} } } ],"
+            " \"layers\": [ { \"type\": \"tilelayer\", \"name\": \"ground\","
+            "   \"width\": " + QByteArray::number(width) + ","
+            "   \"height\": " + QByteArray::number(height) + ","
+            "   \"opacity\": 1, \"visible\": true,"
+            "   \"data\": " + data + " } ] }";
+}
+
+void test_JsonPullReader::gidVectorToMap()
+{
+    const QVariant variant = readJson(mapJson("[1, 0, 3, 2147483650]", 2, 2));
+
+    const QVariant data = variant.toMap().value(QLatin1String("layers")).toList()
+            .at(0).toMap().value(QLatin1String("data"));
+    QCOMPARE(data.userType(), qMetaTypeId<QVector<unsigned> >());
+
+    VariantToMapConverter converter;
+    QScopedPointer<Map> map(converter.toMap(variant, QDir()));
+    QVERIFY2(map, qPrintable(converter.errorString()));
+
+    TileLayer *layer = map->layerAt(0)->asTileLayer();
+    QVERIFY(layer);
+
+    const Tileset *tileset = map->tilesetAt(0).data();
+    QCOMPARE(layer->cellAt(0, 0).tile, tileset->findTile(0));
+    QVERIFY(layer->cellAt(1, 0).isEmpty());
+    QCOMPARE(layer->cellAt(0, 1).tile, tileset->findTile(2));
+    QCOMPARE(layer->cellAt(1, 1).tile, tileset->findTile(1));
+    QVERIFY(layer->cellAt(1, 1).flippedHorizontally);
+    QVERIFY(!layer->cellAt(1, 1).flippedVertically);
+
+    // The generic list path gives the same result
+    QVariantMap mapVariant = variant.toMap();
+    QVariantList layers = mapVariant.value(QLatin1String("layers")).toList();
+    QVariantMap layerVariant = layers.at(0).toMap();
+    QVariantList list;
+    for (unsigned gid : data.value<QVector<unsigned> >())
+        list.append(gid);
+    layerVariant[QLatin1String("data")] = list;
+    layers[0] = layerVariant;
+    mapVariant[QLatin1String("layers")] = layers;
+
+    QScopedPointer<Map> listMap(converter.toMap(mapVariant, QDir()));
+    QVERIFY2(listMap, qPrintable(converter.errorString()));
+
+    TileLayer *listLayer = listMap->layerAt(0)->asTileLayer();
+    for (int y = 0; y < 2; ++y) {
+        for (int x = 0; x < 2; ++x) {
+            const Cell &cell = listLayer->cellAt(x, y);
+            const Cell &expected = layer->cellAt(x, y);
+            QCOMPARE(cell.isEmpty(), expected.isEmpty());
+            if (!cell.isEmpty())
+                QCOMPARE(cell.tile->id(), expected.tile->id());
+            QCOMPARE(cell.flippedHorizontally, expected.flippedHorizontally);
+        }
+    }
+
+    // A gid vector of the wrong size is rejected
+    QScopedPointer<Map> corrupt(converter.toMap(readJson(mapJson("[1, 0, 3]", 2, 2)), QDir()));
+    QVERIFY(!corrupt);
+    QVERIFY(converter.errorString().contains(QLatin1String("Corrupt layer data")));
+}
+
+QTEST_MAIN(test_JsonPullReader)
+#include "test_jsonpullreader.moc"
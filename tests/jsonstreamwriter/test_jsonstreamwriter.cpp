@@ -0,0 +1,306 @@
+#include "jsonstreamwriter.h"
+#include "map.h"
+#include "maptovariantconverter.h"
+#include "mapobject.h"
+#include "objectgroup.h"
+#include "tilelayer.h"
+#include "tileset.h"
+
+#include <QBuffer>
+#include <QtTest/QtTest>
+
+using namespace Tiled;
+using namespace Json;
+
+class test_JsonStreamWriter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void matchesJsonWriter_data();
+    void matchesJsonWriter();
+    void mapMatchesJsonWriter();
+    void gidsMatchJsonWriter();
+    void tileRowsOnSeparateLines();
+    void doublesWithoutLoss();
+    void controlCharacters();
+};
+
+/*
+ * The escaping and formatting of the JsonWriter that JsonStreamWriter
+ * replaced, kept here to check that the output did not change.
+ */
+static QString referenceEscape(const QString &str)
+{
+    QString res;
+    for (int i = 0; i < str.length(); i++) {
+        if (str[i] == QLatin1Char('\b')) {
+            res += QLatin1String("\\b");
+        } else if (str[i] == QLatin1Char('\f')) {
+            res += QLatin1String("\\f");
+        } else if (str[i] == QLatin1Char('\n')) {
+            res += QLatin1String("\\n");
+        } else if (str[i] == QLatin1Char('\r')) {
+            res += QLatin1String("\\r");
+        } else if (str[i] == QLatin1Char('\t')) {
+            res += QLatin1String("\\t");
+        } else if (str[i] == QLatin1Char('\"')) {
+            res += QLatin1String("\\\"");
+        } else if (str[i] == QLatin1Char('\\')) {
+            res += QLatin1String("\\\\");
+        } else if (str[i] == QLatin1Char('/')) {
+            res += QLatin1String("\\/");
+        } else if (str[i].unicode() > 127) {
+            res += QLatin1String("\\u") + QString::number(str[i].unicode(), 16).rightJustified(4, QLatin1Char('0'));
+        } else {
+            res += str[i];
+        }
+    }
+    return res;
+}
+
+static void referenceStringify(QString &result, const QVariant &variant,
+                               bool autoFormatting, int depth = 0)
+{
+    if (variant.type() == QVariant::List || variant.type() == QVariant::StringList) {
+        result += QLatin1Char('[');
+        QVariantList list = variant.toList();
+        for (int i = 0; i < list.count(); i++) {
+            if (i != 0) {
+                result += QLatin1Char(',');
+                if (autoFormatting)
+                    result += QLatin1Char(' ');
+            }
+            referenceStringify(result, list[i], autoFormatting, depth + 1);
+        }
+        result += QLatin1Char(']');
+    } else if (variant.type() == QVariant::Map) {
+        QString indent = QString(4, QLatin1Char(' ')).repeated(depth);
+        QVariantMap map = variant.toMap();
+        if (autoFormatting && depth != 0) {
+            result += QLatin1Char('\n');
+            result += indent;
+            result += QLatin1String("{\n");
+        } else {
+            result += QLatin1Char('{');
+        }
+        for (QVariantMap::const_iterator it = map.constBegin(); it != map.constEnd(); ++it) {
+            if (it != map.constBegin()) {
+                result += QLatin1Char(',');
+                if (autoFormatting)
+                    result += QLatin1Char('\n');
+            }
+            if (autoFormatting)
+                result += indent + QLatin1Char(' ');
+            result += QLatin1Char('\"') + referenceEscape(it.key()) + QLatin1String("\":");
+            referenceStringify(result, it.value(), autoFormatting, depth + 1);
+        }
+        if (autoFormatting) {
+            result += QLatin1Char('\n');
+            result += indent;
+        }
+        result += QLatin1Char('}');
+    } else if (variant.type() == QVariant::String || variant.type() == QVariant::ByteArray) {
+        result += QLatin1Char('\"') + referenceEscape(variant.toString()) + QLatin1Char('\"');
+    } else if (variant.type() == QVariant::Double || (int)variant.type() == (int)QMetaType::Float) {
+        double d = variant.toDouble();
+        if (qIsFinite(d))
+            result += QString::number(variant.toDouble(), 'g', 15);
+        else
+            result += QLatin1String("null");
+    } else if (variant.type() == QVariant::Bool) {
+        result += variant.toBool() ? QLatin1String("true") : QLatin1String("false");
+    } else if (variant.type() == QVariant::Invalid) {
+        result += QLatin1String("null");
+    } else if (variant.type() == QVariant::ULongLong) {
+        result += QString::number(variant.toULongLong());
+    } else if (variant.type() == QVariant::LongLong) {
+        result += QString::number(variant.toLongLong());
+    } else if (variant.type() == QVariant::Int) {
+        result += QString::number(variant.toInt());
+    } else if (variant.type() == QVariant::UInt) {
+        result += QString::number(variant.toUInt());
+    } else if (variant.canConvert<qlonglong>()) {
+        result += QString::number(variant.toLongLong());
+    } else {
+        result += QLatin1Char('\"') + referenceEscape(variant.toString()) + QLatin1Char('\"');
+    }
+}
+
+static QByteArray reference(const QVariant &variant, bool autoFormatting)
+{
+    QString result;
+    referenceStringify(result, variant, autoFormatting);
+    return result.toUtf8();
+}
+
+static QByteArray writeJson(const QVariant &variant, bool autoFormatting,
+                            bool tileRowsOnSeparateLines = false)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    JsonStreamWriter writer(&buffer);
+    writer.setAutoFormatting(autoFormatting);
+    writer.setTileRowsOnSeparateLines(tileRowsOnSeparateLines);
+    writer.writeValue(variant);
+    if (!writer.flush())
+        qWarning() << writer.errorString();
+
+    return buffer.data();
+}
+
+void test_JsonStreamWriter::matchesJsonWriter_data()
+{
+    QTest::addColumn<QVariant>("variant");
+
+    QVariantMap inner;
+    inner[QLatin1String("name")] = QStringLiteral("a \"quoted\" \\ path/to\tfile");
+    inner[QLatin1String("unicode")] = QString::fromUtf8("\xC3\xA9t\xC3\xA9 \xE2\x82\xAC");
+    inner[QLatin1String("empty")] = QVariantMap();
+    inner[QLatin1String("list")] = QVariantList() << 1 << 2.5 << QStringLiteral("x")
+                                                  << QVariantList() << QVariant();
+
+    QVariantMap map;
+    map[QLatin1String("bool")] = true;
+    map[QLatin1String("int")] = -42;
+    map[QLatin1String("uint")] = 4294967295u;
+    map[QLatin1String("longlong")] = Q_INT64_C(-12345678901);
+    map[QLatin1String("double")] = 0.25;
+    map[QLatin1String("whole double")] = 16.0;
+    map[QLatin1String("nan")] = qQNaN();
+    map[QLatin1String("null")] = QVariant();
+    map[QLatin1String("inner")] = inner;
+    map[QLatin1String("objects")] = QVariantList() << inner << inner;
+    map[QLatin1String("strings")] = QStringList() << QStringLiteral("a") << QStringLiteral("b");
+
+    QTest::newRow("scalar") << QVariant(12);
+    QTest::newRow("string") << QVariant(QStringLiteral("\b\f\n\r"));
+    QTest::newRow("empty list") << QVariant(QVariantList());
+    QTest::newRow("empty map") << QVariant(QVariantMap());
+    QTest::newRow("nested") << QVariant(map);
+}
+
+void test_JsonStreamWriter::matchesJsonWriter()
+{
+    QFETCH(QVariant, variant);
+
+    QCOMPARE(writeJson(variant, false), reference(variant, false));
+    QCOMPARE(writeJson(variant, true), reference(variant, true));
+}
+
+void test_JsonStreamWriter::mapMatchesJsonWriter()
+{
+    Map map(Map::Orthogonal, 3, 2, 32, 32);
+    map.setProperty(QLatin1String("title"), QString::fromUtf8("Ca\xC3\xB1on / \"Rio\""));
+
+    SharedTileset tileset = Tileset::create(QLatin1String("tiles"), 32, 32);
+    for (int id = 0; id < 4; ++id)
+        tileset->findOrCreateTile(id)->setProperty(QLatin1String("id"), id);
+    map.addTileset(tileset);
+
+    TileLayer *tileLayer = new TileLayer(QLatin1String("ground"), 0, 0, 3, 2);
+    tileLayer->setCell(0, 0, Cell(tileset->findTile(0)));
+    tileLayer->setCell(2, 0, Cell(tileset->findTile(3)));
+    Cell flipped(tileset->findTile(1));
+    flipped.flippedHorizontally = true;
+    tileLayer->setCell(1, 1, flipped);
+    map.addLayer(tileLayer);
+
+    ObjectGroup *objectGroup = new ObjectGroup(QLatin1String("objects"), 0, 0, 3, 2);
+    MapObject *object = new MapObject(QLatin1String("spawn"), QLatin1String("point"),
+                                      QPointF(16.5, 8.25), QSizeF(0, 0));
+    object->setProperty(QLatin1String("note"), QStringLiteral("line 1\nline 2"));
+    objectGroup->addObject(object);
+    MapObject *polygon = new MapObject(QString(), QString(),
+                                       QPointF(32, 32), QSizeF(0, 0));
+    polygon->setShape(MapObject::Polygon);
+    polygon->setPolygon(QPolygonF() << QPointF(0, 0) << QPointF(10.5, 0) << QPointF(0, -4));
+    objectGroup->addObject(polygon);
+    map.addLayer(objectGroup);
+
+    MapToVariantConverter converter;
+    const QVariant variant = converter.toVariant(&map, QDir());
+
+    converter.setCompactLayerData(true);
+    const QVariant compactVariant = converter.toVariant(&map, QDir());
+
+    // The compact layer data must be written just like the list of variants
+    QCOMPARE(writeJson(compactVariant, true), reference(variant, true));
+    QCOMPARE(writeJson(compactVariant, false), reference(variant, false));
+    QCOMPARE(writeJson(variant, true), reference(variant, true));
+}
+
+void test_JsonStreamWriter::gidsMatchJsonWriter()
+{
+    // Enough data to go through the write buffer several times
+    QVector<unsigned> gids;
+    QVariantList gidList;
+    for (unsigned i = 0; i < 100000; ++i) {
+        const unsigned gid = i * 2654435761u;
+        gids.append(gid);
+        gidList.append(gid);
+    }
+
+    QVariantMap layer;
+    layer[QLatin1String("data")] = QVariant::fromValue(gids);
+    QVariantMap listLayer;
+    listLayer[QLatin1String("data")] = gidList;
+
+    QCOMPARE(writeJson(layer, true), reference(listLayer, true));
+    QCOMPARE(writeJson(layer, false), reference(listLayer, false));
+}
+
+void test_JsonStreamWriter::tileRowsOnSeparateLines()
+{
+    QVariantMap layer;
+    layer[QLatin1String("data")] = QVariant::fromValue(QVector<unsigned>() << 1 << 2 << 3
+                                                                           << 4 << 5 << 6);
+    layer[QLatin1String("width")] = 3;
+
+    QCOMPARE(writeJson(layer, true, true),
+             QByteArray("{ \"data\":[\n"
+                        "    1, 2, 3,\n"
+                        "    4, 5, 6\n"
+                        " ],\n"
+                        " \"width\":3\n"
+                        "}"));
+
+    // The rows are indented one level deeper than the layer's keys
+    layer[QLatin1String("width")] = 2;
+    QVariantMap map;
+    map[QLatin1String("layers")] = QVariantList() << layer;
+
+    QCOMPARE(writeJson(map, true, true),
+             QByteArray("{ \"layers\":[\n"
+                        "        {\n"
+                        "         \"data\":[\n"
+                        "            1, 2,\n"
+                        "            3, 4,\n"
+                        "            5, 6\n"
+                        "         ],\n"
+                        "         \"width\":2\n"
+                        "        }]\n"
+                        "}"));
+
+    // Without auto-formatting, the option has no effect
+    QCOMPARE(writeJson(layer, false, true),
+             QByteArray("{\"data\":[1,2,3,4,5,6],\"width\":2}"));
+}
+
+void test_JsonStreamWriter::doublesWithoutLoss()
+{
+    // JsonWriter only wrote 15 significant digits
+    QCOMPARE(reference(0.1 + 0.2, false), QByteArray("0.3"));
+    QCOMPARE(writeJson(0.1 + 0.2, false), QByteArray("0.30000000000000004"));
+}
+
+void test_JsonStreamWriter::controlCharacters()
+{
+    // JsonWriter wrote these unescaped, which is not valid JSON
+    QCOMPARE(writeJson(QStringLiteral("a\x01" "b\x1f"), false),
+             QByteArray("\"a\\u0001b\\u001f\""));
+}
+
+QTEST_MAIN(test_JsonStreamWriter)
+#include "test_jsonstreamwriter.moc"
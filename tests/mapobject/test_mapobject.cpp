@@ -0,0 +1,133 @@
+#include "mapobject.h"
+
+#include <QtMath>
+#include <QtTest/QtTest>
+
+#include <cmath>
+#include <limits>
+
+using namespace Tiled;
+
+class test_MapObject : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void simplifiedPolygonKeepsSpikes();
+    void simplifiedPolygonKeepsBacktracking();
+    void simplifiedPolygonWithDegenerateSegment();
+    void smallPolygonsAreNotSimplified();
+};
+
+static qreal distanceToSegment(const QPointF &p, const QPointF &a, const QPointF &b)
+{
+    const QPointF segment = b - a;
+    const qreal lengthSquared = QPointF::dotProduct(segment, segment);
+
+    qreal t = 0;
+    if (lengthSquared > 0)
+        t = qBound(qreal(0), QPointF::dotProduct(p - a, segment) / lengthSquared, qreal(1));
+
+    const QPointF delta = p - (a + segment * t);
+    return std::sqrt(QPointF::dotProduct(delta, delta));
+}
+
+static qreal distanceToPolyline(const QPointF &p, const QPolygonF &polyline)
+{
+    if (polyline.size() == 1)
+        return distanceToSegment(p, polyline.first(), polyline.first());
+
+    qreal distance = std::numeric_limits<qreal>::max();
+    for (int i = 1; i < polyline.size(); ++i)
+        distance = qMin(distance, distanceToSegment(p, polyline.at(i - 1), polyline.at(i)));
+    return distance;
+}
+
+/**
+ * Verifies that every point of \a original lies within \a tolerance of the
+ * \a simplified polyline, and that the end points were kept.
+ */
+static void verifySimplification(const QPolygonF &original,
+                                 const QPolygonF &simplified,
+                                 qreal tolerance)
+{
+    QVERIFY(simplified.size() >= 2);
+    QCOMPARE(simplified.first(), original.first());
+    QCOMPARE(simplified.last(), original.last());
+
+    for (const QPointF &point : original)
+        QVERIFY(distanceToPolyline(point, simplified) <= tolerance);
+}
+
+void test_MapObject::simplifiedPolygonKeepsSpikes()
+{
+    // A straight line with one point shooting far past its end, but exactly
+    // in line with it
+    QPolygonF polygon;
+    for (int i = 0; i < 200; ++i)
+        polygon.append(QPointF(i, 0));
+    polygon[100] = QPointF(1000, 0);
+
+    MapObject object;
+    object.setPolygon(polygon);
+
+    const QPolygonF simplified = object.simplifiedPolygon(1);
+    QVERIFY(simplified.size() < polygon.size());
+    QVERIFY(simplified.contains(QPointF(1000, 0)));
+    verifySimplification(polygon, simplified, 0.5);
+}
+
+void test_MapObject::simplifiedPolygonKeepsBacktracking()
+{
+    // A line that goes right and then doubles back halfway
+    QPolygonF polygon;
+    for (int i = 0; i < 100; ++i)
+        polygon.append(QPointF(i, 0));
+    for (int i = 98; i >= 50; --i)
+        polygon.append(QPointF(i, 0));
+
+    MapObject object;
+    object.setPolygon(polygon);
+
+    const QPolygonF simplified = object.simplifiedPolygon(1);
+    QCOMPARE(simplified.size(), 3);
+    QCOMPARE(simplified.at(1), QPointF(99, 0));
+    verifySimplification(polygon, simplified, 0.5);
+}
+
+void test_MapObject::simplifiedPolygonWithDegenerateSegment()
+{
+    // A closed outline, so the first and the last point are the same
+    QPolygonF polygon;
+    const int count = 256;
+    for (int i = 0; i <= count; ++i) {
+        const qreal angle = 2 * M_PI * (i % count) / count;
+        polygon.append(QPointF(std::cos(angle) * 100, std::sin(angle) * 100));
+    }
+
+    MapObject object;
+    object.setPolygon(polygon);
+
+    for (qreal scale : { 0.125, 0.5, 1.0, 4.0 }) {
+        const QPolygonF simplified = object.simplifiedPolygon(scale);
+        const qreal tolerance = std::ldexp(0.5, -qCeil(std::log2(scale)));
+
+        QVERIFY(simplified.size() > 2);
+        verifySimplification(polygon, simplified, tolerance);
+    }
+}
+
+void test_MapObject::smallPolygonsAreNotSimplified()
+{
+    QPolygonF polygon;
+    for (int i = 0; i < 10; ++i)
+        polygon.append(QPointF(i, 0));
+
+    MapObject object;
+    object.setPolygon(polygon);
+
+    QCOMPARE(object.simplifiedPolygon(0.01), polygon);
+}
+
+QTEST_MAIN(test_MapObject)
+#include "test_mapobject.moc"
@@ -3,7 +3,9 @@
 #include "objectgroup.h"
 #include "tilelayer.h"
 #include "mapreader.h"
+#include "tileset.h"
 
+#include <QBuffer>
 #include <QtTest/QtTest>
 
 using namespace Tiled;
@@ -14,6 +16,7 @@ class test_MapReader : public QObject
 
 private slots:
     void loadMap();
+    void loadXmlLayerData();
 };
 
 void test_MapReader::loadMap()
@@ -53,5 +56,47 @@ void test_MapReader::loadMap()
     QCOMPARE(mapObject->height(), qreal(64));
 }
 
+void test_MapReader::loadXmlLayerData()
+{
+    QBuffer buffer;
+    buffer.setData("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                   "<map version=\"1.0\" orientation=\"orthogonal\" renderorder=\"right-down\""
+                   " width=\"3\" height=\"2\" tilewidth=\"32\" tileheight=\"32\">\n"
+                   " <tileset firstgid=\"1\" name=\"tiles\" tilewidth=\"32\" tileheight=\"32\">\n"
+                   "  <tile id=\"0\"/>\n"
+                   "  <tile id=\"1\"/>\n"
+                   "  <tile id=\"2\"/>\n"
+                   " </tileset>\n"
+                   " <layer name=\"ground\" width=\"3\" height=\"2\">\n"
+                   "  <data>\n"
+                   "   <tile gid=\"1\"/>\n"
+                   "   <tile gid=\"1\"/>\n"
+                   "   <tile/>\n"
+                   "   <tile gid=\"0\"></tile>\n"
+                   "   <tile gid=\"2147483651\"/>\n"
+                   "   <tile gid=\"2\"/>\n"
+                   "  </data>\n"
+                   " </layer>\n"
+                   "</map>\n");
+    buffer.open(QIODevice::ReadOnly);
+
+    MapReader reader;
+    QScopedPointer<Map> map(reader.readMap(&buffer));
+    QVERIFY2(map, qPrintable(reader.errorString()));
+    QCOMPARE(map->layerDataFormat(), Map::XML);
+
+    const Tileset *tileset = map->tilesetAt(0).data();
+    const TileLayer *tileLayer = map->layerAt(0)->asTileLayer();
+    QVERIFY(tileLayer);
+
+    QCOMPARE(tileLayer->cellAt(0, 0).tile, tileset->findTile(0));
+    QCOMPARE(tileLayer->cellAt(1, 0).tile, tileset->findTile(0));
+    QVERIFY(tileLayer->cellAt(2, 0).isEmpty());
+    QVERIFY(tileLayer->cellAt(0, 1).isEmpty());
+    QCOMPARE(tileLayer->cellAt(1, 1).tile, tileset->findTile(2));
+    QVERIFY(tileLayer->cellAt(1, 1).flippedHorizontally);
+    QCOMPARE(tileLayer->cellAt(2, 1).tile, tileset->findTile(1));
+}
+
 QTEST_MAIN(test_MapReader)
 #include "test_mapreader.moc"
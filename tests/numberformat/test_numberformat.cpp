@@ -0,0 +1,82 @@
+#include "numberformat.h"
+
+#include <QtTest/QtTest>
+
+#include <limits>
+
+using namespace Tiled;
+
+class test_NumberFormat : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void formatNumber_data();
+    void formatNumber();
+    void roundTrips();
+    void formatInteger();
+};
+
+static QByteArray formatted(double value)
+{
+    char buffer[NumberBufferSize];
+    const int length = Tiled::formatNumber(buffer, value);
+    return QByteArray(buffer, length);
+}
+
+void test_NumberFormat::formatNumber_data()
+{
+    QTest::addColumn<double>("value");
+    QTest::addColumn<QByteArray>("expected");
+
+    QTest::newRow("zero") << 0.0 << QByteArray("0");
+    QTest::newRow("integer") << 32.0 << QByteArray("32");
+    QTest::newRow("negative") << -16.0 << QByteArray("-16");
+    QTest::newRow("million") << 1000000.0 << QByteArray("1000000");
+    QTest::newRow("half") << 0.5 << QByteArray("0.5");
+    QTest::newRow("tenth") << 0.1 << QByteArray("0.1");
+    QTest::newRow("third") << 10.0 / 3 << QByteArray("3.3333333333333335");
+    QTest::newRow("sum") << 0.1 + 0.2 << QByteArray("0.30000000000000004");
+    QTest::newRow("large") << 1e20 << QByteArray("1e+20");
+}
+
+void test_NumberFormat::formatNumber()
+{
+    QFETCH(double, value);
+    QFETCH(QByteArray, expected);
+
+    QCOMPARE(formatted(value), expected);
+}
+
+void test_NumberFormat::roundTrips()
+{
+    qsrand(1);
+
+    for (int i = 0; i < 10000; ++i) {
+        const double value = (qrand() - RAND_MAX / 2) / double(qrand() + 1);
+        QCOMPARE(formatted(value).toDouble(), value);
+    }
+
+    const double max = std::numeric_limits<double>::max();
+    QCOMPARE(formatted(max).toDouble(), max);
+
+    const double min = std::numeric_limits<double>::denorm_min();
+    QCOMPARE(formatted(min).toDouble(), min);
+}
+
+void test_NumberFormat::formatInteger()
+{
+    char buffer[NumberBufferSize];
+
+    int length = Tiled::formatInteger(buffer, 0);
+    QCOMPARE(QByteArray(buffer, length), QByteArray("0"));
+
+    length = Tiled::formatInteger(buffer, 4294967295u);
+    QCOMPARE(QByteArray(buffer, length), QByteArray("4294967295"));
+
+    length = Tiled::formatInteger(buffer, std::numeric_limits<qint64>::min());
+    QCOMPARE(QByteArray(buffer, length), QByteArray("-9223372036854775808"));
+}
+
+QTEST_MAIN(test_NumberFormat)
+#include "test_numberformat.moc"
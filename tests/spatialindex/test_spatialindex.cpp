@@ -0,0 +1,119 @@
+#include "map.h"
+#include "mapobject.h"
+#include "objectgroup.h"
+#include "orthogonalrenderer.h"
+#include "spatialindex.h"
+
+#include <QtTest/QtTest>
+
+#include <algorithm>
+
+using namespace Tiled;
+
+class test_SpatialIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void matchesLinearSearch();
+    void pointRectangles();
+    void objectGroupFollowsChanges();
+};
+
+static bool touches(const QRectF &a, const QRectF &b)
+{
+    return a.left() <= b.right() && b.left() <= a.right() &&
+            a.top() <= b.bottom() && b.top() <= a.bottom();
+}
+
+void test_SpatialIndex::matchesLinearSearch()
+{
+    qsrand(1);
+
+    QVector<MapObject> objects(2000);
+    QHash<MapObject*, QRectF> bounds;
+    SpatialIndex index;
+
+    for (int step = 0; step < 20000; ++step) {
+        MapObject *object = &objects[qrand() % objects.size()];
+
+        if (bounds.contains(object)) {
+            QVERIFY(index.remove(object));
+            bounds.remove(object);
+        }
+
+        if (qrand() % 3 != 0) {
+            const QRectF rect(qrand() % 1000, qrand() % 1000,
+                              qrand() % 30, qrand() % 30);
+            index.insert(object, rect);
+            bounds.insert(object, rect);
+        }
+
+        QCOMPARE(index.size(), bounds.size());
+
+        if (step % 100 == 0) {
+            const QRectF area(qrand() % 1000, qrand() % 1000,
+                              qrand() % 150, qrand() % 150);
+
+            QVector<MapObject*> found = index.intersecting(area);
+            QVector<MapObject*> expected;
+            for (auto it = bounds.constBegin(); it != bounds.constEnd(); ++it)
+                if (touches(it.value(), area))
+                    expected.append(it.key());
+
+            std::sort(found.begin(), found.end());
+            std::sort(expected.begin(), expected.end());
+            QCOMPARE(found, expected);
+        }
+    }
+
+    for (MapObject *object : bounds.keys())
+        QVERIFY(index.remove(object));
+
+    QVERIFY(index.isEmpty());
+    QVERIFY(index.intersecting(QRectF(0, 0, 1000, 1000)).isEmpty());
+}
+
+void test_SpatialIndex::pointRectangles()
+{
+    MapObject object;
+    SpatialIndex index;
+    index.insert(&object, QRectF(10, 10, 0, 0));
+
+    QCOMPARE(index.intersecting(QRectF(10, 10, 0, 0)).size(), 1);
+    QCOMPARE(index.intersecting(QRectF(0, 0, 10, 10)).size(), 1);
+    QCOMPARE(index.intersecting(QRectF(11, 11, 5, 5)).size(), 0);
+}
+
+void test_SpatialIndex::objectGroupFollowsChanges()
+{
+    Map map(Map::Orthogonal, 100, 100, 32, 32);
+    OrthogonalRenderer renderer(&map);
+
+    ObjectGroup *objectGroup = new ObjectGroup(QLatin1String("objects"), 0, 0, 100, 100);
+    map.addLayer(objectGroup);
+
+    MapObject *object = new MapObject(QString(), QString(),
+                                      QPointF(100, 100), QSizeF(20, 20));
+    objectGroup->addObject(object);
+
+    QCOMPARE(renderer.objectsAt(objectGroup, QPointF(110, 110)).size(), 1);
+
+    object->setPosition(QPointF(500, 500));
+    QCOMPARE(renderer.objectsAt(objectGroup, QPointF(110, 110)).size(), 0);
+    QCOMPARE(renderer.objectsAt(objectGroup, QPointF(510, 510)).size(), 1);
+
+    object->setSize(QSizeF(200, 200));
+    QCOMPARE(renderer.objectsIntersecting(objectGroup, QRectF(650, 650, 10, 10)).size(), 1);
+
+    object->setVisible(false);
+    QCOMPARE(renderer.objectsAt(objectGroup, QPointF(510, 510)).size(), 0);
+    object->setVisible(true);
+
+    objectGroup->removeObject(object);
+    QCOMPARE(renderer.objectsAt(objectGroup, QPointF(510, 510)).size(), 0);
+    delete object;
+}
+
+QTEST_MAIN(test_SpatialIndex)
+#include "test_spatialindex.moc"
@@ -1,4 +1,10 @@
 TEMPLATE=subdirs
 SUBDIRS = \
+    jsonpullreader \
+    jsonstreamwriter \
+    mapobject \
     mapreader \
-    staggeredrenderer
+    numberformat \
+    spatialindex \
+    staggeredrenderer \
+    tilelayer
@@ -0,0 +1,169 @@
+#include "tile.h"
+#include "tilelayer.h"
+#include "tileset.h"
+
+#include <QtTest/QtTest>
+
+using namespace Tiled;
+
+class test_TileLayer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void regionMatchesUnitedRects();
+    void regionOfEmptyLayer();
+
+    void regionBenchmark_data();
+    void regionBenchmark();
+
+    void conditionRegionBenchmark_data();
+    void conditionRegionBenchmark();
+
+private:
+    void fillPattern(TileLayer &layer) const;
+
+    SharedTileset mTileset;
+};
+
+void test_TileLayer::initTestCase()
+{
+    mTileset = Tileset::create(QLatin1String("tiles"), 32, 32);
+    mTileset->addTiles(QList<Tile*>()
+                       << new Tile(0, mTileset.data())
+                       << new Tile(1, mTileset.data()));
+}
+
+void test_TileLayer::cleanupTestCase()
+{
+    mTileset.clear();
+}
+
+/**
+ * Fills the layer with a mix of open areas, small islands and empty space,
+ * so that the resulting regions have many bands of varying complexity.
+ */
+void test_TileLayer::fillPattern(TileLayer &layer) const
+{
+    const Cell first(mTileset->findTile(0));
+    const Cell second(mTileset->findTile(1));
+
+    for (int y = 0; y < layer.height(); ++y) {
+        for (int x = 0; x < layer.width(); ++x) {
+            if ((x / 16 + y / 16) % 3 == 0)
+                continue;   // leave empty
+            if ((x * 7 + y * 13) % 11 == 0)
+                layer.setCell(x, y, second);
+            else
+                layer.setCell(x, y, first);
+        }
+    }
+}
+
+void test_TileLayer::regionMatchesUnitedRects()
+{
+    TileLayer layer(QString(), 3, 5, 97, 61);
+    fillPattern(layer);
+
+    const Cell matchCell(mTileset->findTile(1));
+
+    QRegion expected;
+    QRegion expectedNonEmpty;
+    for (int y = 0; y < layer.height(); ++y) {
+        for (int x = 0; x < layer.width(); ++x) {
+            const Cell &cell = layer.cellAt(x, y);
+            if (cell == matchCell)
+                expected += QRect(x + layer.x(), y + layer.y(), 1, 1);
+            if (!cell.isEmpty())
+                expectedNonEmpty += QRect(x + layer.x(), y + layer.y(), 1, 1);
+        }
+    }
+
+    std::function<bool (const Cell &)> condition = [&] (const Cell &cell) {
+        return cell == matchCell;
+    };
+
+    QCOMPARE(layer.region(condition), expected);
+    QCOMPARE(layer.region([&] (const Cell &cell) { return cell == matchCell; }),
+             expected);
+    QCOMPARE(layer.region(), expectedNonEmpty);
+}
+
+void test_TileLayer::regionOfEmptyLayer()
+{
+    TileLayer layer(QString(), 0, 0, 64, 64);
+    QVERIFY(layer.region().isEmpty());
+    QVERIFY(layer.isEmpty());
+
+    layer.setCell(10, 10, Cell(mTileset->findTile(0)));
+    QCOMPARE(layer.region(), QRegion(10, 10, 1, 1));
+
+    layer.setCell(10, 10, Cell());
+    QVERIFY(layer.region().isEmpty());
+    QVERIFY(layer.isEmpty());
+}
+
+static void addSizes()
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("1k") << 1024;
+    QTest::newRow("4k") << 4096;
+    QTest::newRow("16k") << 16384;
+}
+
+// A 16k x 16k layer needs several gigabytes, so it is opt-in
+static bool skipSize(int size)
+{
+    return size > 4096 && qEnvironmentVariableIsEmpty("TILED_LARGE_BENCHMARKS");
+}
+
+void test_TileLayer::regionBenchmark_data()
+{
+    addSizes();
+}
+
+void test_TileLayer::regionBenchmark()
+{
+    QFETCH(int, size);
+    if (skipSize(size))
+        QSKIP("Set TILED_LARGE_BENCHMARKS to run this benchmark");
+
+    TileLayer layer(QString(), 0, 0, size, size);
+    fillPattern(layer);
+
+    QRegion region;
+    QBENCHMARK {
+        region = layer.region();
+    }
+    QVERIFY(!region.isEmpty());
+}
+
+void test_TileLayer::conditionRegionBenchmark_data()
+{
+    addSizes();
+}
+
+void test_TileLayer::conditionRegionBenchmark()
+{
+    QFETCH(int, size);
+    if (skipSize(size))
+        QSKIP("Set TILED_LARGE_BENCHMARKS to run this benchmark");
+
+    TileLayer layer(QString(), 0, 0, size, size);
+    fillPattern(layer);
+
+    const Cell matchCell(mTileset->findTile(1));
+
+    QRegion region;
+    QBENCHMARK {
+        region = layer.region([&] (const Cell &cell) { return cell == matchCell; });
+    }
+    QVERIFY(!region.isEmpty());
+}
+
+QTEST_MAIN(test_TileLayer)
+#include "test_tilelayer.moc"